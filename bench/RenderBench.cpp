@@ -0,0 +1,501 @@
+// CPU microbenchmarks for the rendering hot paths.
+//
+// Every benchmark is parameterized by object/cell count (1 .. 1M). Results are
+// written as JSON to stdout by default so runs can be archived and compared
+// between releases; pass --benchmark_format=console for a human-readable table.
+//
+// GPU-backed cases run on a headless device (lavapipe on CI) and are skipped
+// when no Vulkan device is available. Shaders are embedded, so the benchmarks
+// run from any directory.
+
+#include <benchmark/benchmark.h>
+
+#include "VulkanInstance.h"
+#include "VulkanDevice.h"
+#include "VulkanGraphicsPipeline.h"
+#include "VulkanFrameRing.h"
+#include "VulkanBindless.h"
+#include "VulkanParticleSystem.h"
+#include "VulkanShader.h"
+#include "src/DrawSortKey.h"
+#include "src/GameObject.h"
+#include "src/HudOverlay.h"
+#include "src/Material.h"
+#include "src/Mesh.h"
+#include "src/MeshSimplifier.h"
+#include "src/Primitive.h"
+#include "src/RenderQueue.h"
+#include "src/RenderSettings.h"
+#include "src/ViewVisibility.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int64_t kMinCount = 1;
+    constexpr int64_t kMaxCount = 1000000;
+
+    // Everything a real frame needs to record draws, minus the swapchain
+    struct GpuContext
+    {
+        std::unique_ptr<VulkanInstance> instance;
+        std::unique_ptr<VulkanDevice> device;
+        RenderTargetFormats targets;
+        std::unique_ptr<VulkanFrameRing> frameRing;
+        std::unique_ptr<VulkanBindless> bindless;
+        std::vector<std::unique_ptr<Material>> materials;
+        std::vector<std::unique_ptr<Mesh>> meshes;
+
+        vk::CommandPool commandPool;
+        vk::CommandBuffer commandBuffer;
+
+        GpuContext()
+        {
+            instance = std::make_unique<VulkanInstance>(false, true);
+            device = std::make_unique<VulkanDevice>(instance->get(), vk::SurfaceKHR(),
+                                                    RenderSettings::fromEnvironment().device);
+            targets.color = vk::Format::eB8G8R8A8Srgb;
+            targets.depth = device->findDepthFormat();
+            frameRing = std::make_unique<VulkanFrameRing>(*device, 1, 128 * 1024 * 1024);
+            bindless = std::make_unique<VulkanBindless>(*device);
+
+            std::vector<vk::DescriptorSetLayout> setLayouts = {frameRing->getSetLayout(), bindless->getSetLayout()};
+
+            // Two pipeline permutations, each shared by several material instances
+            const PipelineDesc descs[] = {PipelineDescs::kTextured, PipelineDescs::kVertexColor};
+            for (int p = 0; p < 2; ++p)
+            {
+                auto shader = std::make_unique<VulkanShader>(*device, "shaders/cube.vert.spv", "shaders/cube.frag.spv");
+                materials.push_back(std::make_unique<Material>(*device, targets, descs[p], std::move(shader), setLayouts,
+                                                               bindless->registerMaterial(MaterialParams())));
+                for (int i = 0; i < 3; ++i)
+                    materials.push_back(materials[p * 4]->createInstance(bindless->registerMaterial(MaterialParams())));
+            }
+
+            meshes.push_back(std::make_unique<Mesh>(*device, Primitives::createCube()));
+            meshes.push_back(std::make_unique<Mesh>(*device, MeshSimplifier::buildLodChain(Primitives::createSphere(48))));
+
+            auto dev = device->getLogicalDevice();
+            commandPool = dev.createCommandPool(vk::CommandPoolCreateInfo({}, device->getGraphicsQueueFamily()));
+            commandBuffer = dev.allocateCommandBuffers(
+                vk::CommandBufferAllocateInfo(commandPool, vk::CommandBufferLevel::eSecondary, 1))[0];
+        }
+
+        ~GpuContext()
+        {
+            auto dev = device->getLogicalDevice();
+            dev.waitIdle();
+            dev.destroyCommandPool(commandPool);
+
+            materials.clear();
+            meshes.clear();
+            bindless.reset();
+            frameRing.reset();
+            device.reset();
+            instance.reset();
+        }
+    };
+
+    std::unique_ptr<GpuContext> gpuContext;
+    std::string gpuError;
+
+    GpuContext *gpu()
+    {
+        if (!gpuContext && gpuError.empty())
+        {
+            try
+            {
+                gpuContext = std::make_unique<GpuContext>();
+            }
+            catch (const std::exception &e)
+            {
+                gpuError = std::string("no usable Vulkan device: ") + e.what();
+            }
+        }
+        return gpuContext.get();
+    }
+
+    // Deterministic scene: objects scattered in a box in front of the camera
+    struct Scene
+    {
+        std::vector<GameObject> objects;
+        std::vector<GameObject *> pointers;
+        CameraData camera;
+
+        Scene(size_t count, const std::vector<std::unique_ptr<Mesh>> &meshes,
+              const std::vector<std::unique_ptr<Material>> &materials)
+        {
+            std::mt19937 rng(1234);
+            std::uniform_real_distribution<float> pos(-50.0f, 50.0f);
+            std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+
+            objects.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                Transform t;
+                t.position = glm::vec3(pos(rng), pos(rng), pos(rng));
+                t.rotation = glm::vec3(angle(rng), angle(rng), angle(rng));
+                Mesh *mesh = meshes.empty() ? nullptr : meshes[i % meshes.size()].get();
+                Material *material = materials.empty() ? nullptr : materials[(i / 7) % materials.size()].get();
+                objects.emplace_back(mesh, material, t);
+            }
+            for (auto &obj : objects)
+                pointers.push_back(&obj);
+
+            camera.view = glm::lookAt(glm::vec3(0.0f, 0.0f, 120.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            camera.proj = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+            camera.proj[1][1] *= -1;
+            camera.viewProj = camera.proj * camera.view;
+        }
+    };
+
+    void BM_TransformGetMatrix(benchmark::State &state)
+    {
+        Scene scene(static_cast<size_t>(state.range(0)), {}, {});
+        std::vector<glm::mat4> out(scene.objects.size());
+
+        for (auto _ : state)
+        {
+            for (size_t i = 0; i < scene.objects.size(); ++i)
+                out[i] = scene.objects[i].transform.getMatrix();
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_RenderQueueBuild(benchmark::State &state)
+    {
+        GpuContext *ctx = gpu();
+        if (!ctx)
+        {
+            state.SkipWithError(gpuError.c_str());
+            return;
+        }
+
+        Scene scene(static_cast<size_t>(state.range(0)), ctx->meshes, ctx->materials);
+        std::vector<DrawData> drawData(scene.objects.size());
+        RenderQueue queue;
+        queue.setSortingEnabled(state.range(1) != 0);
+
+        for (auto _ : state)
+        {
+            queue.build(scene.pointers, scene.camera);
+            queue.writeDrawData(drawData.data());
+            benchmark::DoNotOptimize(drawData.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // CPU side of a multi-view frame: the shared visibility pass, a queue per view and the
+    // shared draw data. Views orbit the scene, so they overlap partially.
+    void BM_MultiViewPrepare(benchmark::State &state)
+    {
+        GpuContext *ctx = gpu();
+        if (!ctx)
+        {
+            state.SkipWithError(gpuError.c_str());
+            return;
+        }
+
+        Scene scene(static_cast<size_t>(state.range(0)), ctx->meshes, ctx->materials);
+        const size_t viewCount = static_cast<size_t>(state.range(1));
+        std::vector<CameraData> cameras(viewCount, scene.camera);
+        std::vector<glm::mat4> viewProjs;
+        for (size_t v = 0; v < viewCount; ++v)
+        {
+            const float angle = glm::radians(90.0f * static_cast<float>(v));
+            const glm::vec3 eye(120.0f * std::sin(angle), 0.0f, 120.0f * std::cos(angle));
+            cameras[v].view = glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            cameras[v].viewProj = cameras[v].proj * cameras[v].view;
+            viewProjs.push_back(cameras[v].viewProj);
+        }
+
+        ViewVisibility visibility;
+        std::vector<RenderQueue> queues(viewCount);
+        for (size_t v = 0; v < viewCount; ++v)
+        {
+            queues[v].setIndexByObject(true);
+            queues[v].setLodOwner(v == 0);
+        }
+        std::vector<DrawData> drawData(scene.objects.size());
+
+        for (auto _ : state)
+        {
+            visibility.update(scene.pointers, viewProjs);
+            for (size_t v = 0; v < viewCount; ++v)
+                queues[v].build(scene.pointers, cameras[v], &visibility.getVisibleObjects(v));
+            visibility.writeDrawData(scene.pointers, drawData.data());
+            benchmark::DoNotOptimize(drawData.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // What prepareObjects() is left with when nothing moved: copying last frame's draw data
+    // into this frame's ring space. Compare with BM_MultiViewPrepare for a rebuild.
+    void BM_StaticFramePrepare(benchmark::State &state)
+    {
+        Scene scene(static_cast<size_t>(state.range(0)), {}, {});
+        std::vector<DrawData> prepared(scene.objects.size());
+        for (size_t i = 0; i < scene.objects.size(); ++i)
+            prepared[i].model = scene.objects[i].transform.getMatrix();
+        std::vector<DrawData> ring(prepared.size());
+
+        for (auto _ : state)
+        {
+            std::memcpy(ring.data(), prepared.data(), sizeof(DrawData) * prepared.size());
+            benchmark::DoNotOptimize(ring.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(DrawData)));
+    }
+
+    void BM_RecordCommands(benchmark::State &state)
+    {
+        GpuContext *ctx = gpu();
+        if (!ctx)
+        {
+            state.SkipWithError(gpuError.c_str());
+            return;
+        }
+
+        Scene scene(static_cast<size_t>(state.range(0)), ctx->meshes, ctx->materials);
+        RenderQueue queue;
+        queue.setSortingEnabled(state.range(1) != 0);
+        queue.build(scene.pointers, scene.camera);
+
+        std::array<vk::DescriptorSet, 2> sets = {ctx->frameRing->getDescriptorSet(), ctx->bindless->getDescriptorSet()};
+        uint32_t dynamicOffsets[] = {0, 0};
+
+        // Secondary buffer continuing the scene's dynamic rendering; no images required
+        vk::CommandBufferInheritanceRenderingInfo renderingInheritance({}, 0, 1, &ctx->targets.color,
+                                                                       ctx->targets.depth, vk::Format::eUndefined,
+                                                                       ctx->targets.samples);
+        vk::CommandBufferInheritanceInfo inheritance;
+        inheritance.pNext = &renderingInheritance;
+        vk::CommandBufferBeginInfo beginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit |
+                                                 vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+                                             &inheritance);
+        auto dev = ctx->device->getLogicalDevice();
+
+        for (auto _ : state)
+        {
+            dev.resetCommandPool(ctx->commandPool);
+            ctx->commandBuffer.begin(beginInfo);
+            queue.record(ctx->commandBuffer, static_cast<uint32_t>(sets.size()), sets.data(), 2, dynamicOffsets);
+            ctx->commandBuffer.end();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        const FrameStats &stats = queue.getStats();
+        state.counters["draws"] = static_cast<double>(stats.drawCalls);
+        state.counters["pipeline_binds"] = static_cast<double>(stats.pipelineBinds);
+        state.counters["material_changes"] = static_cast<double>(stats.materialChanges);
+        state.counters["mesh_binds"] = static_cast<double>(stats.meshBinds);
+    }
+
+    // One frame of particle emission, simulation and compaction, submitted and waited on.
+    // Emission matches the average lifetime, so the system runs close to full capacity.
+    void BM_ParticleSimulate(benchmark::State &state)
+    {
+        GpuContext *ctx = gpu();
+        if (!ctx)
+        {
+            state.SkipWithError(gpuError.c_str());
+            return;
+        }
+
+        std::unique_ptr<VulkanParticleSystem> particles;
+        try
+        {
+            particles = std::make_unique<VulkanParticleSystem>(*ctx->device, *ctx->frameRing, ctx->targets,
+                                                               static_cast<uint32_t>(state.range(0)));
+        }
+        catch (const std::exception &e)
+        {
+            state.SkipWithError(e.what());
+            return;
+        }
+
+        ParticleEmitter emitter;
+        emitter.positionRate.w = static_cast<float>(particles->getCapacity()) / emitter.lifetime;
+        particles->addEmitter(emitter);
+
+        auto dev = ctx->device->getLogicalDevice();
+        vk::CommandPool pool = dev.createCommandPool(vk::CommandPoolCreateInfo({}, ctx->device->getGraphicsQueueFamily()));
+        vk::CommandBuffer cmd =
+            dev.allocateCommandBuffers(vk::CommandBufferAllocateInfo(pool, vk::CommandBufferLevel::ePrimary, 1))[0];
+        vk::Queue queue = ctx->device->getGraphicsQueue();
+
+        auto runFrame = [&]()
+        {
+            ctx->frameRing->beginFrame(0);
+            particles->prepare(1.0f / 60.0f);
+            dev.resetCommandPool(pool);
+            cmd.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+            particles->simulate(cmd);
+            cmd.end();
+            queue.submit(vk::SubmitInfo(0, nullptr, nullptr, 1, &cmd), {});
+            queue.waitIdle();
+        };
+
+        // Fill up to steady state (one average lifetime) before measuring
+        for (int frame = 0; frame < 120; ++frame)
+            runFrame();
+
+        for (auto _ : state)
+            runFrame();
+        state.SetItemsProcessed(state.iterations() * particles->getCapacity());
+
+        particles.reset();
+        dev.destroyCommandPool(pool);
+    }
+
+    void BM_RadixSortKeys(benchmark::State &state)
+    {
+        std::mt19937_64 rng(1234);
+        std::vector<DrawSortKey::Entry> keys(static_cast<size_t>(state.range(0)));
+        for (size_t i = 0; i < keys.size(); ++i)
+            keys[i] = {rng(), static_cast<uint32_t>(i)};
+
+        std::vector<DrawSortKey::Entry> entries;
+        std::vector<DrawSortKey::Entry> scratch;
+        for (auto _ : state)
+        {
+            entries = keys;
+            DrawSortKey::radixSort(entries, scratch);
+            benchmark::DoNotOptimize(entries.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // The overlay's whole per-frame CPU cost: panel layout plus the copy into the vertex
+    // buffer (plain memory here, the frame ring in the renderer). Budget: under 0.1 ms.
+    void BM_HudBuild(benchmark::State &state)
+    {
+        HudOverlay overlay;
+        HudStats stats;
+        stats.objects = 100000;
+        stats.drawCalls = 4321;
+        stats.frustumCulled = 95679;
+        stats.pipelineBinds = 3;
+        stats.materialChanges = 40;
+        stats.memoryUsed = 512ull << 20;
+        stats.memoryBudget = 4096ull << 20;
+
+        std::vector<HudQuad> vertexBuffer(1024);
+        float frameMs = 16.0f;
+        for (auto _ : state)
+        {
+            frameMs = frameMs > 30.0f ? 12.0f : frameMs + 0.7f;
+            overlay.addFrameTime(frameMs);
+            overlay.build(stats);
+            const std::vector<HudQuad> &quads = overlay.getQuads();
+            std::memcpy(vertexBuffer.data(), quads.data(),
+                        sizeof(HudQuad) * std::min(quads.size(), vertexBuffer.size()));
+            benchmark::DoNotOptimize(vertexBuffer.data());
+        }
+        state.counters["quads"] = static_cast<double>(overlay.getQuads().size());
+    }
+
+    // Generators are sized so the number of cells is close to the benchmark argument
+    template <typename CountFn, typename GenerateFn>
+    void runGenerator(benchmark::State &state, uint32_t a, uint32_t b, CountFn count, GenerateFn generate)
+    {
+        std::vector<Vertex> out(count(a, b));
+        for (auto _ : state)
+        {
+            generate(VertexSpan{out.data(), out.size()}, a, b);
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(out.size()));
+        state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(out.size() * sizeof(Vertex)));
+    }
+
+    void BM_GenerateSphere(benchmark::State &state)
+    {
+        uint32_t segments = std::max<uint32_t>(3, static_cast<uint32_t>(std::sqrt(2.0 * state.range(0))));
+        uint32_t rings = std::max<uint32_t>(2, static_cast<uint32_t>(state.range(0) / segments));
+        runGenerator(state, segments, rings, Primitives::sphereVertexCount,
+                     [](VertexSpan out, uint32_t s, uint32_t r)
+                     { Primitives::generateSphere(out, s, r); });
+    }
+
+    void BM_GenerateGrid(benchmark::State &state)
+    {
+        uint32_t cellsX = std::max<uint32_t>(1, static_cast<uint32_t>(std::sqrt(static_cast<double>(state.range(0)))));
+        uint32_t cellsZ = std::max<uint32_t>(1, static_cast<uint32_t>(state.range(0) / cellsX));
+        runGenerator(state, cellsX, cellsZ, Primitives::gridVertexCount,
+                     [](VertexSpan out, uint32_t x, uint32_t z)
+                     { Primitives::generateGrid(out, x, z); });
+    }
+
+    void BM_GenerateCylinder(benchmark::State &state)
+    {
+        uint32_t segments = std::max<uint32_t>(3, static_cast<uint32_t>(std::sqrt(static_cast<double>(state.range(0)))));
+        uint32_t stacks = std::max<uint32_t>(1, static_cast<uint32_t>(state.range(0) / segments));
+        runGenerator(state, segments, stacks, Primitives::cylinderVertexCount,
+                     [](VertexSpan out, uint32_t s, uint32_t st)
+                     { Primitives::generateCylinder(out, s, st); });
+    }
+
+    void BM_GenerateTorus(benchmark::State &state)
+    {
+        uint32_t major = std::max<uint32_t>(3, static_cast<uint32_t>(std::sqrt(static_cast<double>(state.range(0)))));
+        uint32_t minor = std::max<uint32_t>(3, static_cast<uint32_t>(state.range(0) / major));
+        runGenerator(state, major, minor, Primitives::torusVertexCount,
+                     [](VertexSpan out, uint32_t ma, uint32_t mi)
+                     { Primitives::generateTorus(out, ma, mi); });
+    }
+}
+
+BENCHMARK(BM_TransformGetMatrix)->RangeMultiplier(10)->Range(kMinCount, kMaxCount);
+// Second argument: draw sorting off (0) / on (1)
+BENCHMARK(BM_RenderQueueBuild)->ArgsProduct({benchmark::CreateRange(kMinCount, kMaxCount, 10), {0, 1}});
+// Second argument: view count
+BENCHMARK(BM_MultiViewPrepare)->ArgsProduct({benchmark::CreateRange(kMinCount, kMaxCount, 10), {1, 2, 4}});
+BENCHMARK(BM_StaticFramePrepare)->RangeMultiplier(10)->Range(kMinCount, kMaxCount);
+BENCHMARK(BM_RecordCommands)->ArgsProduct({benchmark::CreateRange(kMinCount, kMaxCount, 10), {0, 1}});
+// Particle capacity, up to 4M
+BENCHMARK(BM_ParticleSimulate)->RangeMultiplier(4)->Range(1 << 10, 1 << 22)->UseRealTime();
+BENCHMARK(BM_HudBuild);
+BENCHMARK(BM_RadixSortKeys)->RangeMultiplier(10)->Range(kMinCount, kMaxCount);
+BENCHMARK(BM_GenerateSphere)->RangeMultiplier(10)->Range(kMinCount, kMaxCount);
+BENCHMARK(BM_GenerateGrid)->RangeMultiplier(10)->Range(kMinCount, kMaxCount);
+BENCHMARK(BM_GenerateCylinder)->RangeMultiplier(10)->Range(kMinCount, kMaxCount);
+BENCHMARK(BM_GenerateTorus)->RangeMultiplier(10)->Range(kMinCount, kMaxCount);
+
+int main(int argc, char **argv)
+{
+    // Emit JSON unless the caller picked a format explicitly
+    std::vector<char *> args(argv, argv + argc);
+    bool hasFormat = std::any_of(args.begin(), args.end(), [](const char *arg)
+                                 { return std::strncmp(arg, "--benchmark_format", 18) == 0; });
+    static char jsonFormat[] = "--benchmark_format=json";
+    if (!hasFormat)
+        args.push_back(jsonFormat);
+
+    int count = static_cast<int>(args.size());
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data()))
+        return 1;
+
+    if (GpuContext *ctx = gpu())
+        benchmark::AddCustomContext("vulkan_device", ctx->device->getPhysicalDevice().getProperties().deviceName.data());
+    else
+        benchmark::AddCustomContext("vulkan_device", "none");
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    gpuContext.reset();
+    return 0;
+}
@@ -0,0 +1,35 @@
+# Writes a compiled SPIR-V module as a C++ header (run by add_spv_shader in script mode).
+#
+#   cmake -DINPUT=<file.spv> -DOUTPUT=<file.spv.h> -DSYMBOL=<identifier> -P EmbedSpirv.cmake
+#
+# The header defines EmbeddedShaders::<SYMBOL>, the module's words in host (little-endian) order.
+
+file(READ "${INPUT}" hex HEX)
+string(LENGTH "${hex}" hexLength)
+math(EXPR remainder "${hexLength} % 8")
+if(hexLength EQUAL 0 OR NOT remainder EQUAL 0)
+    message(FATAL_ERROR "${INPUT} is not a SPIR-V module (size is not a multiple of 4 bytes)")
+endif()
+
+# Byte-swap each group of four bytes into a word, eight words per line
+string(REGEX REPLACE "([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])"
+       "0x\\4\\3\\2\\1, " words "${hex}")
+# (CMake regexes have no {n} repetition)
+string(REPEAT "0x[0-9a-f]+, " 8 line)
+string(REGEX REPLACE "(${line})" "\\1\n        " words "${words}")
+string(REPLACE " \n" "\n" words "${words}")
+string(REGEX REPLACE "[ \n]+$" "" words "${words}")
+
+get_filename_component(inputName "${INPUT}" NAME)
+file(WRITE "${OUTPUT}"
+"// Generated from ${inputName} by add_spv_shader; do not edit
+#pragma once
+#include <cstdint>
+
+namespace EmbeddedShaders
+{
+    alignas(4) inline constexpr uint32_t ${SYMBOL}[] = {
+        ${words}
+    };
+}
+")
@@ -1,7 +1,36 @@
 #version 460
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Permutation flag (PipelineDesc::features); resolved when the pipeline is built
+layout(constant_id = 1) const bool TEXTURED = true;
+
+struct MaterialParams {
+    vec4 baseColor;
+    uint textureIndex;
+    uint pad0;
+    uint pad1;
+    uint pad2;
+};
+
+layout(set = 1, binding = 0) uniform sampler materialSampler;
+layout(std430, set = 1, binding = 1) readonly buffer MaterialBuffer {
+    MaterialParams materials[];
+} materialBuffer;
+layout(set = 1, binding = 2) uniform texture2D textures[];
+
+layout(push_constant) uniform PushConstants {
+    uint drawIndex;
+    uint materialId;
+} pc;
+
 layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragUV;
 layout(location = 0) out vec4 outColor;
 
 void main() {
-    outColor = vec4(fragColor, 1.0);
+    MaterialParams material = materialBuffer.materials[pc.materialId];
+    vec4 color = vec4(fragColor, 1.0) * material.baseColor;
+    if (TEXTURED)
+        color *= texture(sampler2D(textures[nonuniformEXT(material.textureIndex)], materialSampler), fragUV);
+    outColor = color;
 }
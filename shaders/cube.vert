@@ -1,14 +1,39 @@
 #version 460
 
+// Permutation flags (PipelineDesc::features); resolved when the pipeline is built
+layout(constant_id = 0) const bool VERTEX_COLOR = true;
+layout(constant_id = 2) const bool INSTANCED = false;
+layout(constant_id = 3) const bool QUANTIZED_POSITIONS = false;
+layout(constant_id = 4) const float POSITION_SCALE = 1.0;
+
+layout(set = 0, binding = 0) uniform CameraData {
+    mat4 view;
+    mat4 proj;
+    mat4 viewProj;
+} camera;
+
+struct DrawData {
+    mat4 model;
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer DrawBuffer {
+    DrawData draws[];
+} drawBuffer;
+
 layout(push_constant) uniform PushConstants {
-    mat4 mvp;
+    uint drawIndex;
+    uint materialId;
 } pc;
 
-layout(location = 0) in vec3 inPos;
+layout(location = 0) in vec3 inPos; // snorm16 when QUANTIZED_POSITIONS
 layout(location = 1) in vec3 inColor;
 layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragUV;
 
 void main() {
-    gl_Position = pc.mvp * vec4(inPos, 1.0);
-    fragColor = inColor;
+    vec3 pos = QUANTIZED_POSITIONS ? inPos * POSITION_SCALE : inPos;
+    uint drawIndex = INSTANCED ? pc.drawIndex + uint(gl_InstanceIndex) : pc.drawIndex;
+    gl_Position = camera.viewProj * drawBuffer.draws[drawIndex].model * vec4(pos, 1.0);
+    fragColor = VERTEX_COLOR ? inColor : vec3(1.0);
+    fragUV = pos.xy + 0.5; // Planar mapping until meshes carry UVs
 }
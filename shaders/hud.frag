@@ -0,0 +1,32 @@
+#version 460
+#extension GL_EXT_nonuniform_qualifier : require
+
+struct MaterialParams {
+    vec4 baseColor;
+    uint textureIndex;
+    uint pad0;
+    uint pad1;
+    uint pad2;
+};
+
+layout(set = 1, binding = 0) uniform sampler materialSampler;
+layout(std430, set = 1, binding = 1) readonly buffer MaterialBuffer {
+    MaterialParams materials[];
+} materialBuffer;
+layout(set = 1, binding = 2) uniform texture2D textures[];
+
+layout(push_constant) uniform PushConstants {
+    uint drawIndex;  // Unused
+    uint materialId; // Its texture is the font atlas
+} pc;
+
+layout(location = 0) in vec2 fragTexel;
+layout(location = 1) in vec4 fragColor;
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    // Glyphs are drawn at integer scales, so fetch texels exactly instead of filtering
+    uint atlas = materialBuffer.materials[pc.materialId].textureIndex;
+    float coverage = texelFetch(sampler2D(textures[atlas], materialSampler), ivec2(fragTexel), 0).a;
+    outColor = vec4(fragColor.rgb, fragColor.a * coverage);
+}
@@ -0,0 +1,26 @@
+#version 460
+
+// Performance overlay: one screen-space quad per instance (HudQuad in src/HudOverlay.h),
+// expanded to two triangles here. The camera's projection maps pixels to clip space.
+layout(set = 0, binding = 0) uniform CameraData {
+    mat4 view;
+    mat4 proj;
+    mat4 viewProj;
+} camera;
+
+layout(location = 0) in vec4 inRect;    // x0, y0, x1, y1 in pixels
+layout(location = 1) in uvec4 inTexels; // Atlas rectangle in texels
+layout(location = 2) in vec4 inColor;
+
+layout(location = 0) out vec2 fragTexel;
+layout(location = 1) out vec4 fragColor;
+
+const vec2 kCorners[6] = vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0),
+                                vec2(0.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0));
+
+void main() {
+    vec2 corner = kCorners[gl_VertexIndex];
+    gl_Position = camera.proj * vec4(mix(inRect.xy, inRect.zw, corner), 0.0, 1.0);
+    fragTexel = mix(vec2(inTexels.xy), vec2(inTexels.zw), corner);
+    fragColor = inColor;
+}
@@ -0,0 +1,45 @@
+#version 460
+
+// Camera-facing quad per alive particle. The instance index walks the alive list the
+// simulate stage wrote this frame; the indirect draw's instance count is its length.
+layout(set = 0, binding = 0) uniform CameraData {
+    mat4 view;
+    mat4 proj;
+    mat4 viewProj;
+} camera;
+
+struct Particle
+{
+    vec4 positionLife;
+    vec4 velocityLifetime;
+    vec4 color;
+    vec4 size;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer ParticleBuffer { Particle particles[]; };
+layout(std430, set = 1, binding = 1) readonly buffer AliveBuffer { uint alive[]; };
+
+layout(push_constant) uniform PushConstants {
+    uint drawIndex;  // Start of this frame's output alive list
+    uint materialId; // Unused
+} pc;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragCorner;
+
+const vec2 kCorners[6] = vec2[](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),
+                                vec2(-1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0));
+
+void main() {
+    Particle p = particles[alive[pc.drawIndex + uint(gl_InstanceIndex)]];
+    vec2 corner = kCorners[gl_VertexIndex];
+
+    // Camera right and up are the first two rows of the view matrix
+    vec3 right = vec3(camera.view[0][0], camera.view[1][0], camera.view[2][0]);
+    vec3 up = vec3(camera.view[0][1], camera.view[1][1], camera.view[2][1]);
+    vec3 position = p.positionLife.xyz + (right * corner.x + up * corner.y) * (0.5 * p.size.x);
+
+    gl_Position = camera.viewProj * vec4(position, 1.0);
+    fragColor = vec4(p.color.rgb, p.color.a * clamp(p.positionLife.w / p.velocityLifetime.w, 0.0, 1.0));
+    fragCorner = corner;
+}
@@ -0,0 +1,61 @@
+#include "DrawSortKey.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace DrawSortKey
+{
+    uint32_t quantizeDepth(float viewDepth, float maxDepth)
+    {
+        float d = std::max(viewDepth, 0.0f);
+        float t = std::log2(1.0f + d) / std::log2(1.0f + maxDepth);
+        t = std::min(std::max(t, 0.0f), 1.0f);
+        return static_cast<uint32_t>(t * static_cast<float>(mask(kDepthBits)));
+    }
+
+    void radixSort(std::vector<Entry> &entries, std::vector<Entry> &scratch)
+    {
+        const size_t count = entries.size();
+        if (count < 2)
+            return;
+
+        // All eight histograms in a single read of the keys
+        std::array<std::array<uint32_t, 256>, 8> histograms{};
+        for (const Entry &e : entries)
+        {
+            for (int pass = 0; pass < 8; ++pass)
+                ++histograms[pass][(e.key >> (pass * 8)) & 0xFF];
+        }
+
+        scratch.resize(count);
+        Entry *src = entries.data();
+        Entry *dst = scratch.data();
+
+        for (int pass = 0; pass < 8; ++pass)
+        {
+            auto &histogram = histograms[pass];
+            const int shift = pass * 8;
+
+            // Every key has the same digit: this pass would not move anything
+            if (histogram[(src[0].key >> shift) & 0xFF] == count)
+                continue;
+
+            uint32_t offsets[256];
+            uint32_t sum = 0;
+            for (int digit = 0; digit < 256; ++digit)
+            {
+                offsets[digit] = sum;
+                sum += histogram[digit];
+            }
+
+            for (size_t i = 0; i < count; ++i)
+                dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+
+            std::swap(src, dst);
+        }
+
+        if (src != entries.data())
+            std::copy(src, src + count, entries.data());
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// 64-bit draw sort key, most significant field first:
+//
+//   | layer 4 | pipeline 12 | material 16 | mesh 12 | depth 20 |
+//
+// Sorting ascending groups draws by layer, then state (pipeline > material > mesh),
+// and orders draws that share all state front to back for early-Z rejection.
+namespace DrawSortKey
+{
+    constexpr uint32_t kDepthBits = 20;
+    constexpr uint32_t kMeshBits = 12;
+    constexpr uint32_t kMaterialBits = 16;
+    constexpr uint32_t kPipelineBits = 12;
+    constexpr uint32_t kLayerBits = 4;
+
+    constexpr uint32_t kMeshShift = kDepthBits;
+    constexpr uint32_t kMaterialShift = kMeshShift + kMeshBits;
+    constexpr uint32_t kPipelineShift = kMaterialShift + kMaterialBits;
+    constexpr uint32_t kLayerShift = kPipelineShift + kPipelineBits;
+
+    constexpr uint64_t mask(uint32_t bits) { return (uint64_t(1) << bits) - 1; }
+
+    // Fields wider than their slot are truncated; that only weakens the ordering
+    constexpr uint64_t make(uint32_t layer, uint32_t pipeline, uint32_t material, uint32_t mesh, uint32_t depth)
+    {
+        return ((uint64_t(layer) & mask(kLayerBits)) << kLayerShift) |
+               ((uint64_t(pipeline) & mask(kPipelineBits)) << kPipelineShift) |
+               ((uint64_t(material) & mask(kMaterialBits)) << kMaterialShift) |
+               ((uint64_t(mesh) & mask(kMeshBits)) << kMeshShift) |
+               (uint64_t(depth) & mask(kDepthBits));
+    }
+
+    // Logarithmic quantization of view-space distance: more precision close to the camera
+    uint32_t quantizeDepth(float viewDepth, float maxDepth = 1000.0f);
+
+    struct Entry
+    {
+        uint64_t key;
+        uint32_t index; // Caller's item index
+    };
+
+    // Stable LSD radix sort on the key, 8 bits per pass. Passes whose digit is
+    // identical for every key are skipped. `scratch` is resized as needed.
+    void radixSort(std::vector<Entry> &entries, std::vector<Entry> &scratch);
+}
@@ -32,6 +32,8 @@ struct GameObject
     Material *material = nullptr; // Add material
     Transform transform;
     bool enabled = true; // Allow disabling objects
+    uint32_t lod = 0;    // LOD chosen last frame (for hysteresis)
+    uint8_t layer = 0;   // Draw sort layer: lower layers are recorded first
 
     GameObject(Mesh *m, Material *mat)
         : mesh(m), material(mat) {}
@@ -0,0 +1,243 @@
+#include "HudOverlay.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+
+namespace
+{
+    constexpr uint32_t kCellSize = 8;
+    constexpr uint32_t kColumns = HudOverlay::kAtlasWidth / kCellSize;
+    constexpr uint32_t kGlyphWidth = 5;
+    constexpr uint32_t kGlyphHeight = 7;
+    constexpr uint32_t kAdvance = kGlyphWidth + 1;
+    constexpr uint32_t kLineHeight = kGlyphHeight + 3;
+    constexpr char kSolid = 127;
+
+    struct Glyph
+    {
+        char c;
+        uint8_t rows[kGlyphHeight]; // Top to bottom, bit 4 is the leftmost column
+    };
+
+    // Characters missing here (and control characters) are left blank
+    constexpr Glyph kGlyphs[] = {
+        {' ', {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+        {'0', {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}},
+        {'1', {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+        {'2', {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}},
+        {'3', {0x1E, 0x01, 0x01, 0x0E, 0x01, 0x01, 0x1E}},
+        {'4', {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}},
+        {'5', {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}},
+        {'6', {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}},
+        {'7', {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}},
+        {'8', {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}},
+        {'9', {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}},
+        {'A', {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}},
+        {'B', {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}},
+        {'C', {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}},
+        {'D', {0x1E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x1E}},
+        {'E', {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}},
+        {'F', {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}},
+        {'G', {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}},
+        {'H', {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}},
+        {'I', {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+        {'J', {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}},
+        {'K', {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}},
+        {'L', {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}},
+        {'M', {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}},
+        {'N', {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}},
+        {'O', {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}},
+        {'P', {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}},
+        {'Q', {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}},
+        {'R', {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}},
+        {'S', {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}},
+        {'T', {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}},
+        {'U', {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}},
+        {'V', {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}},
+        {'W', {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}},
+        {'X', {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}},
+        {'Y', {0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x04}},
+        {'Z', {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}},
+        {'.', {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}},
+        {',', {0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08}},
+        {':', {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}},
+        {'/', {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}},
+        {'%', {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}},
+        {'-', {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}},
+        {'+', {0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00}},
+        {'(', {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02}},
+        {')', {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08}},
+        {'=', {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00}},
+        {'_', {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F}},
+        {'<', {0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02}},
+        {'>', {0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08}},
+        {'[', {0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E}},
+        {']', {0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E}},
+        {'#', {0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A}},
+        {'*', {0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00}},
+        {'!', {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04}},
+        {'?', {0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04}},
+        {'\'', {0x04, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00}},
+        {'"', {0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00}},
+        {'|', {0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}},
+    };
+
+    constexpr uint32_t kWhite = HudOverlay::rgba(255, 255, 255);
+    constexpr uint32_t kLabel = HudOverlay::rgba(160, 170, 185);
+    constexpr uint32_t kBackground = HudOverlay::rgba(0, 0, 0, 160);
+    constexpr uint32_t kGood = HudOverlay::rgba(80, 220, 90);
+    constexpr uint32_t kSlow = HudOverlay::rgba(240, 200, 60);
+    constexpr uint32_t kBad = HudOverlay::rgba(240, 70, 60);
+    constexpr uint32_t kGuide = HudOverlay::rgba(255, 255, 255, 70);
+
+    constexpr float kTargetMs = 1000.0f / 60.0f;
+
+    uint32_t frameColor(float ms)
+    {
+        return ms <= kTargetMs * 1.05f ? kGood : ms <= 2.0f * kTargetMs ? kSlow : kBad;
+    }
+
+    uint16_t cellX(char c) { return static_cast<uint16_t>((static_cast<uint8_t>(c) - 32) % kColumns * kCellSize); }
+    uint16_t cellY(char c) { return static_cast<uint16_t>((static_cast<uint8_t>(c) - 32) / kColumns * kCellSize); }
+}
+
+std::vector<uint32_t> HudOverlay::buildAtlas()
+{
+    std::vector<uint32_t> texels(kAtlasWidth * kAtlasHeight, rgba(255, 255, 255, 0));
+    auto drawGlyph = [&](char c, const uint8_t *rows)
+    {
+        const uint32_t x0 = cellX(c);
+        const uint32_t y0 = cellY(c);
+        for (uint32_t y = 0; y < kGlyphHeight; ++y)
+            for (uint32_t x = 0; x < kGlyphWidth; ++x)
+                if (rows[y] & (1u << (kGlyphWidth - 1 - x)))
+                    texels[(y0 + y) * kAtlasWidth + x0 + x] = kWhite;
+    };
+
+    for (const Glyph &glyph : kGlyphs)
+    {
+        drawGlyph(glyph.c, glyph.rows);
+        if (std::isupper(static_cast<unsigned char>(glyph.c)))
+            drawGlyph(static_cast<char>(std::tolower(static_cast<unsigned char>(glyph.c))), glyph.rows);
+    }
+
+    // The whole solid cell, so rectangles can sample anywhere near its middle
+    for (uint32_t y = 0; y < kCellSize; ++y)
+        for (uint32_t x = 0; x < kCellSize; ++x)
+            texels[(cellY(kSolid) + y) * kAtlasWidth + cellX(kSolid) + x] = kWhite;
+    return texels;
+}
+
+HudOverlay::HudOverlay(uint32_t scale)
+    : scale(std::max(scale, 1u))
+{
+}
+
+void HudOverlay::addFrameTime(float ms)
+{
+    frameTimes[frameCursor] = ms;
+    frameCursor = (frameCursor + 1) % kFrameHistory;
+    frameCount = std::min(frameCount + 1, kFrameHistory);
+}
+
+void HudOverlay::text(float x, float y, const char *str, uint32_t color)
+{
+    const float s = static_cast<float>(scale);
+    for (const char *p = str; *p; ++p, x += kAdvance * s)
+    {
+        const char c = *p;
+        if (c <= ' ' || c >= kSolid)
+            continue;
+        const uint16_t u = cellX(c);
+        const uint16_t v = cellY(c);
+        quads.push_back(HudQuad{glm::vec4(x, y, x + kGlyphWidth * s, y + kGlyphHeight * s),
+                                {u, v, static_cast<uint16_t>(u + kGlyphWidth), static_cast<uint16_t>(v + kGlyphHeight)},
+                                color});
+    }
+}
+
+void HudOverlay::rect(float x, float y, float w, float h, uint32_t color)
+{
+    // A single texel in the middle of the solid cell
+    const uint16_t u = static_cast<uint16_t>(cellX(kSolid) + kCellSize / 2);
+    const uint16_t v = static_cast<uint16_t>(cellY(kSolid) + kCellSize / 2);
+    quads.push_back(HudQuad{glm::vec4(x, y, x + w, y + h), {u, v, u, v}, color});
+}
+
+void HudOverlay::line(float x, float y, uint32_t color, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(lineBuffer, sizeof(lineBuffer), format, args);
+    va_end(args);
+    text(x, y, lineBuffer, color);
+}
+
+void HudOverlay::build(const HudStats &stats)
+{
+    clear();
+
+    const float s = static_cast<float>(scale);
+    const float margin = 4.0f * s;
+    const float lineHeight = kLineHeight * s;
+    const float width = 30.0f * kAdvance * s; // Characters per line
+    const float graphHeight = 4.0f * lineHeight;
+
+    float sum = 0.0f;
+    float worst = 0.0f;
+    for (uint32_t i = 0; i < frameCount; ++i)
+    {
+        sum += frameTimes[i];
+        worst = std::max(worst, frameTimes[i]);
+    }
+    const float average = frameCount > 0 ? sum / static_cast<float>(frameCount) : 0.0f;
+
+    // Background first: quads are blended in order
+    const float x = 2.0f * margin;
+    float y = 2.0f * margin;
+    const float panelHeight = 6.5f * lineHeight + graphHeight + kGlyphHeight * s;
+    rect(margin, margin, width + 2.0f * margin, panelHeight + 2.0f * margin, kBackground);
+
+    line(x, y, frameColor(average), "FRAME %5.2f MS  MAX %5.2f", average, worst);
+    y += lineHeight;
+
+    // Frame time history, newest on the right. The scale grows in steps of the 60 Hz
+    // budget so a spike doesn't make the graph jump every frame.
+    const float graphMs = std::max(1.0f, std::ceil(worst / kTargetMs)) * kTargetMs;
+    const float barWidth = width / static_cast<float>(kFrameHistory);
+    for (uint32_t i = 0; i < frameCount; ++i)
+    {
+        const float ms = frameTimes[(frameCursor + kFrameHistory - frameCount + i) % kFrameHistory];
+        const float h = std::min(ms / graphMs, 1.0f) * graphHeight;
+        rect(x + (kFrameHistory - frameCount + i) * barWidth, y + graphHeight - h, std::max(barWidth - 1.0f, 1.0f), h,
+             frameColor(ms));
+    }
+    for (float guide = kTargetMs; guide < graphMs + 0.5f * kTargetMs; guide += kTargetMs)
+        rect(x, y + graphHeight - guide / graphMs * graphHeight, width, std::max(s / 2.0f, 1.0f), kGuide);
+    y += graphHeight + lineHeight / 2.0f;
+
+    line(x, y, kWhite, "DRAWS %6u  OBJECTS %7u", stats.drawCalls, stats.objects);
+    y += lineHeight;
+    if (stats.frustumCulled)
+        line(x, y, kWhite, "CULLED %5u  OCCLUSION %5u", *stats.frustumCulled, stats.occlusionCulled);
+    else
+        line(x, y, kWhite, "CULLED     -  OCCLUSION %5u", stats.occlusionCulled);
+    y += lineHeight;
+    line(x, y, kWhite, "PIPELINES %3u  MATERIALS %4u", stats.pipelineBinds, stats.materialChanges);
+    y += lineHeight;
+
+    const double mb = 1.0 / (1024.0 * 1024.0);
+    line(x, y, kWhite, "MEMORY %5.0f / %5.0f MB", stats.memoryUsed * mb, stats.memoryBudget * mb);
+    y += lineHeight;
+    const double usedFraction =
+        stats.memoryBudget > 0 ? static_cast<double>(stats.memoryUsed) / static_cast<double>(stats.memoryBudget) : 0.0;
+    const float used = static_cast<float>(std::min(usedFraction, 1.0));
+    rect(x, y, width, lineHeight / 2.0f, kGuide);
+    rect(x, y, used * width, lineHeight / 2.0f, used < 0.9f ? kGood : kBad);
+    y += lineHeight;
+
+    line(x, y, kLabel, "HUD %.3f MS", stats.buildMs);
+}
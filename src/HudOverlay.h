@@ -0,0 +1,82 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// One screen-space quad of the overlay (per-instance vertex data, must match shaders/hud.vert)
+struct HudQuad
+{
+    glm::vec4 rect;      // x0, y0, x1, y1 in pixels from the top-left corner
+    uint16_t texels[4];  // Atlas rectangle u0, v0, u1, v1 in texels
+    uint32_t color;      // RGBA8, alpha multiplied by the atlas coverage
+};
+static_assert(sizeof(HudQuad) == 28, "HudQuad must match the vertex input layout");
+
+// What the overlay shows besides frame times; counters are per frame
+struct HudStats
+{
+    uint32_t objects = 0;
+    uint32_t drawCalls = 0;
+    std::optional<uint32_t> frustumCulled; // Outside the main view; none when the GPU culls
+    uint32_t occlusionCulled = 0;
+    uint32_t pipelineBinds = 0;
+    uint32_t materialChanges = 0;
+    uint64_t memoryUsed = 0;   // Device-local heaps
+    uint64_t memoryBudget = 0;
+    float buildMs = 0.0f;      // CPU time the overlay itself took last frame
+};
+
+// CPU side of the performance overlay: lays out text and bar graphs as textured quads
+// over a baked bitmap font, ready to be copied into a vertex buffer and drawn in one
+// instanced call. Everything is reused between frames, so building allocates nothing
+// once the quad list has reached its working size.
+//
+// The atlas holds a 5x7 font for ASCII 32..126 (lowercase drawn as uppercase) in 8x8
+// cells; cell 127 is solid and backs rectangles and bars. Glyphs are drawn at integer
+// scales and fetched texel-exact, so the text stays sharp without any filtering.
+class HudOverlay
+{
+public:
+    static constexpr uint32_t kAtlasWidth = 128; // 16 x 6 cells
+    static constexpr uint32_t kAtlasHeight = 48;
+    static constexpr uint32_t kFrameHistory = 120;
+
+    // RGBA8 texels: white, with the glyph coverage in alpha
+    static std::vector<uint32_t> buildAtlas();
+
+    static constexpr uint32_t rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255)
+    {
+        return static_cast<uint32_t>(r) | static_cast<uint32_t>(g) << 8 | static_cast<uint32_t>(b) << 16 |
+               static_cast<uint32_t>(a) << 24;
+    }
+
+    explicit HudOverlay(uint32_t scale = 2);
+
+    // Once per frame, before build()
+    void addFrameTime(float ms);
+
+    // Replaces the quads with the panel: frame time graph and the counters in `stats`
+    void build(const HudStats &stats);
+
+    // Primitives, appended to the current quads (positions in pixels)
+    void clear() { quads.clear(); }
+    void text(float x, float y, const char *str, uint32_t color);
+    void rect(float x, float y, float w, float h, uint32_t color);
+
+    const std::vector<HudQuad> &getQuads() const { return quads; }
+    uint32_t getScale() const { return scale; }
+
+private:
+    const uint32_t scale;
+    std::vector<HudQuad> quads;
+
+    std::array<float, kFrameHistory> frameTimes{}; // Ring, oldest at frameCursor once full
+    uint32_t frameCursor = 0;
+    uint32_t frameCount = 0;
+
+    // Formats into a reused buffer and draws it as one line of text
+    void line(float x, float y, uint32_t color, const char *format, ...);
+    char lineBuffer[128];
+};
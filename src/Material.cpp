@@ -1,22 +1,33 @@
 #include "Material.h"
 #include "../vulkan/VulkanDevice.h"
-#include "../vulkan/VulkanRenderPass.h"
 #include "../vulkan/VulkanShader.h"
 #include "../vulkan/VulkanGraphicsPipeline.h"
 #include "Primitive.h"
 
 Material::Material(const VulkanDevice &device,
-                   const VulkanRenderPass &renderPass,
-                   std::unique_ptr<VulkanShader> shaderPtr)
-    : shader(std::move(shaderPtr))
+                   const RenderTargetFormats &targets,
+                   const PipelineDesc &desc,
+                   std::unique_ptr<VulkanShader> shaderPtr,
+                   const std::vector<vk::DescriptorSetLayout> &setLayouts,
+                   uint32_t materialId)
+    : shader(std::move(shaderPtr)), materialId(materialId)
 {
-    // Create pipeline with vertex input for standard vertex format
-    auto bindingDesc = Vertex::binding();
-    auto attrs = Vertex::attributes();
+    // Vertex input matches the permutation: quantized positions use the compact layout
+    const bool quantized = desc.has(ShaderFeatureQuantizedPositions);
+    auto bindingDesc = quantized ? QuantizedVertex::binding() : Vertex::binding();
+    auto attrs = quantized ? QuantizedVertex::attributes() : Vertex::attributes();
 
-    pipeline = std::make_unique<VulkanGraphicsPipeline>(
-        device, renderPass, *shader,
-        &bindingDesc, static_cast<uint32_t>(attrs.size()), attrs.data());
+    pipeline = std::make_shared<VulkanGraphicsPipeline>(
+        device, targets, *shader, desc,
+        &bindingDesc, static_cast<uint32_t>(attrs.size()), attrs.data(),
+        static_cast<uint32_t>(setLayouts.size()), setLayouts.data());
+}
+
+Material::Material(std::shared_ptr<VulkanShader> shader,
+                   std::shared_ptr<VulkanGraphicsPipeline> pipeline,
+                   uint32_t materialId)
+    : shader(std::move(shader)), pipeline(std::move(pipeline)), materialId(materialId)
+{
 }
 
 Material::~Material() = default;
@@ -24,6 +35,11 @@ Material::~Material() = default;
 Material::Material(Material &&) noexcept = default;
 Material &Material::operator=(Material &&) noexcept = default;
 
+std::unique_ptr<Material> Material::createInstance(uint32_t materialId) const
+{
+    return std::unique_ptr<Material>(new Material(shader, pipeline, materialId));
+}
+
 vk::Pipeline Material::getPipeline() const
 {
     return pipeline->get();
@@ -1,18 +1,23 @@
 #pragma once
 #include <vulkan/vulkan.hpp>
 #include <memory>
+#include <vector>
 
 class VulkanDevice;
-class VulkanRenderPass;
 class VulkanShader;
 class VulkanGraphicsPipeline;
+struct RenderTargetFormats;
+struct PipelineDesc;
 
 class Material
 {
 public:
     Material(const VulkanDevice &device,
-             const VulkanRenderPass &renderPass,
-             std::unique_ptr<VulkanShader> shader);
+             const RenderTargetFormats &targets,
+             const PipelineDesc &desc,
+             std::unique_ptr<VulkanShader> shader,
+             const std::vector<vk::DescriptorSetLayout> &setLayouts = {},
+             uint32_t materialId = 0);
 
     ~Material();
 
@@ -22,10 +27,19 @@ public:
     Material(Material &&) noexcept;
     Material &operator=(Material &&) noexcept;
 
+    // New material sharing this one's pipeline; only the bindless material ID differs
+    std::unique_ptr<Material> createInstance(uint32_t materialId) const;
+
     vk::Pipeline getPipeline() const;
     vk::PipelineLayout getLayout() const;
+    uint32_t getMaterialId() const { return materialId; }
 
 private:
-    std::unique_ptr<VulkanShader> shader;
-    std::unique_ptr<VulkanGraphicsPipeline> pipeline;
-};
\ No newline at end of file
+    Material(std::shared_ptr<VulkanShader> shader,
+             std::shared_ptr<VulkanGraphicsPipeline> pipeline,
+             uint32_t materialId);
+
+    std::shared_ptr<VulkanShader> shader;
+    std::shared_ptr<VulkanGraphicsPipeline> pipeline;
+    uint32_t materialId = 0; // Index into the bindless material table
+};
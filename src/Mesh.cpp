@@ -1,13 +1,57 @@
 #include "Mesh.h"
 #include "VulkanDevice.h"
+#include "VulkanUploader.h"
+#include "VulkanDebug.h"
 
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <stdexcept>
 
+namespace
+{
+    // Screen-size (fraction of viewport height) below which LOD n+1 takes over from LOD n
+    constexpr float kLodBaseScreenSize = 0.25f;
+}
+
+uint32_t Mesh::allocateId()
+{
+    static std::atomic<uint32_t> nextId{0};
+    return nextId.fetch_add(1, std::memory_order_relaxed);
+}
+
 Mesh::Mesh(const VulkanDevice &device, const std::vector<Vertex> &vertices)
+    : Mesh(device, std::vector<std::vector<Vertex>>{vertices})
+{
+}
+
+Mesh::Mesh(const VulkanDevice &device, const std::vector<std::vector<Vertex>> &lodChain)
     : deviceRef(device)
 {
-    createVertexBuffer(vertices);
+    std::vector<Vertex> packed = packLods(lodChain);
+    createVertexBuffer(packed.size(), [&packed](VertexSpan out)
+                       { std::memcpy(out.data, packed.data(), sizeof(Vertex) * out.size); });
+}
+
+Mesh::Mesh(const VulkanDevice &device, VulkanUploader &uploader, const std::vector<std::vector<Vertex>> &lodChain)
+    : deviceRef(device)
+{
+    std::vector<Vertex> packed = packLods(lodChain);
+    createVertexBuffer(packed.size(), [&packed](VertexSpan out)
+                       { std::memcpy(out.data, packed.data(), sizeof(Vertex) * out.size); },
+                       &uploader);
+}
+
+Mesh::Mesh(const VulkanDevice &device, size_t vertexCount,
+           const std::function<void(VertexSpan)> &fill, float boundingRadius)
+    : deviceRef(device), boundingRadius(boundingRadius)
+{
+    MeshLod lod;
+    lod.vertexCount = static_cast<uint32_t>(vertexCount);
+    lods.push_back(lod);
+
+    createVertexBuffer(vertexCount, fill);
 }
 
 Mesh::~Mesh()
@@ -15,7 +59,7 @@ Mesh::~Mesh()
     if (vertexBuffer)
         deviceRef.getLogicalDevice().destroyBuffer(vertexBuffer);
     if (vertexMemory)
-        deviceRef.getLogicalDevice().freeMemory(vertexMemory);
+        deviceRef.freeMemory(vertexMemory);
 }
 
 void Mesh::bind(vk::CommandBuffer cmd) const
@@ -24,48 +68,107 @@ void Mesh::bind(vk::CommandBuffer cmd) const
     cmd.bindVertexBuffers(0, 1, &vertexBuffer, offsets);
 }
 
-void Mesh::draw(vk::CommandBuffer cmd) const
+void Mesh::draw(vk::CommandBuffer cmd, uint32_t lod) const
 {
-    cmd.draw(vertexCount, 1, 0, 0);
+    const MeshLod &level = lods[std::min(lod, getLodCount() - 1)];
+    cmd.draw(level.vertexCount, 1, level.firstVertex, 0);
 }
 
-uint32_t Mesh::findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const
+uint32_t Mesh::selectLod(float screenSize, uint32_t currentLod, float hysteresis) const
 {
-    auto memProperties = deviceRef.getPhysicalDevice().getMemoryProperties();
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; ++i)
+    uint32_t lod = std::min(currentLod, getLodCount() - 1);
+
+    // Threshold between LOD i and i+1 halves with every level
+    auto threshold = [](uint32_t i)
+    { return kLodBaseScreenSize / static_cast<float>(1u << i); };
+
+    // Coarsen only once clearly below the boundary, refine only once clearly above it
+    while (lod + 1 < getLodCount() && screenSize < threshold(lod) * (1.0f - hysteresis))
+        ++lod;
+    while (lod > 0 && screenSize > threshold(lod - 1) * (1.0f + hysteresis))
+        --lod;
+
+    return lod;
+}
+
+std::vector<Vertex> Mesh::packLods(const std::vector<std::vector<Vertex>> &lodChain)
+{
+    if (lodChain.empty())
+        throw std::runtime_error("mesh needs at least one LOD!");
+
+    std::vector<Vertex> packed;
+    size_t total = 0;
+    for (const auto &level : lodChain)
+        total += level.size();
+    packed.reserve(total);
+
+    for (const auto &level : lodChain)
     {
-        if ((typeFilter & (1 << i)) &&
-            (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-        {
-            return i;
-        }
+        MeshLod lod;
+        lod.firstVertex = static_cast<uint32_t>(packed.size());
+        lod.vertexCount = static_cast<uint32_t>(level.size());
+        lods.push_back(lod);
+        packed.insert(packed.end(), level.begin(), level.end());
     }
 
-    throw std::runtime_error("failed to find suitable memory type!");
+    for (const Vertex &v : lodChain[0])
+        boundingRadius = std::max(boundingRadius, glm::length(v.pos));
+    return packed;
 }
 
-void Mesh::createVertexBuffer(const std::vector<Vertex> &vertices)
+void Mesh::createVertexBuffer(size_t vertexCount, const std::function<void(VertexSpan)> &fill,
+                              VulkanUploader *uploader)
 {
-    vertexCount = static_cast<uint32_t>(vertices.size());
+    if (vertexCount == 0)
+        throw std::runtime_error("cannot create an empty mesh!");
+
+    vertexTotal = vertexCount;
     vk::DeviceSize bufferSize = sizeof(Vertex) * vertexCount;
+    auto device = deviceRef.getLogicalDevice();
+
+    if (uploader)
+    {
+        // Written on the transfer queue, read on graphics: concurrent sharing saves ownership transfers
+        std::vector<uint32_t> families = deviceRef.getSharingFamilies(deviceRef.getTransferQueueFamily());
+        vk::BufferCreateInfo bufferInfo({}, bufferSize,
+                                        vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
+                                        vk::SharingMode::eExclusive);
+        if (families.size() > 1)
+        {
+            bufferInfo.sharingMode = vk::SharingMode::eConcurrent;
+            bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(families.size());
+            bufferInfo.pQueueFamilyIndices = families.data();
+        }
+        vertexBuffer = device.createBuffer(bufferInfo);
+        VK_DEBUG_NAME(device, vertexBuffer, "streamed mesh vertices");
+
+        auto vertReq = device.getBufferMemoryRequirements(vertexBuffer);
+        vk::MemoryAllocateInfo vertAlloc(vertReq.size, deviceRef.findMemoryType(vertReq.memoryTypeBits,
+                                                                                vk::MemoryPropertyFlagBits::eDeviceLocal));
+        vertexMemory = deviceRef.allocateMemory(vertAlloc, MemoryCategory::Geometry);
+        device.bindBufferMemory(vertexBuffer, vertexMemory, 0);
+
+        uploadTicket = uploader->upload(vertexBuffer, 0, bufferSize, [&fill, vertexCount](void *data)
+                                        { fill(VertexSpan{static_cast<Vertex *>(data), vertexCount}); });
+        return;
+    }
 
     // staging buffer
     vk::BufferCreateInfo bufferInfo({}, bufferSize,
                                     vk::BufferUsageFlagBits::eTransferSrc, vk::SharingMode::eExclusive);
-    auto device = deviceRef.getLogicalDevice();
     vk::Buffer stagingBuffer = device.createBuffer(bufferInfo);
 
     auto memReq = device.getBufferMemoryRequirements(stagingBuffer);
     vk::MemoryAllocateInfo allocInfo(memReq.size,
-                                     findMemoryType(memReq.memoryTypeBits,
-                                                    vk::MemoryPropertyFlagBits::eHostVisible |
-                                                        vk::MemoryPropertyFlagBits::eHostCoherent));
-    vk::DeviceMemory stagingMemory = device.allocateMemory(allocInfo);
+                                     deviceRef.findMemoryType(memReq.memoryTypeBits,
+                                                              vk::MemoryPropertyFlagBits::eHostVisible |
+                                                                  vk::MemoryPropertyFlagBits::eHostCoherent));
+    vk::DeviceMemory stagingMemory = deviceRef.allocateMemory(allocInfo, MemoryCategory::Staging);
     device.bindBufferMemory(stagingBuffer, stagingMemory, 0);
 
-    // copy vertex data
+    // write vertex data straight into the mapped staging memory
     void *data = device.mapMemory(stagingMemory, 0, bufferSize);
-    std::memcpy(data, vertices.data(), static_cast<size_t>(bufferSize));
+    fill(VertexSpan{static_cast<Vertex *>(data), vertexCount});
     device.unmapMemory(stagingMemory);
 
     // create device local buffer
@@ -73,11 +176,12 @@ void Mesh::createVertexBuffer(const std::vector<Vertex> &vertices)
                                           vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
                                           vk::SharingMode::eExclusive);
     vertexBuffer = device.createBuffer(vertexBufferInfo);
+    VK_DEBUG_NAME(device, vertexBuffer, "mesh vertices");
 
     auto vertReq = device.getBufferMemoryRequirements(vertexBuffer);
     vk::MemoryAllocateInfo vertAlloc(vertReq.size,
-                                     findMemoryType(vertReq.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal));
-    vertexMemory = device.allocateMemory(vertAlloc);
+                                     deviceRef.findMemoryType(vertReq.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal));
+    vertexMemory = deviceRef.allocateMemory(vertAlloc, MemoryCategory::Geometry);
     device.bindBufferMemory(vertexBuffer, vertexMemory, 0);
 
     // copy staging -> vertex buffer using a temporary command pool and buffer
@@ -102,5 +206,5 @@ void Mesh::createVertexBuffer(const std::vector<Vertex> &vertices)
     device.destroyCommandPool(cmdPool);
 
     device.destroyBuffer(stagingBuffer);
-    device.freeMemory(stagingMemory);
+    deviceRef.freeMemory(stagingMemory);
 }
\ No newline at end of file
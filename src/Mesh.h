@@ -2,14 +2,36 @@
 #include <vulkan/vulkan.hpp>
 #include <glm/vec3.hpp>
 #include <vector>
+#include <functional>
 #include "Primitive.h"
 
 class VulkanDevice;
+class VulkanUploader;
+
+struct MeshLod
+{
+    uint32_t firstVertex = 0;
+    uint32_t vertexCount = 0;
+};
 
 class Mesh
 {
 public:
     Mesh(const VulkanDevice &device, const std::vector<Vertex> &vertices);
+
+    // LOD 0 first, coarser levels after (see MeshSimplifier::buildLodChain).
+    // All levels share one vertex buffer.
+    Mesh(const VulkanDevice &device, const std::vector<std::vector<Vertex>> &lodChain);
+
+    // Single LOD written by `fill` directly into the mapped staging buffer
+    // (e.g. a Primitives::generate* call), skipping the intermediate std::vector.
+    // The caller supplies the bounds since reading back mapped memory is slow.
+    Mesh(const VulkanDevice &device, size_t vertexCount,
+         const std::function<void(VertexSpan)> &fill, float boundingRadius);
+
+    // Uploaded through `uploader` without waiting (safe on any thread). The mesh must not
+    // be drawn before uploader.isComplete(getUploadTicket()).
+    Mesh(const VulkanDevice &device, VulkanUploader &uploader, const std::vector<std::vector<Vertex>> &lodChain);
     ~Mesh();
 
     // Delete copy operations
@@ -17,16 +39,36 @@ public:
     Mesh &operator=(const Mesh &) = delete;
 
     void bind(vk::CommandBuffer cmd) const;
-    void draw(vk::CommandBuffer cmd) const;
+    void draw(vk::CommandBuffer cmd, uint32_t lod = 0) const;
+
+    // Pick a LOD from the fraction of the viewport height covered by the bounding sphere.
+    // Switching is biased towards the current LOD by `hysteresis` to avoid popping.
+    uint32_t selectLod(float screenSize, uint32_t currentLod, float hysteresis = 0.15f) const;
+
+    uint32_t getVertexCount() const { return lods[0].vertexCount; }
+    uint32_t getLodCount() const { return static_cast<uint32_t>(lods.size()); }
+    uint32_t getTriangleCount(uint32_t lod = 0) const { return lods[lod].vertexCount / 3; }
+    const MeshLod &getLod(uint32_t lod) const { return lods[lod]; }
+    float getBoundingRadius() const { return boundingRadius; }
+    vk::DeviceSize getSizeBytes() const { return sizeof(Vertex) * vertexTotal; }
+    uint64_t getUploadTicket() const { return uploadTicket; } // 0: uploaded by the constructor
 
-    uint32_t getVertexCount() const { return vertexCount; }
+    // Process-unique, used in draw sort keys to group draws sharing a vertex buffer
+    uint32_t getId() const { return id; }
 
 private:
     const VulkanDevice &deviceRef;
     vk::Buffer vertexBuffer = {};
     vk::DeviceMemory vertexMemory = {};
-    uint32_t vertexCount = 0;
+    std::vector<MeshLod> lods;
+    float boundingRadius = 0.0f; // Object-space sphere around the origin
+    size_t vertexTotal = 0;      // All LODs
+    uint64_t uploadTicket = 0;
+    uint32_t id = allocateId();
+
+    static uint32_t allocateId();
 
-    void createVertexBuffer(const std::vector<Vertex> &vertices);
-    uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const;
-};
\ No newline at end of file
+    std::vector<Vertex> packLods(const std::vector<std::vector<Vertex>> &lodChain);
+    void createVertexBuffer(size_t vertexCount, const std::function<void(VertexSpan)> &fill,
+                            VulkanUploader *uploader = nullptr);
+};
@@ -0,0 +1,370 @@
+#include "MeshSimplifier.h"
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace
+{
+    // Symmetric 4x4 quadric stored as its 10 unique coefficients
+    struct Quadric
+    {
+        double q[10] = {};
+
+        static Quadric fromPlane(double a, double b, double c, double d, double weight = 1.0)
+        {
+            Quadric r;
+            r.q[0] = a * a * weight;
+            r.q[1] = a * b * weight;
+            r.q[2] = a * c * weight;
+            r.q[3] = a * d * weight;
+            r.q[4] = b * b * weight;
+            r.q[5] = b * c * weight;
+            r.q[6] = b * d * weight;
+            r.q[7] = c * c * weight;
+            r.q[8] = c * d * weight;
+            r.q[9] = d * d * weight;
+            return r;
+        }
+
+        Quadric &operator+=(const Quadric &o)
+        {
+            for (int i = 0; i < 10; ++i)
+                q[i] += o.q[i];
+            return *this;
+        }
+
+        double evaluate(const glm::dvec3 &p) const
+        {
+            return q[0] * p.x * p.x + 2.0 * q[1] * p.x * p.y + 2.0 * q[2] * p.x * p.z + 2.0 * q[3] * p.x +
+                   q[4] * p.y * p.y + 2.0 * q[5] * p.y * p.z + 2.0 * q[6] * p.y +
+                   q[7] * p.z * p.z + 2.0 * q[8] * p.z +
+                   q[9];
+        }
+    };
+
+    struct VertexKey
+    {
+        std::array<uint32_t, 6> bits;
+
+        explicit VertexKey(const Vertex &v)
+        {
+            std::memcpy(bits.data(), &v.pos, sizeof(float) * 3);
+            std::memcpy(bits.data() + 3, &v.color, sizeof(float) * 3);
+        }
+
+        bool operator==(const VertexKey &o) const { return bits == o.bits; }
+    };
+
+    struct VertexKeyHash
+    {
+        size_t operator()(const VertexKey &k) const
+        {
+            size_t h = 1469598103934665603ull;
+            for (uint32_t b : k.bits)
+                h = (h ^ b) * 1099511628211ull;
+            return h;
+        }
+    };
+
+    struct Collapse
+    {
+        double cost;
+        uint32_t keep;
+        uint32_t remove;
+        uint32_t keepVersion;
+        uint32_t removeVersion;
+        glm::dvec3 position;
+        glm::vec3 color;
+
+        bool operator>(const Collapse &o) const { return cost > o.cost; }
+    };
+
+    uint64_t edgeKey(uint32_t a, uint32_t b)
+    {
+        if (a > b)
+            std::swap(a, b);
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+
+    class Simplifier
+    {
+    public:
+        explicit Simplifier(const std::vector<Vertex> &triangles)
+        {
+            weld(triangles);
+            buildQuadrics();
+        }
+
+        void run(size_t targetTriangles)
+        {
+            std::unordered_set<uint64_t> seeded;
+            for (const auto &tri : tris)
+            {
+                for (int e = 0; e < 3; ++e)
+                {
+                    uint32_t a = tri[e];
+                    uint32_t b = tri[(e + 1) % 3];
+                    if (seeded.insert(edgeKey(a, b)).second)
+                        pushCandidate(a, b);
+                }
+            }
+
+            while (aliveTriangles > targetTriangles && !queue.empty())
+            {
+                Collapse c = queue.top();
+                queue.pop();
+
+                if (!vertexAlive[c.keep] || !vertexAlive[c.remove] ||
+                    version[c.keep] != c.keepVersion || version[c.remove] != c.removeVersion)
+                    continue; // Stale entry
+
+                if (flipsTriangles(c.keep, c.remove, c.position) || flipsTriangles(c.remove, c.keep, c.position))
+                    continue;
+
+                apply(c);
+            }
+        }
+
+        std::vector<Vertex> expand() const
+        {
+            std::vector<Vertex> out;
+            out.reserve(aliveTriangles * 3);
+            for (size_t t = 0; t < tris.size(); ++t)
+            {
+                if (!triangleAlive[t])
+                    continue;
+                for (uint32_t v : tris[t])
+                    out.push_back({glm::vec3(positions[v]), colors[v]});
+            }
+            return out;
+        }
+
+    private:
+        void weld(const std::vector<Vertex> &triangles)
+        {
+            std::unordered_map<VertexKey, uint32_t, VertexKeyHash> lookup;
+            lookup.reserve(triangles.size());
+
+            tris.resize(triangles.size() / 3);
+            for (size_t i = 0; i < tris.size() * 3; ++i)
+            {
+                auto inserted = lookup.emplace(VertexKey(triangles[i]), static_cast<uint32_t>(positions.size()));
+                if (inserted.second)
+                {
+                    positions.push_back(glm::dvec3(triangles[i].pos));
+                    colors.push_back(triangles[i].color);
+                }
+                tris[i / 3][i % 3] = inserted.first->second;
+            }
+
+            triangleAlive.assign(tris.size(), true);
+            aliveTriangles = tris.size();
+
+            vertexAlive.assign(positions.size(), true);
+            version.assign(positions.size(), 0);
+            vertexTriangles.resize(positions.size());
+            for (uint32_t t = 0; t < tris.size(); ++t)
+                for (uint32_t v : tris[t])
+                    vertexTriangles[v].push_back(t);
+        }
+
+        void buildQuadrics()
+        {
+            quadrics.assign(positions.size(), Quadric());
+            std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> edgeUse; // key -> (count, triangle)
+
+            for (uint32_t t = 0; t < tris.size(); ++t)
+            {
+                const auto &tri = tris[t];
+                glm::dvec3 n = glm::cross(positions[tri[1]] - positions[tri[0]], positions[tri[2]] - positions[tri[0]]);
+                double len = glm::length(n);
+                if (len <= 0.0)
+                    continue;
+                n /= len;
+
+                Quadric plane = Quadric::fromPlane(n.x, n.y, n.z, -glm::dot(n, positions[tri[0]]));
+                for (uint32_t v : tri)
+                    quadrics[v] += plane;
+
+                for (int e = 0; e < 3; ++e)
+                {
+                    auto &use = edgeUse[edgeKey(tri[e], tri[(e + 1) % 3])];
+                    ++use.first;
+                    use.second = t;
+                }
+            }
+
+            // Open edges (mesh borders and color seams) get a heavily weighted plane
+            // perpendicular to their face so they are kept in place
+            const double boundaryWeight = 1000.0;
+            for (const auto &entry : edgeUse)
+            {
+                if (entry.second.first != 1)
+                    continue;
+
+                uint32_t a = static_cast<uint32_t>(entry.first >> 32);
+                uint32_t b = static_cast<uint32_t>(entry.first & 0xFFFFFFFFu);
+                const auto &tri = tris[entry.second.second];
+
+                glm::dvec3 faceNormal = glm::cross(positions[tri[1]] - positions[tri[0]], positions[tri[2]] - positions[tri[0]]);
+                glm::dvec3 edge = positions[b] - positions[a];
+                glm::dvec3 n = glm::cross(edge, faceNormal);
+                double len = glm::length(n);
+                if (len <= 0.0)
+                    continue;
+                n /= len;
+
+                Quadric plane = Quadric::fromPlane(n.x, n.y, n.z, -glm::dot(n, positions[a]), boundaryWeight);
+                quadrics[a] += plane;
+                quadrics[b] += plane;
+            }
+        }
+
+        void pushCandidate(uint32_t a, uint32_t b)
+        {
+            Quadric q = quadrics[a];
+            q += quadrics[b];
+
+            // Choose the cheapest of the two endpoints and the midpoint
+            const glm::dvec3 mid = (positions[a] + positions[b]) * 0.5;
+            const double costs[3] = {q.evaluate(positions[a]), q.evaluate(positions[b]), q.evaluate(mid)};
+            int best = static_cast<int>(std::min_element(costs, costs + 3) - costs);
+
+            Collapse c;
+            c.cost = costs[best];
+            c.keep = a;
+            c.remove = b;
+            c.keepVersion = version[a];
+            c.removeVersion = version[b];
+            c.position = best == 0 ? positions[a] : (best == 1 ? positions[b] : mid);
+            c.color = best == 0 ? colors[a] : (best == 1 ? colors[b] : (colors[a] + colors[b]) * 0.5f);
+            queue.push(c);
+        }
+
+        // True if moving `moved` to `target` would flip or collapse a triangle not shared with `other`
+        bool flipsTriangles(uint32_t moved, uint32_t other, const glm::dvec3 &target) const
+        {
+            for (uint32_t t : vertexTriangles[moved])
+            {
+                if (!triangleAlive[t])
+                    continue;
+                const auto &tri = tris[t];
+                if (tri[0] == other || tri[1] == other || tri[2] == other)
+                    continue; // Removed by the collapse
+
+                glm::dvec3 p[3] = {positions[tri[0]], positions[tri[1]], positions[tri[2]]};
+                glm::dvec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                for (int i = 0; i < 3; ++i)
+                    if (tri[i] == moved)
+                        p[i] = target;
+                glm::dvec3 after = glm::cross(p[1] - p[0], p[2] - p[0]);
+
+                double lenBefore = glm::length(before);
+                double lenAfter = glm::length(after);
+                if (lenAfter <= 1e-12 * std::max(lenBefore, 1.0))
+                    return true;
+                if (glm::dot(before, after) < 0.2 * lenBefore * lenAfter)
+                    return true;
+            }
+            return false;
+        }
+
+        void apply(const Collapse &c)
+        {
+            positions[c.keep] = c.position;
+            colors[c.keep] = c.color;
+            quadrics[c.keep] += quadrics[c.remove];
+            vertexAlive[c.remove] = false;
+            ++version[c.keep];
+
+            for (uint32_t t : vertexTriangles[c.remove])
+            {
+                if (!triangleAlive[t])
+                    continue;
+                auto &tri = tris[t];
+                if (tri[0] == c.keep || tri[1] == c.keep || tri[2] == c.keep)
+                {
+                    triangleAlive[t] = false;
+                    --aliveTriangles;
+                    continue;
+                }
+                for (uint32_t &v : tri)
+                    if (v == c.remove)
+                        v = c.keep;
+                vertexTriangles[c.keep].push_back(t);
+            }
+            vertexTriangles[c.remove].clear();
+
+            auto &kept = vertexTriangles[c.keep];
+            kept.erase(std::remove_if(kept.begin(), kept.end(),
+                                      [this](uint32_t t)
+                                      { return !triangleAlive[t]; }),
+                       kept.end());
+
+            // Re-seed every edge around the surviving vertex with its new quadric
+            std::unordered_set<uint32_t> neighbours;
+            for (uint32_t t : kept)
+                for (uint32_t v : tris[t])
+                    if (v != c.keep)
+                        neighbours.insert(v);
+            for (uint32_t n : neighbours)
+                pushCandidate(c.keep, n);
+        }
+
+        std::vector<glm::dvec3> positions;
+        std::vector<glm::vec3> colors;
+        std::vector<Quadric> quadrics;
+        std::vector<std::array<uint32_t, 3>> tris;
+        std::vector<bool> triangleAlive;
+        std::vector<bool> vertexAlive;
+        std::vector<uint32_t> version;
+        std::vector<std::vector<uint32_t>> vertexTriangles;
+        size_t aliveTriangles = 0;
+
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> queue;
+    };
+}
+
+namespace MeshSimplifier
+{
+    std::vector<Vertex> simplify(const std::vector<Vertex> &triangles, size_t targetTriangles)
+    {
+        if (triangles.size() / 3 <= targetTriangles)
+            return triangles;
+
+        Simplifier simplifier(triangles);
+        simplifier.run(targetTriangles);
+        return simplifier.expand();
+    }
+
+    std::vector<std::vector<Vertex>> buildLodChain(const std::vector<Vertex> &triangles,
+                                                   uint32_t maxLods,
+                                                   float reduction,
+                                                   size_t minTriangles)
+    {
+        std::vector<std::vector<Vertex>> chain;
+        chain.push_back(triangles);
+
+        while (chain.size() < maxLods)
+        {
+            size_t previous = chain.back().size() / 3;
+            size_t target = static_cast<size_t>(static_cast<float>(previous) * reduction);
+            if (target < minTriangles)
+                break;
+
+            // Always simplify from the full-detail source so errors don't accumulate
+            std::vector<Vertex> level = simplify(triangles, target);
+            if (level.size() / 3 >= previous * 9 / 10)
+                break; // Simplifier ran out of valid collapses
+
+            chain.push_back(std::move(level));
+        }
+
+        return chain;
+    }
+}
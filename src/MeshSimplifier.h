@@ -0,0 +1,20 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include "Primitive.h"
+
+// Quadric error metric edge-collapse simplification (Garland & Heckbert) for the
+// non-indexed triangle lists used by Mesh. Vertices with identical position and
+// color are welded before simplification and the result is expanded again.
+namespace MeshSimplifier
+{
+    // Collapse edges until at most targetTriangles remain (or no valid collapse is left)
+    std::vector<Vertex> simplify(const std::vector<Vertex> &triangles, size_t targetTriangles);
+
+    // LOD 0 is the input; each further level targets `reduction` of the previous one.
+    // Stops early once a level would drop below minTriangles or fails to shrink.
+    std::vector<std::vector<Vertex>> buildLodChain(const std::vector<Vertex> &triangles,
+                                                   uint32_t maxLods = 4,
+                                                   float reduction = 0.5f,
+                                                   size_t minTriangles = 32);
+}
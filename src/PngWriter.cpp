@@ -0,0 +1,136 @@
+#include "PngWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    constexpr size_t kMaxStoredBlock = 65535; // Deflate stored block length limit
+
+    const std::array<uint32_t, 256> &crcTable()
+    {
+        static const std::array<uint32_t, 256> table = []
+        {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t n = 0; n < 256; ++n)
+            {
+                uint32_t c = n;
+                for (int k = 0; k < 8; ++k)
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[n] = c;
+            }
+            return t;
+        }();
+        return table;
+    }
+
+    uint32_t crc32(const uint8_t *data, size_t size, uint32_t crc = 0xFFFFFFFFu)
+    {
+        const auto &table = crcTable();
+        for (size_t i = 0; i < size; ++i)
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return crc;
+    }
+
+    void putBE32(std::vector<uint8_t> &out, uint32_t v)
+    {
+        out.push_back(static_cast<uint8_t>(v >> 24));
+        out.push_back(static_cast<uint8_t>(v >> 16));
+        out.push_back(static_cast<uint8_t>(v >> 8));
+        out.push_back(static_cast<uint8_t>(v));
+    }
+
+    void putChunk(std::vector<uint8_t> &out, const char type[4], const std::vector<uint8_t> &data)
+    {
+        putBE32(out, static_cast<uint32_t>(data.size()));
+        size_t typeOffset = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), data.begin(), data.end());
+        putBE32(out, crc32(out.data() + typeOffset, data.size() + 4) ^ 0xFFFFFFFFu);
+    }
+}
+
+namespace PngWriter
+{
+    std::vector<uint8_t> encode(uint32_t width, uint32_t height, const uint8_t *pixels, size_t rowPitch,
+                                bool swapRedBlue)
+    {
+        // Scanlines: filter type 0 (none) followed by the RGBA row
+        const size_t rowBytes = static_cast<size_t>(width) * 4;
+        std::vector<uint8_t> raw((rowBytes + 1) * height);
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            uint8_t *dst = raw.data() + y * (rowBytes + 1);
+            const uint8_t *src = pixels + y * rowPitch;
+            dst[0] = 0;
+            std::memcpy(dst + 1, src, rowBytes);
+            if (swapRedBlue)
+            {
+                for (size_t x = 0; x < rowBytes; x += 4)
+                    std::swap(dst[1 + x], dst[1 + x + 2]);
+            }
+        }
+
+        // zlib stream of stored deflate blocks
+        std::vector<uint8_t> zlib;
+        zlib.reserve(raw.size() + raw.size() / kMaxStoredBlock * 5 + 16);
+        zlib.push_back(0x78);
+        zlib.push_back(0x01);
+
+        uint64_t adlerA = 1, adlerB = 0;
+        size_t offset = 0;
+        do
+        {
+            size_t length = std::min(kMaxStoredBlock, raw.size() - offset);
+            bool final = offset + length == raw.size();
+            zlib.push_back(final ? 1 : 0);
+            zlib.push_back(static_cast<uint8_t>(length));
+            zlib.push_back(static_cast<uint8_t>(length >> 8));
+            zlib.push_back(static_cast<uint8_t>(~length));
+            zlib.push_back(static_cast<uint8_t>(~length >> 8));
+            zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + length);
+
+            // Adler-32, reduced once per block (64-bit sums can't overflow within one)
+            for (size_t i = offset; i < offset + length; ++i)
+            {
+                adlerA += raw[i];
+                adlerB += adlerA;
+            }
+            adlerA %= 65521;
+            adlerB %= 65521;
+
+            offset += length;
+        } while (offset < raw.size());
+        putBE32(zlib, static_cast<uint32_t>((adlerB << 16) | adlerA));
+
+        std::vector<uint8_t> header;
+        putBE32(header, width);
+        putBE32(header, height);
+        header.push_back(8); // Bit depth
+        header.push_back(6); // Color type: RGBA
+        header.push_back(0); // Compression: deflate
+        header.push_back(0); // Filter method
+        header.push_back(0); // No interlacing
+
+        static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        std::vector<uint8_t> png(signature, signature + 8);
+        png.reserve(zlib.size() + 64);
+        putChunk(png, "IHDR", header);
+        putChunk(png, "IDAT", zlib);
+        putChunk(png, "IEND", {});
+        return png;
+    }
+
+    bool write(const std::string &path, uint32_t width, uint32_t height, const uint8_t *pixels, size_t rowPitch,
+               bool swapRedBlue)
+    {
+        std::vector<uint8_t> png = encode(width, height, pixels, rowPitch, swapRedBlue);
+        std::ofstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        file.write(reinterpret_cast<const char *>(png.data()), static_cast<std::streamsize>(png.size()));
+        return static_cast<bool>(file);
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Dependency-free PNG encoder for captured frames: 8-bit RGBA, no row filters and
+// stored (uncompressed) deflate blocks. Encoding is a copy plus two checksums, so it
+// keeps up with capture; files are as large as the raw pixels but open anywhere.
+namespace PngWriter
+{
+    // pixels: height rows of width 4-byte texels, rowPitch bytes apart.
+    // swapRedBlue converts BGRA input (the usual swapchain order) to RGBA.
+    std::vector<uint8_t> encode(uint32_t width, uint32_t height, const uint8_t *pixels, size_t rowPitch,
+                                bool swapRedBlue = false);
+
+    bool write(const std::string &path, uint32_t width, uint32_t height, const uint8_t *pixels, size_t rowPitch,
+               bool swapRedBlue = false);
+}
@@ -1,12 +1,74 @@
 #include "Primitive.h"
+#include <glm/glm.hpp>
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    constexpr float kTwoPi = 6.28318530718f;
+    constexpr float kPi = 3.14159265359f;
+
+    // Run fn(begin, end) over [0, count) split into contiguous chunks, one per hardware thread.
+    // Small workloads stay on the calling thread.
+    template <typename Fn>
+    void parallelFor(size_t count, Fn fn)
+    {
+        constexpr size_t kMinChunk = 16 * 1024;
+        size_t threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        threads = std::min(threads, (count + kMinChunk - 1) / kMinChunk);
+
+        if (threads <= 1)
+        {
+            fn(size_t(0), count);
+            return;
+        }
+
+        size_t chunk = (count + threads - 1) / threads;
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (size_t t = 1; t < threads; ++t)
+        {
+            size_t begin = std::min(count, t * chunk);
+            size_t end = std::min(count, begin + chunk);
+            workers.emplace_back(fn, begin, end);
+        }
+        fn(size_t(0), std::min(count, chunk));
+
+        for (auto &w : workers)
+            w.join();
+    }
+
+    void checkSpan(const VertexSpan &out, size_t expected)
+    {
+        if (!out.data || out.size != expected)
+            throw std::runtime_error("vertex span does not match the generator's vertex count!");
+    }
+
+    glm::vec3 normalColor(const glm::vec3 &n)
+    {
+        return n * 0.5f + glm::vec3(0.5f);
+    }
+
+    // Writes quad a-b-c-d as two triangles whose front face follows the caller's order
+    void writeQuad(Vertex *dst, const Vertex &a, const Vertex &b, const Vertex &c, const Vertex &d)
+    {
+        dst[0] = a;
+        dst[1] = b;
+        dst[2] = d;
+        dst[3] = b;
+        dst[4] = c;
+        dst[5] = d;
+    }
+}
 
 namespace Primitives
 {
     std::vector<Vertex> createCube()
     {
-        std::vector<Vertex> verts;
-        verts.reserve(36);
+        std::vector<Vertex> verts(36);
 
         std::array<glm::vec3, 8> positions = {
             glm::vec3(-0.5f, -0.5f, -0.5f), // 0
@@ -47,7 +109,7 @@ namespace Primitives
         for (size_t i = 0; i < 36; ++i)
         {
             uint32_t idx = idxs[i];
-            verts.push_back({positions[idx], colors[idx]});
+            verts[i] = {positions[idx], colors[idx]};
         }
 
         return verts;
@@ -61,4 +123,224 @@ namespace Primitives
             {{-0.5f, 0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}}  // blue
         };
     }
+
+    std::vector<Vertex> createSphere(uint32_t segments)
+    {
+        uint32_t rings = std::max(2u, segments / 2);
+        std::vector<Vertex> verts(sphereVertexCount(segments, rings));
+        generateSphere({verts.data(), verts.size()}, segments, rings);
+        return verts;
+    }
+
+    std::vector<Vertex> createPlane()
+    {
+        std::vector<Vertex> verts(gridVertexCount(1, 1));
+        generateGrid({verts.data(), verts.size()}, 1, 1);
+        return verts;
+    }
+
+    std::vector<QuantizedVertex> quantize(const std::vector<Vertex> &vertices, float &scale)
+    {
+        scale = 0.0f;
+        for (const auto &v : vertices)
+            scale = std::max({scale, std::abs(v.pos.x), std::abs(v.pos.y), std::abs(v.pos.z)});
+        if (scale == 0.0f)
+            scale = 1.0f;
+
+        auto toSnorm = [scale](float x)
+        { return static_cast<int16_t>(std::lround(std::clamp(x / scale, -1.0f, 1.0f) * 32767.0f)); };
+        auto toUnorm = [](float x)
+        { return static_cast<uint8_t>(std::lround(std::clamp(x, 0.0f, 1.0f) * 255.0f)); };
+
+        std::vector<QuantizedVertex> out(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i)
+        {
+            const Vertex &v = vertices[i];
+            out[i] = {{toSnorm(v.pos.x), toSnorm(v.pos.y), toSnorm(v.pos.z), 0},
+                      {toUnorm(v.color.x), toUnorm(v.color.y), toUnorm(v.color.z), 255}};
+        }
+        return out;
+    }
+
+    size_t sphereVertexCount(uint32_t segments, uint32_t rings)
+    {
+        if (segments < 3 || rings < 2)
+            return 0;
+        // Pole rings are triangle fans, the rest are quads
+        return size_t(segments) * 3 * 2 + size_t(segments) * (rings - 2) * 6;
+    }
+
+    size_t gridVertexCount(uint32_t cellsX, uint32_t cellsZ)
+    {
+        return size_t(cellsX) * cellsZ * 6;
+    }
+
+    size_t cylinderVertexCount(uint32_t segments, uint32_t stacks)
+    {
+        if (segments < 3 || stacks < 1)
+            return 0;
+        return size_t(segments) * stacks * 6 + size_t(segments) * 3 * 2;
+    }
+
+    size_t torusVertexCount(uint32_t majorSegments, uint32_t minorSegments)
+    {
+        if (majorSegments < 3 || minorSegments < 3)
+            return 0;
+        return size_t(majorSegments) * minorSegments * 6;
+    }
+
+    void generateSphere(VertexSpan out, uint32_t segments, uint32_t rings, float radius)
+    {
+        checkSpan(out, sphereVertexCount(segments, rings));
+
+        auto point = [=](uint32_t ring, uint32_t seg)
+        {
+            float phi = kPi * static_cast<float>(ring) / static_cast<float>(rings);
+            float theta = kTwoPi * static_cast<float>(seg % segments) / static_cast<float>(segments);
+            glm::vec3 n(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+            return Vertex{n * radius, normalColor(n)};
+        };
+
+        const size_t capVerts = size_t(segments) * 3;
+        const size_t bodyBase = capVerts;
+        const size_t bottomBase = out.size - capVerts;
+
+        // One work item per ring cell; its output offset is known in closed form
+        parallelFor(size_t(segments) * rings, [&](size_t begin, size_t end)
+                    {
+            for (size_t cell = begin; cell < end; ++cell)
+            {
+                uint32_t ring = static_cast<uint32_t>(cell / segments);
+                uint32_t seg = static_cast<uint32_t>(cell % segments);
+
+                Vertex a = point(ring, seg);
+                Vertex b = point(ring, seg + 1);
+                Vertex c = point(ring + 1, seg + 1);
+                Vertex d = point(ring + 1, seg);
+
+                if (ring == 0)
+                {
+                    Vertex *dst = out.data + size_t(seg) * 3;
+                    dst[0] = b;
+                    dst[1] = c;
+                    dst[2] = d;
+                }
+                else if (ring == rings - 1)
+                {
+                    Vertex *dst = out.data + bottomBase + size_t(seg) * 3;
+                    dst[0] = a;
+                    dst[1] = b;
+                    dst[2] = d;
+                }
+                else
+                {
+                    writeQuad(out.data + bodyBase + (size_t(ring - 1) * segments + seg) * 6, a, b, c, d);
+                }
+            } });
+    }
+
+    void generateGrid(VertexSpan out, uint32_t cellsX, uint32_t cellsZ, float size)
+    {
+        checkSpan(out, gridVertexCount(cellsX, cellsZ));
+
+        const float stepX = size / static_cast<float>(cellsX);
+        const float stepZ = size / static_cast<float>(cellsZ);
+        const float origin = -0.5f * size;
+
+        auto point = [=](uint32_t x, uint32_t z)
+        {
+            float u = static_cast<float>(x) / static_cast<float>(cellsX);
+            float v = static_cast<float>(z) / static_cast<float>(cellsZ);
+            return Vertex{glm::vec3(origin + x * stepX, 0.0f, origin + z * stepZ), glm::vec3(u, 0.5f, v)};
+        };
+
+        // Facing +Y
+        parallelFor(size_t(cellsX) * cellsZ, [&](size_t begin, size_t end)
+                    {
+            for (size_t cell = begin; cell < end; ++cell)
+            {
+                uint32_t z = static_cast<uint32_t>(cell / cellsX);
+                uint32_t x = static_cast<uint32_t>(cell % cellsX);
+                writeQuad(out.data + cell * 6,
+                          point(x, z), point(x, z + 1), point(x + 1, z + 1), point(x + 1, z));
+            } });
+    }
+
+    void generateCylinder(VertexSpan out, uint32_t segments, uint32_t stacks, float radius, float height)
+    {
+        checkSpan(out, cylinderVertexCount(segments, stacks));
+
+        const float top = 0.5f * height;
+
+        auto ringPoint = [=](uint32_t seg, float y, const glm::vec3 &color)
+        {
+            float theta = kTwoPi * static_cast<float>(seg % segments) / static_cast<float>(segments);
+            return Vertex{glm::vec3(radius * std::cos(theta), y, radius * std::sin(theta)), color};
+        };
+        auto sidePoint = [=](uint32_t stack, uint32_t seg)
+        {
+            float theta = kTwoPi * static_cast<float>(seg % segments) / static_cast<float>(segments);
+            glm::vec3 n(std::cos(theta), 0.0f, std::sin(theta));
+            float y = top - height * static_cast<float>(stack) / static_cast<float>(stacks);
+            return ringPoint(seg, y, normalColor(n));
+        };
+
+        const size_t sideCells = size_t(segments) * stacks;
+        const size_t capBase = sideCells * 6;
+
+        // Side quads first, then one item per segment for both cap triangles
+        parallelFor(sideCells + segments, [&](size_t begin, size_t end)
+                    {
+            for (size_t item = begin; item < end; ++item)
+            {
+                if (item < sideCells)
+                {
+                    uint32_t stack = static_cast<uint32_t>(item / segments);
+                    uint32_t seg = static_cast<uint32_t>(item % segments);
+                    writeQuad(out.data + item * 6,
+                              sidePoint(stack, seg), sidePoint(stack, seg + 1),
+                              sidePoint(stack + 1, seg + 1), sidePoint(stack + 1, seg));
+                    continue;
+                }
+
+                uint32_t seg = static_cast<uint32_t>(item - sideCells);
+                const glm::vec3 up = normalColor(glm::vec3(0.0f, 1.0f, 0.0f));
+                const glm::vec3 down = normalColor(glm::vec3(0.0f, -1.0f, 0.0f));
+                Vertex *dst = out.data + capBase + size_t(seg) * 6;
+
+                dst[0] = Vertex{glm::vec3(0.0f, top, 0.0f), up};
+                dst[1] = ringPoint(seg + 1, top, up);
+                dst[2] = ringPoint(seg, top, up);
+
+                dst[3] = Vertex{glm::vec3(0.0f, -top, 0.0f), down};
+                dst[4] = ringPoint(seg, -top, down);
+                dst[5] = ringPoint(seg + 1, -top, down);
+            } });
+    }
+
+    void generateTorus(VertexSpan out, uint32_t majorSegments, uint32_t minorSegments,
+                       float majorRadius, float minorRadius)
+    {
+        checkSpan(out, torusVertexCount(majorSegments, minorSegments));
+
+        auto point = [=](uint32_t major, uint32_t minor)
+        {
+            float u = kTwoPi * static_cast<float>(major % majorSegments) / static_cast<float>(majorSegments);
+            float v = kTwoPi * static_cast<float>(minor % minorSegments) / static_cast<float>(minorSegments);
+            glm::vec3 n(std::cos(v) * std::cos(u), std::sin(v), std::cos(v) * std::sin(u));
+            glm::vec3 center(majorRadius * std::cos(u), 0.0f, majorRadius * std::sin(u));
+            return Vertex{center + n * minorRadius, normalColor(n)};
+        };
+
+        parallelFor(size_t(majorSegments) * minorSegments, [&](size_t begin, size_t end)
+                    {
+            for (size_t cell = begin; cell < end; ++cell)
+            {
+                uint32_t major = static_cast<uint32_t>(cell / minorSegments);
+                uint32_t minor = static_cast<uint32_t>(cell % minorSegments);
+                writeQuad(out.data + cell * 6,
+                          point(major, minor), point(major, minor + 1),
+                          point(major + 1, minor + 1), point(major + 1, minor));
+            } });
+    }
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <glm/vec3.hpp>
 #include <vector>
 #include <array>
+#include <cstddef>
+#include <cstdint>
 
 struct Vertex
 {
@@ -35,11 +37,54 @@ struct Vertex
     }
 };
 
+// Compact vertex for pipelines built with ShaderFeatureQuantizedPositions: snorm16
+// positions (scaled by PipelineDesc::positionScale in the shader) and unorm8 color
+struct QuantizedVertex
+{
+    int16_t pos[4]; // xyz plus padding for a 4-byte aligned attribute
+    uint8_t color[4];
+
+    static vk::VertexInputBindingDescription binding()
+    {
+        return vk::VertexInputBindingDescription(0, sizeof(QuantizedVertex), vk::VertexInputRate::eVertex);
+    }
+
+    static std::array<vk::VertexInputAttributeDescription, 2> attributes()
+    {
+        return {vk::VertexInputAttributeDescription(0, 0, vk::Format::eR16G16B16A16Snorm, offsetof(QuantizedVertex, pos)),
+                vk::VertexInputAttributeDescription(1, 0, vk::Format::eR8G8B8A8Unorm, offsetof(QuantizedVertex, color))};
+    }
+};
+
+// Non-owning view of vertex storage, typically a mapped staging buffer
+struct VertexSpan
+{
+    Vertex *data = nullptr;
+    size_t size = 0;
+};
+
 namespace Primitives
 {
     std::vector<Vertex> createCube();
     std::vector<Vertex> createTriangle();
-    // Add more primitives as needed
-    // std::vector<Vertex> createSphere(uint32_t segments);
-    // std::vector<Vertex> createPlane();
+    std::vector<Vertex> createSphere(uint32_t segments);
+    std::vector<Vertex> createPlane();
+
+    // Quantizes to snorm16 relative to the largest absolute coordinate, returned in scale
+    std::vector<QuantizedVertex> quantize(const std::vector<Vertex> &vertices, float &scale);
+
+    // Exact vertex counts of the parametric generators (non-indexed triangle lists)
+    size_t sphereVertexCount(uint32_t segments, uint32_t rings);
+    size_t gridVertexCount(uint32_t cellsX, uint32_t cellsZ);
+    size_t cylinderVertexCount(uint32_t segments, uint32_t stacks);
+    size_t torusVertexCount(uint32_t majorSegments, uint32_t minorSegments);
+
+    // Parametric generators. `out.size` must equal the matching *VertexCount();
+    // large outputs are filled in parallel chunks straight into `out`.
+    void generateSphere(VertexSpan out, uint32_t segments, uint32_t rings, float radius = 0.5f);
+    void generateGrid(VertexSpan out, uint32_t cellsX, uint32_t cellsZ, float size = 1.0f);
+    void generateCylinder(VertexSpan out, uint32_t segments, uint32_t stacks,
+                          float radius = 0.5f, float height = 1.0f);
+    void generateTorus(VertexSpan out, uint32_t majorSegments, uint32_t minorSegments,
+                       float majorRadius = 0.35f, float minorRadius = 0.15f);
 }
\ No newline at end of file
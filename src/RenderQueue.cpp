@@ -0,0 +1,315 @@
+#include "RenderQueue.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "GameObject.h"
+#include "../vulkan/VulkanFrameRing.h"
+#include "../vulkan/VulkanOcclusionCuller.h"
+#include "../vulkan/VulkanDebug.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // FNV-1a over 64-bit words
+    uint64_t mix(uint64_t hash, uint64_t value)
+    {
+        return (hash ^ value) * 0x100000001b3ull;
+    }
+}
+
+void RenderQueue::build(const std::vector<GameObject *> &objects, const CameraData &camera,
+                        const std::vector<uint32_t> *objectIndices)
+{
+    items.clear();
+    batches.clear();
+    pipelines.clear();
+    visible.clear();
+    pipelineOf.clear();
+
+    // Projected size of a bounding sphere is radius * proj[1][1] / distance (fraction of viewport height)
+    const glm::vec3 cameraPos = glm::vec3(glm::inverse(camera.view)[3]);
+    const float projScale = std::abs(camera.proj[1][1]);
+
+    uint32_t lastPipeline = 0;
+    const size_t candidates = objectIndices ? objectIndices->size() : objects.size();
+    for (size_t n = 0; n < candidates; ++n)
+    {
+        const size_t objectIndex = objectIndices ? (*objectIndices)[n] : n;
+        GameObject *obj = objects[objectIndex];
+        if (!obj || !obj->enabled || !obj->mesh || !obj->material)
+            continue;
+
+        // Few distinct pipelines per frame: a cached linear lookup beats hashing
+        vk::Pipeline pipeline = obj->material->getPipeline();
+        if (pipelines.empty() || pipelines[lastPipeline].pipeline != pipeline)
+        {
+            auto found = std::find_if(pipelines.begin(), pipelines.end(),
+                                      [pipeline](const DrawBatch &b)
+                                      { return b.pipeline == pipeline; });
+            if (found == pipelines.end())
+            {
+                DrawBatch batch;
+                batch.pipeline = pipeline;
+                batch.layout = obj->material->getLayout();
+                pipelines.push_back(batch);
+                found = pipelines.end() - 1;
+            }
+            lastPipeline = static_cast<uint32_t>(found - pipelines.begin());
+        }
+        ++pipelines[lastPipeline].itemCount;
+
+        const Mesh &mesh = *obj->mesh;
+        uint32_t lod = obj->lod;
+        if (mesh.getLodCount() > 1)
+        {
+            const Transform &t = obj->transform;
+            float radius = mesh.getBoundingRadius() * std::max(t.scale.x, std::max(t.scale.y, t.scale.z));
+            float distance = std::max(glm::length(t.position - cameraPos), 1e-3f);
+            lod = mesh.selectLod(radius * projScale / distance, obj->lod);
+            if (lodOwner)
+                obj->lod = lod;
+        }
+
+        DrawItem item;
+        item.object = obj;
+        item.lod = std::min(lod, mesh.getLodCount() - 1);
+        item.objectIndex = static_cast<uint32_t>(objectIndex);
+        visible.push_back(item);
+        pipelineOf.push_back(lastPipeline);
+    }
+
+    if (sortingEnabled)
+        sortByKey(camera);
+    else
+        groupByPipeline();
+    groups.clear();
+    if (gpuCulling)
+        buildIndirectGroups();
+    computeSignature();
+}
+
+void RenderQueue::buildIndirectGroups()
+{
+    // Sorting puts material and mesh right after the pipeline, so runs are long
+    for (const DrawBatch &batch : batches)
+    {
+        for (uint32_t i = batch.firstItem; i < batch.firstItem + batch.itemCount; ++i)
+        {
+            const GameObject &obj = *items[i].object;
+            if (i == batch.firstItem || obj.mesh != items[i - 1].object->mesh ||
+                obj.material->getMaterialId() != items[i - 1].object->material->getMaterialId())
+            {
+                IndirectGroup group;
+                group.firstItem = i;
+                groups.push_back(group);
+            }
+            IndirectGroup &group = groups.back();
+            ++group.itemCount;
+            group.triangles += obj.mesh->getTriangleCount(items[i].lod);
+            group.trianglesFullDetail += obj.mesh->getTriangleCount(0);
+        }
+    }
+}
+
+void RenderQueue::computeSignature()
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const DrawBatch &batch : batches)
+    {
+        hash = mix(hash, reinterpret_cast<uint64_t>(static_cast<VkPipeline>(batch.pipeline)));
+        hash = mix(hash, reinterpret_cast<uint64_t>(static_cast<VkPipelineLayout>(batch.layout)));
+        hash = mix(hash, batch.itemCount);
+    }
+    for (const DrawItem &item : items)
+    {
+        hash = mix(hash, item.object->mesh->getId());
+        hash = mix(hash, static_cast<uint64_t>(item.lod) << 32 | item.object->material->getMaterialId());
+        if (indexByObject)
+            hash = mix(hash, item.objectIndex);
+    }
+    signature = hash;
+}
+
+void RenderQueue::groupByPipeline()
+{
+    // Counting sort of the visible draws into contiguous per-pipeline ranges
+    cursors.resize(pipelines.size());
+    uint32_t first = 0;
+    for (size_t p = 0; p < pipelines.size(); ++p)
+    {
+        pipelines[p].firstItem = first;
+        cursors[p] = first;
+        first += pipelines[p].itemCount;
+    }
+
+    items.resize(visible.size());
+    for (size_t i = 0; i < visible.size(); ++i)
+        items[cursors[pipelineOf[i]]++] = visible[i];
+
+    batches = pipelines;
+}
+
+void RenderQueue::sortByKey(const CameraData &camera)
+{
+    sortEntries.resize(visible.size());
+    for (size_t i = 0; i < visible.size(); ++i)
+    {
+        const GameObject &obj = *visible[i].object;
+        float viewDepth = -(camera.view * glm::vec4(obj.transform.position, 1.0f)).z;
+
+        DrawSortKey::Entry &entry = sortEntries[i];
+        entry.index = static_cast<uint32_t>(i);
+        entry.key = DrawSortKey::make(obj.layer,
+                                      pipelineOf[i],
+                                      obj.material->getMaterialId(),
+                                      obj.mesh->getId(),
+                                      DrawSortKey::quantizeDepth(viewDepth));
+    }
+
+    DrawSortKey::radixSort(sortEntries, sortScratch);
+
+    // Sorted order, split into batches wherever the pipeline changes
+    items.resize(visible.size());
+    for (size_t i = 0; i < sortEntries.size(); ++i)
+    {
+        uint32_t source = sortEntries[i].index;
+        items[i] = visible[source];
+
+        const DrawBatch &pipeline = pipelines[pipelineOf[source]];
+        if (batches.empty() || batches.back().pipeline != pipeline.pipeline)
+        {
+            DrawBatch batch;
+            batch.pipeline = pipeline.pipeline;
+            batch.layout = pipeline.layout;
+            batch.firstItem = static_cast<uint32_t>(i);
+            batches.push_back(batch);
+        }
+        ++batches.back().itemCount;
+    }
+}
+
+void RenderQueue::writeDrawData(DrawData *out) const
+{
+    for (size_t i = 0; i < items.size(); ++i)
+        out[i].model = items[i].object->transform.getMatrix();
+}
+
+void RenderQueue::writeCullData(CullData *out) const
+{
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        const DrawItem &item = items[i];
+        const Transform &t = item.object->transform;
+        const Mesh &mesh = *item.object->mesh;
+        const MeshLod &lod = mesh.getLod(item.lod);
+
+        float radius = mesh.getBoundingRadius() * std::max(t.scale.x, std::max(t.scale.y, t.scale.z));
+        out[i].sphere = glm::vec4(t.position, radius);
+        out[i].objectIndex = item.objectIndex;
+        out[i].vertexCount = lod.vertexCount;
+        out[i].firstVertex = lod.firstVertex;
+    }
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        for (uint32_t i = groups[g].firstItem; i < groups[g].firstItem + groups[g].itemCount; ++i)
+            out[i].group = static_cast<uint32_t>(g);
+    }
+}
+
+void RenderQueue::record(vk::CommandBuffer cmd,
+                         uint32_t setCount, const vk::DescriptorSet *sets,
+                         uint32_t dynamicOffsetCount, const uint32_t *dynamicOffsets,
+                         vk::Buffer indirectBuffer, vk::DeviceSize indirectOffset, vk::DeviceSize countOffset)
+{
+    stats = FrameStats();
+
+    const vk::ShaderStageFlags pushStages = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+    DrawPushConstants push;
+
+    // Vertex buffer bindings survive pipeline binds, so track the mesh across batches
+    const Mesh *boundMesh = nullptr;
+    uint32_t currentMaterial = UINT32_MAX;
+
+    if (indirectBuffer)
+    {
+        // GPU-culled: one indirect-count draw per group. The instanced permutation adds
+        // gl_InstanceIndex, which starts at the command's firstInstance (its item index).
+        push.drawIndex = 0;
+        size_t g = 0;
+        for (const DrawBatch &batch : batches)
+        {
+            VK_DEBUG_LABEL_SCOPE(cmd, "draw batch");
+            cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, batch.pipeline);
+            cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, batch.layout,
+                                   0, setCount, sets, dynamicOffsetCount, dynamicOffsets);
+            ++stats.pipelineBinds;
+
+            for (; g < groups.size() && groups[g].firstItem < batch.firstItem + batch.itemCount; ++g)
+            {
+                const IndirectGroup &group = groups[g];
+                const GameObject &obj = *items[group.firstItem].object;
+
+                push.materialId = obj.material->getMaterialId();
+                cmd.pushConstants(batch.layout, pushStages, 0, sizeof(DrawPushConstants), &push);
+                if (push.materialId != currentMaterial)
+                {
+                    currentMaterial = push.materialId;
+                    ++stats.materialChanges;
+                }
+                if (obj.mesh != boundMesh)
+                {
+                    obj.mesh->bind(cmd);
+                    boundMesh = obj.mesh;
+                    ++stats.meshBinds;
+                }
+
+                const vk::DeviceSize commands = indirectOffset + group.firstItem * sizeof(vk::DrawIndirectCommand);
+                cmd.drawIndirectCount(indirectBuffer, commands, indirectBuffer, countOffset + g * sizeof(uint32_t),
+                                      group.itemCount, sizeof(vk::DrawIndirectCommand));
+                ++stats.drawCalls;
+                stats.trianglesSubmitted += group.triangles;
+                stats.trianglesFullDetail += group.trianglesFullDetail;
+            }
+        }
+        return;
+    }
+
+    for (const DrawBatch &batch : batches)
+    {
+        VK_DEBUG_LABEL_SCOPE(cmd, "draw batch");
+
+        // Bind pipeline, frame data and the bindless tables once per batch
+        cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, batch.pipeline);
+        cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, batch.layout,
+                               0, setCount, sets, dynamicOffsetCount, dynamicOffsets);
+        ++stats.pipelineBinds;
+
+        for (uint32_t i = batch.firstItem; i < batch.firstItem + batch.itemCount; ++i)
+        {
+            const DrawItem &item = items[i];
+            const Mesh &mesh = *item.object->mesh;
+
+            push.drawIndex = indexByObject ? item.objectIndex : i;
+            push.materialId = item.object->material->getMaterialId();
+            cmd.pushConstants(batch.layout, pushStages, 0, sizeof(DrawPushConstants), &push);
+            if (push.materialId != currentMaterial)
+            {
+                currentMaterial = push.materialId;
+                ++stats.materialChanges;
+            }
+
+            if (&mesh != boundMesh)
+            {
+                mesh.bind(cmd);
+                boundMesh = &mesh;
+                ++stats.meshBinds;
+            }
+            mesh.draw(cmd, item.lod);
+
+            ++stats.drawCalls;
+            stats.trianglesSubmitted += mesh.getTriangleCount(item.lod);
+            stats.trianglesFullDetail += mesh.getTriangleCount(0);
+        }
+    }
+}
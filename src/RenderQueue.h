@@ -0,0 +1,154 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+#include <vector>
+#include "DrawSortKey.h"
+
+struct GameObject;
+struct CameraData;
+struct DrawData;
+struct CullData;
+
+// Counters for the most recently recorded frame
+struct FrameStats
+{
+    uint32_t drawCalls = 0;
+    uint64_t trianglesSubmitted = 0;
+    uint64_t trianglesFullDetail = 0; // What the same draws would cost at LOD 0
+
+    // State changes issued while recording
+    uint32_t pipelineBinds = 0;
+    uint32_t materialChanges = 0;
+    uint32_t meshBinds = 0;
+
+    // Filled by VulkanFrame when pipeline statistics queries are supported. The count
+    // lags a few frames behind (read back once the frame's fence has signalled);
+    // fragmentInvocations / viewportPixels approximates overdraw.
+    uint64_t fragmentInvocations = 0;
+    uint64_t viewportPixels = 0;
+
+    // Draws the GPU occlusion culler skipped (lags like fragmentInvocations). With culling
+    // each phase records one indirect-count draw per IndirectGroup, and the triangle
+    // counts above are upper bounds.
+    uint32_t occlusionCulled = 0;
+
+    void add(const FrameStats &other)
+    {
+        drawCalls += other.drawCalls;
+        trianglesSubmitted += other.trianglesSubmitted;
+        trianglesFullDetail += other.trianglesFullDetail;
+        pipelineBinds += other.pipelineBinds;
+        materialChanges += other.materialChanges;
+        meshBinds += other.meshBinds;
+    }
+};
+
+struct DrawItem
+{
+    GameObject *object = nullptr;
+    uint32_t lod = 0;
+    uint32_t objectIndex = 0; // Position in the list passed to build() (stable across frames)
+};
+
+// Consecutive items sharing one pipeline (a pipeline may span several batches
+// when its draws fall into different layers)
+struct DrawBatch
+{
+    vk::Pipeline pipeline;
+    vk::PipelineLayout layout;
+    uint32_t firstItem = 0;
+    uint32_t itemCount = 0;
+};
+
+// Consecutive items of one batch sharing material and mesh (GPU culling only). Each is one
+// vkCmdDrawIndirectCount: the culler compacts the surviving draws of items
+// [firstItem, firstItem + itemCount) to the front of that range and counts them.
+struct IndirectGroup
+{
+    uint32_t firstItem = 0;
+    uint32_t itemCount = 0;
+    uint64_t triangles = 0;           // If every item is drawn
+    uint64_t trianglesFullDetail = 0;
+};
+
+// CPU side of VulkanFrame::renderObjects: filters objects, picks LODs and orders the
+// visible draws, then records them. Storage is reused between frames.
+//
+// With sorting enabled every draw gets a DrawSortKey (layer, pipeline, material, mesh,
+// front-to-back depth) and the keys are radix sorted. Without it draws are only grouped
+// by pipeline in submission order, which is useful as a baseline for the stats.
+class RenderQueue
+{
+public:
+    // With objectIndices (a view's list from ViewVisibility) only those objects are
+    // visited, so a view that sees little costs little
+    void build(const std::vector<GameObject *> &objects, const CameraData &camera,
+               const std::vector<uint32_t> *objectIndices = nullptr);
+
+    void setSortingEnabled(bool enabled) { sortingEnabled = enabled; }
+    bool isSortingEnabled() const { return sortingEnabled; }
+
+    // Push each draw's object index instead of its item index, for draw data shared by
+    // several queues (ViewVisibility::writeDrawData)
+    void setIndexByObject(bool enabled) { indexByObject = enabled; }
+
+    // Draws are culled on the GPU (VulkanOcclusionCuller): build() also splits the items
+    // into IndirectGroups, and record() with an indirect buffer issues one indirect-count
+    // draw per group. Pipelines must use the instanced permutation, since the draw index
+    // arrives as firstInstance.
+    void setGpuCulling(bool enabled) { gpuCulling = enabled; }
+
+    // Whether build() stores the chosen LOD in GameObject::lod for next frame's hysteresis.
+    // Of several queues over the same objects only one (the main view) should.
+    void setLodOwner(bool owner) { lodOwner = owner; }
+
+    // One DrawData per item, in item order (the draw index pushed for each draw)
+    void writeDrawData(DrawData *out) const;
+
+    // One CullData per item, in item order (input of the GPU occlusion culler; needs GPU culling)
+    void writeCullData(CullData *out) const;
+
+    // Binds `sets` starting at set 0 once per batch and issues every draw.
+    // Vertex buffers are only rebound when the mesh changes. With an indirect buffer,
+    // group g draws up to itemCount vk::DrawIndirectCommands from
+    // indirectOffset + firstItem * 16, as many as the uint32 at countOffset + g * 4 in
+    // the same buffer says.
+    void record(vk::CommandBuffer cmd,
+                uint32_t setCount, const vk::DescriptorSet *sets,
+                uint32_t dynamicOffsetCount, const uint32_t *dynamicOffsets,
+                vk::Buffer indirectBuffer = {}, vk::DeviceSize indirectOffset = 0,
+                vk::DeviceSize countOffset = 0);
+
+    // Hash of everything record() issues (pipelines, meshes, LODs, materials, order) apart
+    // from its arguments; equal signatures record identical commands for equal arguments
+    uint64_t getSignature() const { return signature; }
+
+    size_t getDrawCount() const { return items.size(); }
+    const std::vector<DrawItem> &getItems() const { return items; }
+    const std::vector<DrawBatch> &getBatches() const { return batches; }
+    const std::vector<IndirectGroup> &getIndirectGroups() const { return groups; } // Empty without GPU culling
+    const FrameStats &getStats() const { return stats; }
+
+private:
+    std::vector<DrawItem> items;
+    std::vector<DrawBatch> batches;
+    std::vector<IndirectGroup> groups;
+    FrameStats stats;
+    uint64_t signature = 0;
+    bool sortingEnabled = true;
+    bool indexByObject = false;
+    bool gpuCulling = false;
+    bool lodOwner = true;
+
+    // Scratch reused by build()
+    std::vector<DrawBatch> pipelines; // Distinct pipelines, first-seen order
+    std::vector<DrawItem> visible;
+    std::vector<uint32_t> pipelineOf;
+    std::vector<uint32_t> cursors;
+    std::vector<DrawSortKey::Entry> sortEntries;
+    std::vector<DrawSortKey::Entry> sortScratch;
+
+    void groupByPipeline();
+    void sortByKey(const CameraData &camera);
+    void buildIndirectGroups();
+    void computeSignature();
+};
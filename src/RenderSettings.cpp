@@ -0,0 +1,61 @@
+#include "RenderSettings.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    // Unset keeps the default; "0", "off" and "false" disable, anything else enables
+    bool readFlag(const char *name, bool defaultValue)
+    {
+        const char *value = std::getenv(name);
+        if (!value || !*value)
+            return defaultValue;
+        return std::strcmp(value, "0") != 0 && std::strcmp(value, "off") != 0 && std::strcmp(value, "false") != 0;
+    }
+
+    uint32_t readUint(const char *name, uint32_t defaultValue)
+    {
+        const char *value = std::getenv(name);
+        if (!value || !*value)
+            return defaultValue;
+        char *end = nullptr;
+        unsigned long parsed = std::strtoul(value, &end, 10);
+        return (end && *end == '\0') ? static_cast<uint32_t>(parsed) : defaultValue;
+    }
+}
+
+RenderSettings RenderSettings::fromEnvironment()
+{
+    RenderSettings settings;
+    settings.sortDraws = readFlag("VULKAN_CUBE_SORT", settings.sortDraws);
+    settings.occlusionCulling = readFlag("VULKAN_CUBE_OCCLUSION", settings.occlusionCulling);
+    settings.msaaSamples = readUint("VULKAN_CUBE_MSAA", settings.msaaSamples);
+    if (const char *path = std::getenv("VULKAN_CUBE_GRAPH_DUMP"))
+        settings.graphDumpPath = path;
+    if (const char *dir = std::getenv("VULKAN_CUBE_CAPTURE"))
+        settings.captureDir = dir;
+    settings.captureRaw = readFlag("VULKAN_CUBE_CAPTURE_RAW", settings.captureRaw);
+    settings.captureInterval = readUint("VULKAN_CUBE_CAPTURE_EVERY", settings.captureInterval);
+    settings.validation = readFlag("VULKAN_CUBE_VALIDATION", settings.validation);
+    settings.debugLabels = readFlag("VULKAN_CUBE_DEBUG_LABELS", settings.debugLabels);
+    settings.memoryReport = readUint("VULKAN_CUBE_MEMORY_REPORT", settings.memoryReport);
+    settings.simulationRate = readUint("VULKAN_CUBE_SIM_HZ", settings.simulationRate);
+    if (settings.simulationRate == 0)
+        settings.simulationRate = 1;
+    settings.animatedInstances = readUint("VULKAN_CUBE_ANIMATED", settings.animatedInstances);
+    settings.particles = readUint("VULKAN_CUBE_PARTICLES", settings.particles);
+    if (const char *path = std::getenv("VULKAN_CUBE_SCENE"))
+        settings.scenePath = path;
+    if (const char *source = std::getenv("VULKAN_CUBE_STREAM"))
+        settings.streamSource = source;
+    settings.streamBudgetMB = readUint("VULKAN_CUBE_STREAM_BUDGET", settings.streamBudgetMB);
+    settings.prerecordDraws = readFlag("VULKAN_CUBE_PRERECORD", settings.prerecordDraws);
+    if (const char *device = std::getenv("VULKAN_CUBE_DEVICE"))
+        settings.device = device;
+    settings.views = readUint("VULKAN_CUBE_VIEWS", settings.views);
+    if (const char *dir = std::getenv("VULKAN_CUBE_SHADER_DIR"))
+        settings.shaderDir = dir;
+    settings.hud = readFlag("VULKAN_CUBE_HUD", settings.hud);
+    return settings;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Renderer feature toggles, read once at startup
+struct RenderSettings
+{
+    bool sortDraws = true;          // VULKAN_CUBE_SORT=0 records draws unsorted (baseline for the stats)
+    bool occlusionCulling = false;  // VULKAN_CUBE_OCCLUSION=1 enables two-phase GPU HiZ culling
+    uint32_t msaaSamples = 1;       // VULKAN_CUBE_MSAA=2/4/8 (clamped to device support; 1x with occlusion culling)
+    std::string graphDumpPath;      // VULKAN_CUBE_GRAPH_DUMP=<file> writes the render graph as Graphviz at exit
+    std::string captureDir;         // VULKAN_CUBE_CAPTURE=<dir> saves presented frames there without stalling
+    bool captureRaw = false;        // VULKAN_CUBE_CAPTURE_RAW=1 writes raw texels instead of PNG
+    uint32_t captureInterval = 1;   // VULKAN_CUBE_CAPTURE_EVERY=N captures every Nth frame
+    bool validation = true;         // VULKAN_CUBE_VALIDATION=0 skips the validation layers (debug builds only)
+    bool debugLabels = true;        // VULKAN_CUBE_DEBUG_LABELS=0 skips object names and command labels (debug builds only)
+    uint32_t memoryReport = 0;      // VULKAN_CUBE_MEMORY_REPORT=N prints GPU memory use every N seconds (0: at exit)
+    uint32_t simulationRate = 60;   // VULKAN_CUBE_SIM_HZ=N runs the simulation thread at N fixed ticks per second
+    uint32_t animatedInstances = 0; // VULKAN_CUBE_ANIMATED=N adds a grid of N cubes animated by a compute pass
+    uint32_t particles = 0;         // VULKAN_CUBE_PARTICLES=N adds GPU-simulated fountains with room for N particles
+    std::string scenePath;          // VULKAN_CUBE_SCENE=<file> loads a scene file (see vulkan_cube_scenegen) instead of the demo
+    std::string streamSource;       // VULKAN_CUBE_STREAM=<dir>|generate streams cells around a flying camera
+    uint32_t streamBudgetMB = 256;  // VULKAN_CUBE_STREAM_BUDGET=N caps streamed vertex data at N MB
+    bool prerecordDraws = false;    // VULKAN_CUBE_PRERECORD=1 replays scene draws from cached secondary command buffers
+    std::string device;             // VULKAN_CUBE_DEVICE=<index|name> overrides the scored GPU choice
+    uint32_t views = 1;             // VULKAN_CUBE_VIEWS=2..4 adds picture-in-picture views (1 with occlusion culling)
+    std::string shaderDir;          // VULKAN_CUBE_SHADER_DIR=<dir> loads .spv files found there instead of the embedded shaders
+    bool hud = false;               // VULKAN_CUBE_HUD=1 overlays frame times, draw/cull counts, state changes and GPU memory
+
+    static RenderSettings fromEnvironment();
+};
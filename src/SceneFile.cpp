@@ -0,0 +1,425 @@
+#include "SceneFile.h"
+#include "MeshSimplifier.h"
+#include "Primitive.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    constexpr char kMagic[4] = {'V', 'C', 'S', 'N'};
+    constexpr uint32_t kVersion = 1;
+
+    // Largest detail value a file may ask for: a 512 x 512 grid is about 1.5M vertices
+    constexpr uint32_t kMaxMeshDetail = 512;
+
+    // On-disk records: plain floats and uint32s, no padding, little-endian (as every
+    // platform we target is; the loader rejects files whose header doesn't match)
+    struct FileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t meshCount;
+        uint32_t materialCount;
+        uint32_t instanceCount;
+    };
+
+    struct MeshRecord
+    {
+        uint32_t type;
+        uint32_t detail[2];
+        uint32_t lodChain;
+    };
+
+    struct MaterialRecord
+    {
+        float baseColor[4];
+    };
+
+    struct InstanceRecord
+    {
+        uint32_t mesh;
+        uint32_t material;
+        float position[3];
+        float rotation[3];
+        float scale[3];
+        float angularVelocity[3];
+    };
+
+    static_assert(sizeof(FileHeader) == 20 && sizeof(MeshRecord) == 16 && sizeof(MaterialRecord) == 16 &&
+                      sizeof(InstanceRecord) == 56,
+                  "scene file records must not contain padding");
+
+    constexpr std::array<const char *, 7> kMeshTypeNames = {"cube", "triangle", "sphere", "plane",
+                                                            "grid", "cylinder", "torus"};
+
+    void store(float *dst, const glm::vec3 &v)
+    {
+        dst[0] = v.x;
+        dst[1] = v.y;
+        dst[2] = v.z;
+    }
+
+    glm::vec3 loadVec3(const float *src)
+    {
+        return glm::vec3(src[0], src[1], src[2]);
+    }
+
+    // Bytes between the read position and the end, or -1 when the stream can't seek
+    std::streamoff remainingBytes(std::istream &in)
+    {
+        const std::streampos position = in.tellg();
+        if (position == std::streampos(-1))
+            return -1;
+        in.seekg(0, std::ios::end);
+        const std::streampos end = in.tellg();
+        in.seekg(position);
+        if (!in || end == std::streampos(-1))
+            return -1;
+        return end - position;
+    }
+
+    // Counts come from the (untrusted) header: they are checked against the file size
+    // before anything is allocated for them
+    template <typename T>
+    void readRecords(std::istream &in, std::vector<T> &records, uint32_t count)
+    {
+        const uint64_t bytes = static_cast<uint64_t>(sizeof(T)) * count;
+        const std::streamoff remaining = remainingBytes(in);
+        if (remaining >= 0 && bytes > static_cast<uint64_t>(remaining))
+            throw std::runtime_error("scene file is truncated!");
+
+        records.clear();
+        if (remaining >= 0)
+        {
+            records.resize(count);
+            if (count > 0)
+                in.read(reinterpret_cast<char *>(records.data()), static_cast<std::streamsize>(bytes));
+        }
+        else
+        {
+            // Without a size to check against, grow only as records actually arrive
+            T record;
+            for (uint32_t i = 0; i < count && in.read(reinterpret_cast<char *>(&record), sizeof(T)); ++i)
+                records.push_back(record);
+        }
+        if (!in)
+            throw std::runtime_error("scene file is truncated!");
+    }
+
+    template <typename T>
+    void writeRecords(std::ostream &out, const std::vector<T> &records)
+    {
+        if (!records.empty())
+            out.write(reinterpret_cast<const char *>(records.data()), static_cast<std::streamsize>(sizeof(T) * records.size()));
+    }
+
+    void validate(const SceneDescription &scene)
+    {
+        for (const SceneMesh &mesh : scene.meshes)
+        {
+            if (static_cast<uint32_t>(mesh.type) >= kMeshTypeNames.size())
+                throw std::runtime_error("scene file has an unknown mesh type!");
+            if (mesh.detail[0] > kMaxMeshDetail || mesh.detail[1] > kMaxMeshDetail)
+                throw std::runtime_error("scene mesh detail is out of range!");
+        }
+        for (const SceneInstance &instance : scene.instances)
+            if (instance.mesh >= scene.meshes.size() || instance.material >= scene.materials.size())
+                throw std::runtime_error("scene instance references a missing mesh or material!");
+    }
+
+    SceneMeshType parseMeshType(const std::string &name)
+    {
+        for (size_t i = 0; i < kMeshTypeNames.size(); ++i)
+            if (name == kMeshTypeNames[i])
+                return static_cast<SceneMeshType>(i);
+        throw std::runtime_error("unknown mesh type '" + name + "' in scene file!");
+    }
+}
+
+SceneDescription SceneFile::load(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        throw std::runtime_error("failed to open scene file " + path + "!");
+
+    char magic[4] = {};
+    in.read(magic, sizeof(magic));
+    const bool binary = in.gcount() == sizeof(magic) && std::memcmp(magic, kMagic, sizeof(magic)) == 0;
+    in.clear();
+    in.seekg(0);
+    return binary ? loadBinary(in) : loadText(in);
+}
+
+SceneDescription SceneFile::loadBinary(std::istream &in)
+{
+    FileHeader header;
+    in.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!in || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+        throw std::runtime_error("not a binary scene file!");
+    if (header.version != kVersion)
+        throw std::runtime_error("unsupported scene file version " + std::to_string(header.version) + "!");
+
+    std::vector<MeshRecord> meshRecords;
+    std::vector<MaterialRecord> materialRecords;
+    std::vector<InstanceRecord> instanceRecords;
+    readRecords(in, meshRecords, header.meshCount);
+    readRecords(in, materialRecords, header.materialCount);
+    readRecords(in, instanceRecords, header.instanceCount);
+
+    SceneDescription scene;
+    scene.meshes.reserve(meshRecords.size());
+    for (const MeshRecord &record : meshRecords)
+    {
+        SceneMesh mesh;
+        mesh.type = static_cast<SceneMeshType>(record.type);
+        mesh.detail[0] = record.detail[0];
+        mesh.detail[1] = record.detail[1];
+        mesh.lodChain = record.lodChain != 0;
+        scene.meshes.push_back(mesh);
+    }
+
+    scene.materials.reserve(materialRecords.size());
+    for (const MaterialRecord &record : materialRecords)
+    {
+        SceneMaterial material;
+        material.baseColor = glm::vec4(record.baseColor[0], record.baseColor[1], record.baseColor[2],
+                                       record.baseColor[3]);
+        scene.materials.push_back(material);
+    }
+
+    scene.instances.resize(instanceRecords.size());
+    for (size_t i = 0; i < instanceRecords.size(); ++i)
+    {
+        const InstanceRecord &record = instanceRecords[i];
+        SceneInstance &instance = scene.instances[i];
+        instance.mesh = record.mesh;
+        instance.material = record.material;
+        instance.transform.position = loadVec3(record.position);
+        instance.transform.rotation = loadVec3(record.rotation);
+        instance.transform.scale = loadVec3(record.scale);
+        instance.angularVelocity = loadVec3(record.angularVelocity);
+    }
+
+    validate(scene);
+    return scene;
+}
+
+SceneDescription SceneFile::loadText(std::istream &in)
+{
+    SceneDescription scene;
+    std::string line;
+    uint32_t lineNumber = 0;
+    while (std::getline(in, line))
+    {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string keyword;
+        if (!(fields >> keyword))
+            continue;
+
+        bool ok = true;
+        if (keyword == "mesh")
+        {
+            SceneMesh mesh;
+            std::string type;
+            ok = static_cast<bool>(fields >> type);
+            if (ok)
+                mesh.type = parseMeshType(type);
+
+            // Up to two detail values, optionally followed by "lod"
+            std::string token;
+            uint32_t details = 0;
+            while (ok && fields >> token)
+            {
+                std::istringstream number(token);
+                uint32_t value = 0;
+                if (token == "lod")
+                    mesh.lodChain = true;
+                else if (details < 2 && number >> value && number.eof())
+                    mesh.detail[details++] = value;
+                else
+                    ok = false;
+            }
+            scene.meshes.push_back(mesh);
+        }
+        else if (keyword == "material")
+        {
+            SceneMaterial material;
+            glm::vec4 &c = material.baseColor;
+            ok = static_cast<bool>(fields >> c.x >> c.y >> c.z >> c.w);
+            scene.materials.push_back(material);
+        }
+        else if (keyword == "instance")
+        {
+            SceneInstance instance;
+            Transform &t = instance.transform;
+            ok = static_cast<bool>(fields >> instance.mesh >> instance.material >> t.position.x >> t.position.y >>
+                                   t.position.z >> t.rotation.x >> t.rotation.y >> t.rotation.z >> t.scale.x >>
+                                   t.scale.y >> t.scale.z);
+            glm::vec3 &spin = instance.angularVelocity;
+            if (ok && fields >> spin.x)
+                ok = static_cast<bool>(fields >> spin.y >> spin.z);
+            scene.instances.push_back(instance);
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+            throw std::runtime_error("malformed scene file line " + std::to_string(lineNumber) + ": " + line);
+    }
+
+    validate(scene);
+    return scene;
+}
+
+void SceneFile::save(const SceneDescription &scene, const std::string &path, bool text)
+{
+    std::ofstream out(path, text ? std::ios::out : std::ios::out | std::ios::binary);
+    if (!out)
+        throw std::runtime_error("failed to create scene file " + path + "!");
+    if (text)
+        saveText(scene, out);
+    else
+        saveBinary(scene, out);
+    if (!out)
+        throw std::runtime_error("failed to write scene file " + path + "!");
+}
+
+void SceneFile::saveBinary(const SceneDescription &scene, std::ostream &out)
+{
+    FileHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.meshCount = static_cast<uint32_t>(scene.meshes.size());
+    header.materialCount = static_cast<uint32_t>(scene.materials.size());
+    header.instanceCount = static_cast<uint32_t>(scene.instances.size());
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    std::vector<MeshRecord> meshRecords;
+    meshRecords.reserve(scene.meshes.size());
+    for (const SceneMesh &mesh : scene.meshes)
+        meshRecords.push_back({static_cast<uint32_t>(mesh.type), {mesh.detail[0], mesh.detail[1]}, mesh.lodChain ? 1u : 0u});
+    writeRecords(out, meshRecords);
+
+    std::vector<MaterialRecord> materialRecords;
+    materialRecords.reserve(scene.materials.size());
+    for (const SceneMaterial &material : scene.materials)
+    {
+        const glm::vec4 &c = material.baseColor;
+        materialRecords.push_back({{c.x, c.y, c.z, c.w}});
+    }
+    writeRecords(out, materialRecords);
+
+    std::vector<InstanceRecord> instanceRecords(scene.instances.size());
+    for (size_t i = 0; i < scene.instances.size(); ++i)
+    {
+        const SceneInstance &instance = scene.instances[i];
+        InstanceRecord &record = instanceRecords[i];
+        record.mesh = instance.mesh;
+        record.material = instance.material;
+        store(record.position, instance.transform.position);
+        store(record.rotation, instance.transform.rotation);
+        store(record.scale, instance.transform.scale);
+        store(record.angularVelocity, instance.angularVelocity);
+    }
+    writeRecords(out, instanceRecords);
+}
+
+void SceneFile::saveText(const SceneDescription &scene, std::ostream &out)
+{
+    out << "# vulkan_cube scene: " << scene.meshes.size() << " meshes, " << scene.materials.size()
+        << " materials, " << scene.instances.size() << " instances\n";
+
+    // Enough digits to round-trip every float exactly
+    out.precision(9);
+
+    for (const SceneMesh &mesh : scene.meshes)
+    {
+        out << "mesh " << meshTypeName(mesh.type);
+        if (mesh.detail[0] != 0 || mesh.detail[1] != 0)
+            out << ' ' << mesh.detail[0] << ' ' << mesh.detail[1];
+        if (mesh.lodChain)
+            out << " lod";
+        out << '\n';
+    }
+
+    for (const SceneMaterial &material : scene.materials)
+    {
+        const glm::vec4 &c = material.baseColor;
+        out << "material " << c.x << ' ' << c.y << ' ' << c.z << ' ' << c.w << '\n';
+    }
+
+    for (const SceneInstance &instance : scene.instances)
+    {
+        const Transform &t = instance.transform;
+        const glm::vec3 &spin = instance.angularVelocity;
+        out << "instance " << instance.mesh << ' ' << instance.material << "  " << t.position.x << ' '
+            << t.position.y << ' ' << t.position.z << "  " << t.rotation.x << ' ' << t.rotation.y << ' '
+            << t.rotation.z << "  " << t.scale.x << ' ' << t.scale.y << ' ' << t.scale.z;
+        if (spin != glm::vec3(0.0f))
+            out << "  " << spin.x << ' ' << spin.y << ' ' << spin.z;
+        out << '\n';
+    }
+}
+
+const char *SceneFile::meshTypeName(SceneMeshType type)
+{
+    uint32_t index = static_cast<uint32_t>(type);
+    return index < kMeshTypeNames.size() ? kMeshTypeNames[index] : "unknown";
+}
+
+std::vector<std::vector<Vertex>> SceneFile::buildMesh(const SceneMesh &mesh)
+{
+    auto detail = [&mesh](int i, uint32_t fallback, uint32_t minimum)
+    { return std::max(mesh.detail[i] != 0 ? mesh.detail[i] : fallback, minimum); };
+
+    std::vector<Vertex> vertices;
+    switch (mesh.type)
+    {
+    case SceneMeshType::Cube:
+        vertices = Primitives::createCube();
+        break;
+    case SceneMeshType::Triangle:
+        vertices = Primitives::createTriangle();
+        break;
+    case SceneMeshType::Sphere:
+        vertices = Primitives::createSphere(detail(0, 32, 3));
+        break;
+    case SceneMeshType::Plane:
+        vertices = Primitives::createPlane();
+        break;
+    case SceneMeshType::Grid:
+    {
+        uint32_t x = detail(0, 8, 1), z = detail(1, x, 1);
+        vertices.resize(Primitives::gridVertexCount(x, z));
+        Primitives::generateGrid({vertices.data(), vertices.size()}, x, z);
+        break;
+    }
+    case SceneMeshType::Cylinder:
+    {
+        uint32_t segments = detail(0, 16, 3), stacks = detail(1, 1, 1);
+        vertices.resize(Primitives::cylinderVertexCount(segments, stacks));
+        Primitives::generateCylinder({vertices.data(), vertices.size()}, segments, stacks);
+        break;
+    }
+    case SceneMeshType::Torus:
+    {
+        uint32_t major = detail(0, 24, 3), minor = detail(1, 12, 3);
+        vertices.resize(Primitives::torusVertexCount(major, minor));
+        Primitives::generateTorus({vertices.data(), vertices.size()}, major, minor);
+        break;
+    }
+    }
+
+    if (mesh.lodChain)
+        return MeshSimplifier::buildLodChain(vertices);
+    return {vertices};
+}
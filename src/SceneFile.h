@@ -0,0 +1,77 @@
+#pragma once
+#include "GameObject.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+struct Vertex;
+
+// Meshes a scene can reference; all are generated procedurally at load time
+enum class SceneMeshType : uint32_t
+{
+    Cube,
+    Triangle,
+    Sphere,   // detail[0]: segments
+    Plane,
+    Grid,     // detail[0] x detail[1] cells
+    Cylinder, // detail[0]: segments, detail[1]: stacks
+    Torus     // detail[0]: major segments, detail[1]: minor segments
+};
+
+struct SceneMesh
+{
+    SceneMeshType type = SceneMeshType::Cube;
+    uint32_t detail[2] = {0, 0};
+    bool lodChain = false; // Build simplified LODs (worth it for dense meshes)
+};
+
+struct SceneMaterial
+{
+    glm::vec4 baseColor = glm::vec4(1.0f);
+};
+
+struct SceneInstance
+{
+    uint32_t mesh = 0;     // Index into SceneDescription::meshes
+    uint32_t material = 0; // Index into SceneDescription::materials
+    Transform transform;
+    glm::vec3 angularVelocity = glm::vec3(0.0f); // Degrees per second, run by the simulation
+};
+
+struct SceneDescription
+{
+    std::vector<SceneMesh> meshes;
+    std::vector<SceneMaterial> materials;
+    std::vector<SceneInstance> instances;
+};
+
+// Scene files come in two forms holding the same data:
+//
+//   binary  "VCSN" magic, a version and three counts, then fixed-size little-endian
+//           records (meshes, materials, instances). Loading is a few bulk reads, so a
+//           million instances load in a fraction of a second.
+//   text    one record per line, '#' starts a comment:
+//               mesh <cube|triangle|sphere|plane|grid|cylinder|torus> [detail0 [detail1]] [lod]
+//               material <r> <g> <b> <a>
+//               instance <mesh> <material> <px py pz> <rx ry rz> <sx sy sz> [<spin x y z>]
+//
+// load() tells them apart by the magic. Both throw std::runtime_error on malformed input,
+// including out-of-range mesh or material indices and mesh detail values above 512.
+namespace SceneFile
+{
+    SceneDescription load(const std::string &path);
+    SceneDescription loadBinary(std::istream &in);
+    SceneDescription loadText(std::istream &in);
+
+    void save(const SceneDescription &scene, const std::string &path, bool text = false);
+    void saveBinary(const SceneDescription &scene, std::ostream &out);
+    void saveText(const SceneDescription &scene, std::ostream &out);
+
+    const char *meshTypeName(SceneMeshType type);
+
+    // Vertices of a scene mesh: LOD 0, plus simplified levels with lodChain.
+    // Zero detail values pick a sensible default.
+    std::vector<std::vector<Vertex>> buildMesh(const SceneMesh &mesh);
+}
@@ -0,0 +1,145 @@
+#include "SceneGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace
+{
+    constexpr std::array<const char *, 4> kDistributionNames = {"grid", "uniform", "clusters", "shell"};
+    constexpr float kPi = 3.14159265358979f;
+
+    // SplitMix64: tiny, fast and identical everywhere
+    class Random
+    {
+    public:
+        explicit Random(uint64_t seed) : state(seed) {}
+
+        uint64_t next()
+        {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        // [0, 1) from the top 24 bits, exact in a float
+        float unit() { return static_cast<float>(next() >> 40) * (1.0f / 16777216.0f); }
+        float range(float lo, float hi) { return lo + (hi - lo) * unit(); }
+        uint32_t below(uint32_t n) { return static_cast<uint32_t>(next() % n); }
+
+        // Box-Muller; only one of the pair is used to keep the sequence simple
+        float normal()
+        {
+            float u = std::max(unit(), 1e-7f);
+            return std::sqrt(-2.0f * std::log(u)) * std::cos(2.0f * kPi * unit());
+        }
+
+    private:
+        uint64_t state;
+    };
+
+    // Fully saturated hue, softened towards white
+    glm::vec3 hueColor(float hue)
+    {
+        auto channel = [hue](float offset)
+        {
+            float c = std::clamp(std::abs(std::fmod(hue * 6.0f + offset, 6.0f) - 3.0f) - 1.0f, 0.0f, 1.0f);
+            return 0.3f + 0.7f * c;
+        };
+        return glm::vec3(channel(0.0f), channel(4.0f), channel(2.0f));
+    }
+
+    glm::vec3 place(SceneDistribution distribution, uint32_t index, const SceneGeneratorParams &params,
+                    float extent, const std::vector<glm::vec3> &centers, Random &random)
+    {
+        switch (distribution)
+        {
+        case SceneDistribution::Grid:
+        {
+            const uint32_t side = std::max(1u, static_cast<uint32_t>(std::ceil(std::cbrt(
+                                                   static_cast<double>(params.objectCount)))));
+            glm::vec3 cell(static_cast<float>(index % side), static_cast<float>((index / side) % side),
+                           static_cast<float>(index / (side * side)));
+            return (cell - 0.5f * static_cast<float>(side - 1)) * params.spacing;
+        }
+        case SceneDistribution::Clusters:
+        {
+            const glm::vec3 &center = centers[random.below(static_cast<uint32_t>(centers.size()))];
+            return center + glm::vec3(random.normal(), random.normal(), random.normal()) * (4.0f * params.spacing);
+        }
+        case SceneDistribution::Shell:
+        {
+            // Uniform direction, radius within the outer tenth of the shell
+            float z = random.range(-1.0f, 1.0f);
+            float angle = random.range(0.0f, 2.0f * kPi);
+            float r = std::sqrt(1.0f - z * z);
+            return glm::vec3(r * std::cos(angle), z, r * std::sin(angle)) * (extent * random.range(0.9f, 1.0f));
+        }
+        case SceneDistribution::Uniform:
+        default:
+            return glm::vec3(random.range(-0.5f, 0.5f), random.range(-0.5f, 0.5f), random.range(-0.5f, 0.5f)) * extent;
+        }
+    }
+}
+
+SceneDescription SceneGenerator::generate(const SceneGeneratorParams &params)
+{
+    SceneDescription scene;
+
+    // A handful of shared meshes; the dense ones get LOD chains
+    scene.meshes.push_back({SceneMeshType::Cube, {0, 0}, false});
+    scene.meshes.push_back({SceneMeshType::Sphere, {24, 0}, true});
+    scene.meshes.push_back({SceneMeshType::Torus, {24, 12}, true});
+    scene.meshes.push_back({SceneMeshType::Cylinder, {16, 1}, false});
+
+    const uint32_t materialCount = std::max(params.materialCount, 1u);
+    for (uint32_t i = 0; i < materialCount; ++i)
+        scene.materials.push_back({glm::vec4(hueColor(static_cast<float>(i) / static_cast<float>(materialCount)), 1.0f)});
+
+    // Side of the cube holding objectCount objects at the requested spacing
+    const float extent = params.spacing * std::cbrt(static_cast<float>(std::max(params.objectCount, 1u)));
+
+    Random random(params.seed);
+    std::vector<glm::vec3> centers;
+    if (params.distribution == SceneDistribution::Clusters)
+    {
+        const uint32_t clusterCount = std::max(1u, static_cast<uint32_t>(std::sqrt(static_cast<double>(params.objectCount)) / 4.0));
+        for (uint32_t i = 0; i < clusterCount; ++i)
+            centers.push_back(glm::vec3(random.range(-0.5f, 0.5f), random.range(-0.5f, 0.5f),
+                                        random.range(-0.5f, 0.5f)) * (2.0f * extent));
+    }
+
+    scene.instances.resize(params.objectCount);
+    for (uint32_t i = 0; i < params.objectCount; ++i)
+    {
+        SceneInstance &instance = scene.instances[i];
+        instance.mesh = random.below(static_cast<uint32_t>(scene.meshes.size()));
+        instance.material = random.below(materialCount);
+        instance.transform.position = place(params.distribution, i, params, extent, centers, random);
+        instance.transform.rotation = glm::vec3(random.range(0.0f, 360.0f), random.range(0.0f, 360.0f),
+                                                random.range(0.0f, 360.0f));
+        instance.transform.scale = glm::vec3(params.spacing * random.range(0.3f, 0.6f));
+        if (random.unit() < params.spinningFraction)
+            instance.angularVelocity = glm::vec3(random.range(-90.0f, 90.0f), random.range(-90.0f, 90.0f), 0.0f);
+    }
+    return scene;
+}
+
+const char *SceneGenerator::distributionName(SceneDistribution distribution)
+{
+    return kDistributionNames[static_cast<size_t>(distribution)];
+}
+
+bool SceneGenerator::parseDistribution(const std::string &name, SceneDistribution &distribution)
+{
+    for (size_t i = 0; i < kDistributionNames.size(); ++i)
+    {
+        if (name == kDistributionNames[i])
+        {
+            distribution = static_cast<SceneDistribution>(i);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "SceneFile.h"
+
+#include <cstdint>
+#include <string>
+
+enum class SceneDistribution
+{
+    Grid,     // Regular cubic lattice
+    Uniform,  // Uniformly random in a cube
+    Clusters, // Gaussian blobs around random centers (dense spots, lots of overlap)
+    Shell     // Spherical shell around the origin (everything at a similar distance)
+};
+
+struct SceneGeneratorParams
+{
+    uint32_t objectCount = 1000;
+    SceneDistribution distribution = SceneDistribution::Uniform;
+    uint32_t seed = 1;
+    float spacing = 1.5f;         // Average distance between neighbouring objects
+    uint32_t materialCount = 8;
+    float spinningFraction = 0.1f; // Share of objects given an angular velocity
+};
+
+// Reproducible stress scenes: the same parameters give the same scene with any standard
+// library (random numbers come from our own generator, not the standard distributions,
+// whose output is implementation-defined). Objects are spread over a few shared meshes
+// and materials so draw sorting and batching have something to work with.
+namespace SceneGenerator
+{
+    SceneDescription generate(const SceneGeneratorParams &params);
+
+    const char *distributionName(SceneDistribution distribution);
+    // False if the name matches no distribution
+    bool parseDistribution(const std::string &name, SceneDistribution &distribution);
+}
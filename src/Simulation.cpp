@@ -0,0 +1,157 @@
+#include "Simulation.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // After a stall (debugger, window drag) run at most this many ticks back to back,
+    // then drop the rest instead of spiralling further behind
+    constexpr uint32_t kMaxCatchUpTicks = 5;
+
+    Transform lerp(const Transform &a, const Transform &b, float t)
+    {
+        Transform result;
+        result.position = glm::mix(a.position, b.position, t);
+        result.rotation = glm::mix(a.rotation, b.rotation, t);
+        result.scale = glm::mix(a.scale, b.scale, t);
+        return result;
+    }
+
+    // Keep angles bounded; shift both ends of the interpolation so the lerp is unaffected
+    void wrapAngle(float &current, float &previous)
+    {
+        if (std::abs(current) < 360.0f)
+            return;
+        float shift = 360.0f * std::trunc(current / 360.0f);
+        current -= shift;
+        previous -= shift;
+    }
+
+    SimulationSnapshot initialSnapshot(const std::vector<SimulationBody> &bodies)
+    {
+        SimulationSnapshot snapshot;
+        for (const SimulationBody &body : bodies)
+            snapshot.current.push_back(body.transform);
+        snapshot.previous = snapshot.current;
+        return snapshot;
+    }
+}
+
+Simulation::Simulation(std::vector<SimulationBody> initialBodies, uint32_t ticksPerSecond)
+    : bodyCount(initialBodies.size()),
+      tickLength(std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(1.0 / static_cast<double>(std::max(ticksPerSecond, 1u))))),
+      bodies(std::move(initialBodies)),
+      snapshots(initialSnapshot(bodies)) // All three buffers start sized, so publishing never allocates
+{
+    previous = snapshots.read().current;
+}
+
+Simulation::~Simulation()
+{
+    stop();
+}
+
+void Simulation::start()
+{
+    if (running.exchange(true))
+        return;
+    thread = std::thread(&Simulation::threadLoop, this);
+}
+
+void Simulation::stop()
+{
+    running = false;
+    if (thread.joinable())
+        thread.join();
+}
+
+void Simulation::threadLoop()
+{
+    Clock::time_point next = Clock::now() + tickLength;
+    const float dt = std::chrono::duration<float>(tickLength).count();
+
+    while (running.load(std::memory_order_relaxed))
+    {
+        Clock::time_point now = Clock::now();
+        if (now < next)
+        {
+            std::this_thread::sleep_until(next);
+            continue;
+        }
+
+        for (uint32_t catchUp = 0; next <= now && catchUp < kMaxCatchUpTicks; ++catchUp)
+        {
+            const bool moving = step(dt);
+
+            SimulationSnapshot &snapshot = snapshots.writeBuffer();
+            snapshot.previous = previous;
+            for (size_t i = 0; i < bodyCount; ++i)
+                snapshot.current[i] = bodies[i].transform;
+            snapshot.tick = ticks.fetch_add(1, std::memory_order_relaxed) + 1;
+            snapshot.tickTime = next;
+            snapshot.moving = moving;
+            snapshots.publish();
+
+            next += tickLength;
+        }
+
+        if (next <= now)
+        {
+            skipped.fetch_add(static_cast<uint64_t>((now - next) / tickLength) + 1, std::memory_order_relaxed);
+            next = now + tickLength;
+        }
+    }
+}
+
+bool Simulation::step(float dt)
+{
+    bool moving = false;
+    for (size_t i = 0; i < bodyCount; ++i)
+    {
+        SimulationBody &body = bodies[i];
+        previous[i] = body.transform;
+        body.transform.rotation += body.angularVelocity * dt;
+        moving |= body.angularVelocity != glm::vec3(0.0f);
+
+        wrapAngle(body.transform.rotation.x, previous[i].rotation.x);
+        wrapAngle(body.transform.rotation.y, previous[i].rotation.y);
+        wrapAngle(body.transform.rotation.z, previous[i].rotation.z);
+    }
+    return moving;
+}
+
+bool Simulation::interpolate(Clock::time_point now, std::vector<Transform> &out)
+{
+    if (snapshots.update())
+        ++snapshotsSeen;
+
+    const SimulationSnapshot &snapshot = snapshots.read();
+    lastSeenTick = snapshot.tick;
+
+    // At rest every alpha gives `current`, which out already holds once written
+    if (!snapshot.moving && outputSettled && out.size() == bodyCount)
+        return false;
+    outputSettled = !snapshot.moving;
+
+    // Rendering one tick behind: at the current tick's nominal time we show `previous`,
+    // one tick later `current`. Past that the simulation is late and we hold `current`.
+    float alpha = 1.0f;
+    if (snapshot.tick > 0)
+    {
+        alpha = std::chrono::duration<float>(now - snapshot.tickTime).count() /
+                std::chrono::duration<float>(tickLength).count();
+        alpha = std::clamp(alpha, 0.0f, 1.0f);
+    }
+
+    out.resize(bodyCount);
+    for (size_t i = 0; i < bodyCount; ++i)
+        out[i] = lerp(snapshot.previous[i], snapshot.current[i], alpha);
+    return true;
+}
+
+uint64_t Simulation::getUnseenSnapshots() const
+{
+    return lastSeenTick > snapshotsSeen ? lastSeenTick - snapshotsSeen : 0;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "GameObject.h"
+#include "TripleBuffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Per-object simulation state, owned by the simulation thread once it runs
+struct SimulationBody
+{
+    Transform transform;
+    glm::vec3 angularVelocity = glm::vec3(0.0f); // Degrees per second around x/y/z
+};
+
+// The two most recent ticks, so the renderer can interpolate between them
+struct SimulationSnapshot
+{
+    std::vector<Transform> previous;
+    std::vector<Transform> current;
+    uint64_t tick = 0;
+    std::chrono::steady_clock::time_point tickTime; // Nominal time of `current`
+    bool moving = false; // Some body differs between `previous` and `current`
+};
+
+// Fixed-timestep game logic on its own thread. Each tick advances the bodies and
+// publishes the previous and current transforms through a triple buffer; the render
+// thread picks up the newest snapshot whenever it starts a frame and interpolates, so
+// rendering runs one tick behind but is smooth at any frame rate. Neither thread waits
+// for the other: a slow frame skips snapshots, a slow tick repeats the last one.
+class Simulation
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Simulation(std::vector<SimulationBody> bodies, uint32_t ticksPerSecond);
+    ~Simulation();
+
+    Simulation(const Simulation &) = delete;
+    Simulation &operator=(const Simulation &) = delete;
+
+    void start();
+    void stop();
+
+    // Render thread: writes the state at `now` minus one tick into out (one per body).
+    // Returns false, leaving out as it is, when nothing has moved since the previous call
+    // (so out must be the same vector every time).
+    bool interpolate(Clock::time_point now, std::vector<Transform> &out);
+
+    size_t getBodyCount() const { return bodyCount; }
+    uint64_t getTickCount() const { return ticks.load(std::memory_order_relaxed); }
+    // Ticks dropped because the thread fell too far behind to catch up
+    uint64_t getSkippedTicks() const { return skipped.load(std::memory_order_relaxed); }
+    // Snapshots published but overwritten before the render thread saw them
+    uint64_t getUnseenSnapshots() const;
+
+private:
+    void threadLoop();
+    bool step(float dt); // Whether any body moved
+
+    const size_t bodyCount;
+    const Clock::duration tickLength;
+
+    // Touched only by the simulation thread (and by the constructor before it starts)
+    std::vector<SimulationBody> bodies;
+    std::vector<Transform> previous;
+
+    TripleBuffer<SimulationSnapshot> snapshots;
+    uint64_t snapshotsSeen = 0;  // Render thread
+    uint64_t lastSeenTick = 0;   // Render thread
+    bool outputSettled = false;  // Render thread: the last interpolate() wrote a snapshot at rest
+
+    std::atomic<uint64_t> ticks{0};
+    std::atomic<uint64_t> skipped{0};
+    std::atomic<bool> running{false};
+    std::thread thread;
+};
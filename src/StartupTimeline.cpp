@@ -0,0 +1,94 @@
+#include "StartupTimeline.h"
+
+#include <algorithm>
+#include <iomanip>
+
+StartupTimeline::StartupTimeline()
+    : origin(Clock::now()), mainThread(std::this_thread::get_id())
+{
+}
+
+StartupTimeline::Phase::Phase(StartupTimeline *timeline, std::string name)
+    : timeline(timeline), name(std::move(name)), start(Clock::now())
+{
+}
+
+StartupTimeline::Phase::Phase(Phase &&other) noexcept
+    : timeline(other.timeline), name(std::move(other.name)), start(other.start)
+{
+    other.timeline = nullptr;
+}
+
+StartupTimeline::Phase::~Phase()
+{
+    end();
+}
+
+void StartupTimeline::Phase::end()
+{
+    if (!timeline)
+        return;
+    timeline->record(Entry{std::move(name), start, Clock::now(), std::this_thread::get_id(), false});
+    timeline = nullptr;
+}
+
+StartupTimeline::Phase StartupTimeline::phase(std::string name)
+{
+    return Phase(this, std::move(name));
+}
+
+void StartupTimeline::mark(std::string name)
+{
+    const Clock::time_point now = Clock::now();
+    record(Entry{std::move(name), now, now, std::this_thread::get_id(), true});
+}
+
+double StartupTimeline::elapsedMs() const
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - origin).count();
+}
+
+void StartupTimeline::record(Entry entry)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.push_back(std::move(entry));
+}
+
+void StartupTimeline::report(std::ostream &out) const
+{
+    std::vector<Entry> sorted;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sorted = entries;
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Entry &a, const Entry &b) { return a.start < b.start; });
+
+    // Workers are numbered in order of their first entry
+    std::vector<std::thread::id> workers;
+    auto ms = [this](Clock::time_point t) { return std::chrono::duration<double, std::milli>(t - origin).count(); };
+
+    const std::ios::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+    out << "Startup timeline (ms):" << std::endl;
+    for (const Entry &entry : sorted)
+    {
+        std::string thread = "main";
+        if (entry.thread != mainThread)
+        {
+            auto it = std::find(workers.begin(), workers.end(), entry.thread);
+            if (it == workers.end())
+                it = workers.insert(workers.end(), entry.thread);
+            thread = "worker " + std::to_string(it - workers.begin() + 1);
+        }
+
+        out << "  " << std::setw(8) << ms(entry.start);
+        if (entry.instant)
+            out << "           ";
+        else
+            out << " +" << std::setw(8) << ms(entry.end) - ms(entry.start) << " ";
+        out << " [" << thread << "] " << entry.name << std::endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Wall-clock phases of application startup, recorded from any thread.
+//
+// Time zero is construction. A Phase spans its scope; events such as "first frame" are
+// instants. report() lists everything by start time with the thread that ran it, so
+// overlapping work (and the critical path to the first frame) is visible at a glance.
+class StartupTimeline
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    StartupTimeline();
+
+    class Phase
+    {
+    public:
+        ~Phase();
+        Phase(Phase &&other) noexcept;
+        Phase(const Phase &) = delete;
+        Phase &operator=(const Phase &) = delete;
+        Phase &operator=(Phase &&) = delete;
+
+        void end(); // Before the end of the scope
+
+    private:
+        friend class StartupTimeline;
+        Phase(StartupTimeline *timeline, std::string name);
+
+        StartupTimeline *timeline;
+        std::string name;
+        Clock::time_point start;
+    };
+
+    // Any thread
+    Phase phase(std::string name);
+    void mark(std::string name);
+
+    double elapsedMs() const;
+    void report(std::ostream &out) const;
+
+private:
+    struct Entry
+    {
+        std::string name;
+        Clock::time_point start;
+        Clock::time_point end; // == start for instants
+        std::thread::id thread;
+        bool instant = false;
+    };
+
+    void record(Entry entry);
+
+    const Clock::time_point origin;
+    const std::thread::id mainThread;
+    mutable std::mutex mutex;
+    std::vector<Entry> entries;
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Single-producer/single-consumer triple buffer. The writer fills writeBuffer() and
+// publish()es it; the reader calls update() to take the newest published buffer and
+// then reads it for as long as it likes. One atomic exchange per side, no locks, and
+// neither side ever waits: the writer always has a free buffer, and the reader keeps
+// the last one it took until something newer is published. Intermediate publishes
+// the reader never saw are simply overwritten.
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+    explicit TripleBuffer(const T &initial) : buffers{initial, initial, initial} {}
+
+    TripleBuffer(const TripleBuffer &) = delete;
+    TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+    // Writer side. The buffer holds stale data from an older publish, so overwrite all of it.
+    T &writeBuffer() { return buffers[writeIndex]; }
+    void publish()
+    {
+        uint8_t previous = middle.exchange(static_cast<uint8_t>(writeIndex | kFresh), std::memory_order_acq_rel);
+        writeIndex = previous & kIndexMask;
+    }
+
+    // Reader side. True if a newer buffer was taken; read() is stable until the next update().
+    bool update()
+    {
+        if ((middle.load(std::memory_order_relaxed) & kFresh) == 0)
+            return false;
+        uint8_t previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & kIndexMask;
+        return true;
+    }
+    const T &read() const { return buffers[readIndex]; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4; // Middle buffer was published after the reader's last update()
+
+    std::array<T, 3> buffers;
+
+    // Each index lives on its own cache line so the two threads never share one
+    alignas(64) std::atomic<uint8_t> middle{1};
+    alignas(64) uint8_t writeIndex = 0;
+    alignas(64) uint8_t readIndex = 2;
+};
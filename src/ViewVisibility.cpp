@@ -0,0 +1,81 @@
+#include "ViewVisibility.h"
+#include "Mesh.h"
+#include "GameObject.h"
+#include "../vulkan/VulkanFrameRing.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+Frustum Frustum::fromViewProj(const glm::mat4 &viewProj)
+{
+    // Rows of the matrix (glm is column-major)
+    const glm::mat4 m = glm::transpose(viewProj);
+
+    Frustum frustum;
+    frustum.planes[0] = m[3] + m[0]; // Left
+    frustum.planes[1] = m[3] - m[0]; // Right
+    frustum.planes[2] = m[3] + m[1]; // Bottom and top (swapped by the flipped y; culling doesn't care)
+    frustum.planes[3] = m[3] - m[1];
+    frustum.planes[4] = m[2];        // Near (0..1 depth)
+    frustum.planes[5] = m[3] - m[2]; // Far
+    for (glm::vec4 &plane : frustum.planes)
+        plane /= glm::length(glm::vec3(plane));
+    return frustum;
+}
+
+bool Frustum::intersectsSphere(const glm::vec3 &center, float radius) const
+{
+    for (const glm::vec4 &plane : planes)
+    {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            return false;
+    }
+    return true;
+}
+
+void ViewVisibility::update(const std::vector<GameObject *> &objects, const std::vector<glm::mat4> &viewProjs)
+{
+    if (viewProjs.size() > kMaxViews)
+        throw std::runtime_error("too many views for the visibility masks!");
+
+    frusta.clear();
+    for (const glm::mat4 &viewProj : viewProjs)
+        frusta.push_back(Frustum::fromViewProj(viewProj));
+
+    masks.resize(objects.size());
+    viewObjects.resize(frusta.size());
+    for (std::vector<uint32_t> &list : viewObjects)
+        list.clear();
+    visibleCount = 0;
+    testedCount = 0;
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        const GameObject *obj = objects[i];
+        uint32_t mask = 0;
+        if (obj && obj->enabled && obj->mesh && obj->material)
+        {
+            const Transform &t = obj->transform;
+            const float radius = obj->mesh->getBoundingRadius() * std::max(t.scale.x, std::max(t.scale.y, t.scale.z));
+            for (size_t v = 0; v < frusta.size(); ++v)
+            {
+                if (frusta[v].intersectsSphere(t.position, radius))
+                {
+                    mask |= 1u << v;
+                    viewObjects[v].push_back(static_cast<uint32_t>(i));
+                }
+            }
+            ++testedCount;
+        }
+        masks[i] = mask;
+        visibleCount += mask != 0;
+    }
+}
+
+void ViewVisibility::writeDrawData(const std::vector<GameObject *> &objects, DrawData *out) const
+{
+    for (size_t i = 0; i < masks.size() && i < objects.size(); ++i)
+    {
+        if (masks[i] != 0)
+            out[i].model = objects[i]->transform.getMatrix();
+    }
+}
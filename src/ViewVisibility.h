@@ -0,0 +1,52 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+struct GameObject;
+struct DrawData;
+
+// Six planes (xyz normal pointing inside, w distance), extracted from a view-projection
+// matrix with 0..1 clip depth
+struct Frustum
+{
+    glm::vec4 planes[6];
+
+    static Frustum fromViewProj(const glm::mat4 &viewProj);
+    bool intersectsSphere(const glm::vec3 &center, float radius) const;
+};
+
+// The visibility pass shared by every view of a frame. update() walks the objects once:
+// each bounding sphere is computed once and tested against every view's frustum, giving
+// a mask per object with bit v set when view v may see it, and a list per view of the
+// objects it may see. The views then queue from their own lists only, and writeDrawData()
+// writes one matrix per object seen by any view, so overlapping views share both the
+// culling and the per-draw data.
+class ViewVisibility
+{
+public:
+    static constexpr uint32_t kMaxViews = 32; // Bits in a mask
+
+    void update(const std::vector<GameObject *> &objects, const std::vector<glm::mat4> &viewProjs);
+
+    // DrawData for object i at out[i], for the objects some view sees (others are left as they are)
+    void writeDrawData(const std::vector<GameObject *> &objects, DrawData *out) const;
+
+    const std::vector<uint32_t> &getMasks() const { return masks; }
+    // Indices of the objects view v may see, ascending
+    const std::vector<uint32_t> &getVisibleObjects(size_t view) const { return viewObjects[view]; }
+    uint32_t getVisibleCount() const { return visibleCount; } // Objects seen by at least one view
+
+    // Drawable objects outside view v's frustum
+    uint32_t getCulledCount(size_t view) const
+    {
+        return testedCount - static_cast<uint32_t>(viewObjects[view].size());
+    }
+
+private:
+    std::vector<uint32_t> masks;
+    std::vector<Frustum> frusta;
+    std::vector<std::vector<uint32_t>> viewObjects; // Capacity kept between frames
+    uint32_t visibleCount = 0;
+    uint32_t testedCount = 0; // Enabled, with a mesh and a material
+};
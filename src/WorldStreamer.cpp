@@ -0,0 +1,335 @@
+#include "WorldStreamer.h"
+#include "SceneGenerator.h"
+#include "Mesh.h"
+#include "GameObject.h"
+#include "VulkanUploader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+    uint32_t chebyshev(CellCoord a, CellCoord b)
+    {
+        return static_cast<uint32_t>(std::max(std::abs(a.x - b.x), std::abs(a.z - b.z)));
+    }
+}
+
+SceneDescription DirectoryCellSource::load(CellCoord cell)
+{
+    const std::string path = directory + "/cell_" + std::to_string(cell.x) + "_" + std::to_string(cell.z) + ".vcsn";
+    std::error_code error;
+    if (!std::filesystem::exists(path, error))
+        return SceneDescription();
+    return SceneFile::load(path);
+}
+
+GeneratedCellSource::GeneratedCellSource(float cellSize, uint32_t objectsPerCell, uint32_t seed)
+    : cellSize(cellSize), objectsPerCell(objectsPerCell), seed(seed)
+{
+}
+
+SceneDescription GeneratedCellSource::load(CellCoord cell)
+{
+    // Mix the coordinates into the seed so neighbouring cells look unrelated
+    uint64_t h = (static_cast<uint64_t>(static_cast<uint32_t>(cell.x)) << 32 | static_cast<uint32_t>(cell.z)) ^
+                 (static_cast<uint64_t>(seed) * 0x9e3779b97f4a7c15ull);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+
+    SceneGeneratorParams params;
+    params.objectCount = objectsPerCell;
+    params.distribution = SceneDistribution::Uniform;
+    params.seed = static_cast<uint32_t>(h);
+    params.spacing = cellSize / std::cbrt(static_cast<float>(std::max(objectsPerCell, 1u))); // Fills the cell
+    params.spinningFraction = 0.0f;
+
+    SceneDescription scene = SceneGenerator::generate(params);
+    for (SceneInstance &instance : scene.instances)
+        instance.transform.position.y *= 0.25f; // A slab rather than a cube
+    return scene;
+}
+
+WorldStreamer::WorldStreamer(const VulkanDevice &device, VulkanUploader &uploader, std::unique_ptr<CellSource> source,
+                             MaterialResolver resolveMaterial, const StreamingSettings &settings)
+    : deviceRef(device), uploader(uploader), source(std::move(source)), resolveMaterial(std::move(resolveMaterial)),
+      settings(settings)
+{
+    if (this->settings.cellSize <= 0.0f)
+        throw std::runtime_error("streaming cell size must be positive!");
+    this->settings.unloadRadius = std::max(this->settings.unloadRadius, this->settings.loadRadius);
+    budgetRadius = this->settings.loadRadius + 1;
+
+    for (uint32_t i = 0; i < std::max(this->settings.workerThreads, 1u); ++i)
+        workers.emplace_back(&WorldStreamer::workerLoop, this);
+}
+
+WorldStreamer::~WorldStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        queue.clear();
+    }
+    workAvailable.notify_all();
+
+    // A worker may be blocked on a full staging ring, which only drains when batches are submitted
+    for (;;)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (busyWorkers == 0)
+                break;
+        }
+        uploader.submit();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (std::thread &worker : workers)
+        worker.join();
+
+    // Nothing may still be copying into the meshes destroyed with the cells
+    uploader.submit();
+    uploader.waitIdle();
+}
+
+CellCoord WorldStreamer::cellAt(const glm::vec3 &position) const
+{
+    return CellCoord{static_cast<int32_t>(std::floor(position.x / settings.cellSize)),
+                     static_cast<int32_t>(std::floor(position.z / settings.cellSize))};
+}
+
+glm::vec3 WorldStreamer::cellCenter(CellCoord coord) const
+{
+    return glm::vec3((static_cast<float>(coord.x) + 0.5f) * settings.cellSize, 0.0f,
+                     (static_cast<float>(coord.z) + 0.5f) * settings.cellSize);
+}
+
+// Distance on the ground plane, with cells behind the camera weighted as if farther away
+float WorldStreamer::priority(CellCoord coord) const
+{
+    glm::vec3 offset = cellCenter(coord) - priorityOrigin;
+    offset.y = 0.0f;
+    float distance = glm::length(offset);
+    bool ahead = offset.x * priorityForward.x + offset.z * priorityForward.z >= 0.0f;
+    return ahead ? distance : 1.5f * distance;
+}
+
+void WorldStreamer::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;)
+    {
+        workAvailable.wait(lock, [this]() { return stopping || !queue.empty(); });
+        if (stopping)
+            return;
+
+        auto best = std::min_element(queue.begin(), queue.end(), [this](CellCoord a, CellCoord b)
+                                     { return priority(a) < priority(b); });
+        CellCoord coord = *best;
+        queue.erase(best);
+        ++busyWorkers;
+
+        lock.unlock();
+        std::unique_ptr<LoadedCell> loaded = loadCell(coord);
+        lock.lock();
+
+        --busyWorkers;
+        finished.push_back(std::move(loaded));
+    }
+}
+
+std::unique_ptr<WorldStreamer::LoadedCell> WorldStreamer::loadCell(CellCoord coord)
+{
+    auto loaded = std::make_unique<LoadedCell>();
+    loaded->coord = coord;
+    try
+    {
+        loaded->scene = source->load(coord);
+        for (const SceneMesh &sceneMesh : loaded->scene.meshes)
+        {
+            auto mesh = std::make_unique<Mesh>(deviceRef, uploader, SceneFile::buildMesh(sceneMesh));
+            loaded->ticket = std::max(loaded->ticket, mesh->getUploadTicket());
+            loaded->bytes += mesh->getSizeBytes();
+            loaded->meshes.push_back(std::move(mesh));
+        }
+    }
+    catch (const std::exception &e)
+    {
+        // Keep the meshes built so far: their uploads are in flight and retire with the cell
+        std::cerr << "Streaming cell (" << coord.x << ", " << coord.z << ") failed: " << e.what() << std::endl;
+        loaded->scene.instances.clear();
+    }
+    loaded->objectCount = static_cast<uint32_t>(loaded->scene.instances.size());
+    return loaded;
+}
+
+void WorldStreamer::evict(std::map<CellCoord, Cell>::iterator it, uint64_t frameNumber, Changes &changes)
+{
+    Cell &cell = it->second;
+    if (cell.state == CellState::Requested)
+    {
+        // Still queued, or a worker has it and update() will drop the result
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.erase(std::remove(queue.begin(), queue.end(), it->first), queue.end());
+    }
+    else
+    {
+        residentBytes -= cell.data->bytes;
+        residentObjects -= cell.data->objectCount;
+        for (const auto &object : cell.objects)
+            changes.removed.push_back(object.get());
+        ++stats.cellsEvicted;
+        retired.push_back(Retired{frameNumber + settings.retireFrames, std::move(cell.data), std::move(cell.objects)});
+    }
+    cells.erase(it);
+}
+
+WorldStreamer::Changes WorldStreamer::update(const glm::vec3 &cameraPosition, const glm::vec3 &cameraForward,
+                                             uint64_t frameNumber)
+{
+    Changes changes;
+
+    // Requested by reduceBudget(); applied here so only this thread touches the budget
+    if (budgetReductionRequested.exchange(false) && residentBytes > 0)
+    {
+        // (With nothing resident the pressure is someone else's memory; shrinking to
+        // nothing would stop streaming for good)
+        const uint64_t reduced = residentBytes - residentBytes / 4;
+        if (reduced < settings.memoryBudget)
+            settings.memoryBudget = reduced;
+    }
+
+    const CellCoord center = cellAt(cameraPosition);
+    if (!(center == cameraCell))
+    {
+        cameraCell = center;
+        budgetRadius = settings.loadRadius + 1; // Worth another try from the new position
+    }
+
+    std::vector<std::unique_ptr<LoadedCell>> done;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        priorityOrigin = cameraPosition;
+        priorityForward = cameraForward;
+        done.swap(finished);
+    }
+
+    // Built cells wait for their uploads; results for cells evicted meanwhile are thrown away
+    for (std::unique_ptr<LoadedCell> &loaded : done)
+    {
+        auto it = cells.find(loaded->coord);
+        if (it == cells.end() || it->second.state != CellState::Requested)
+        {
+            ++stats.cellsCancelled;
+            retired.push_back(Retired{frameNumber, std::move(loaded), {}});
+            continue;
+        }
+        residentBytes += loaded->bytes;
+        residentObjects += loaded->objectCount;
+        it->second.data = std::move(loaded);
+        it->second.state = CellState::Uploading;
+    }
+
+    for (auto &[coord, cell] : cells)
+    {
+        if (cell.state != CellState::Uploading || !uploader.isComplete(cell.data->ticket))
+            continue;
+
+        const SceneDescription &scene = cell.data->scene;
+        const glm::vec3 origin = cellCenter(coord);
+        cell.objects.reserve(scene.instances.size());
+        for (const SceneInstance &instance : scene.instances)
+        {
+            Transform transform = instance.transform;
+            transform.position += origin;
+            cell.objects.push_back(std::make_unique<GameObject>(cell.data->meshes[instance.mesh].get(),
+                                                                resolveMaterial(scene.materials[instance.material].baseColor),
+                                                                transform));
+            changes.added.push_back(cell.objects.back().get());
+        }
+        cell.data->scene = SceneDescription(); // The objects hold everything needed from here on
+        cell.state = CellState::Resident;
+        ++stats.cellsLoaded;
+    }
+
+    // Out of range
+    for (auto it = cells.begin(); it != cells.end();)
+    {
+        auto next = std::next(it);
+        if (chebyshev(it->first, cameraCell) > settings.unloadRadius)
+            evict(it, frameNumber, changes);
+        it = next;
+    }
+
+    // Over budget: drop the farthest built cells and stop requesting at that distance
+    while (residentBytes > settings.memoryBudget || residentObjects > settings.maxObjects)
+    {
+        auto farthest = cells.end();
+        for (auto it = cells.begin(); it != cells.end(); ++it)
+        {
+            if (it->second.state != CellState::Requested &&
+                (farthest == cells.end() || chebyshev(it->first, cameraCell) > chebyshev(farthest->first, cameraCell)))
+                farthest = it;
+        }
+        if (farthest == cells.end())
+            break;
+        budgetRadius = std::min(budgetRadius, chebyshev(farthest->first, cameraCell));
+        evict(farthest, frameNumber, changes);
+    }
+
+    // Missing cells in range, while there is budget left
+    if (residentBytes < settings.memoryBudget && residentObjects < settings.maxObjects)
+    {
+        const int32_t radius = static_cast<int32_t>(std::min(settings.loadRadius + 1, budgetRadius)) - 1;
+        std::vector<CellCoord> requests;
+        for (int32_t z = cameraCell.z - radius; z <= cameraCell.z + radius; ++z)
+        {
+            for (int32_t x = cameraCell.x - radius; x <= cameraCell.x + radius; ++x)
+            {
+                CellCoord coord{x, z};
+                if (cells.find(coord) == cells.end())
+                {
+                    cells[coord];
+                    requests.push_back(coord);
+                }
+            }
+        }
+        if (!requests.empty())
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.insert(queue.end(), requests.begin(), requests.end());
+            }
+            workAvailable.notify_all();
+        }
+    }
+
+    // Destroyed once no frame in flight draws them and nothing still copies into them
+    while (!retired.empty() && retired.front().frame <= frameNumber &&
+           uploader.isComplete(retired.front().data->ticket))
+        retired.pop_front();
+
+    return changes;
+}
+
+StreamingStats WorldStreamer::getStats() const
+{
+    StreamingStats result = stats;
+    for (const auto &entry : cells)
+    {
+        if (entry.second.state == CellState::Resident)
+            ++result.residentCells;
+        else
+            ++result.pendingCells;
+    }
+    result.residentObjects = residentObjects;
+    result.residentBytes = residentBytes;
+    result.memoryBudget = settings.memoryBudget;
+    return result;
+}
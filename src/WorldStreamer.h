@@ -0,0 +1,200 @@
+#pragma once
+#include "SceneFile.h"
+
+#include <glm/glm.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class VulkanDevice;
+class VulkanUploader;
+class Mesh;
+class Material;
+struct GameObject;
+
+// Cell (x, z) covers [x * cellSize, (x + 1) * cellSize) on the ground plane, any height
+struct CellCoord
+{
+    int32_t x = 0;
+    int32_t z = 0;
+
+    bool operator<(const CellCoord &other) const { return x != other.x ? x < other.x : z < other.z; }
+    bool operator==(const CellCoord &other) const { return x == other.x && z == other.z; }
+};
+
+// Where cell contents come from. load() runs on the streamer's worker threads and returns
+// the cell's scene with positions relative to the cell center; an empty scene is a valid
+// (empty) cell. Throwing std::runtime_error marks the cell empty after logging.
+class CellSource
+{
+public:
+    virtual ~CellSource() = default;
+    virtual SceneDescription load(CellCoord cell) = 0;
+};
+
+// <dir>/cell_<x>_<z>.vcsn (binary or text, see SceneFile); missing files are empty cells
+class DirectoryCellSource : public CellSource
+{
+public:
+    explicit DirectoryCellSource(std::string directory) : directory(std::move(directory)) {}
+    SceneDescription load(CellCoord cell) override;
+
+private:
+    std::string directory;
+};
+
+// An endless world of SceneGenerator cells, each seeded from its coordinates
+class GeneratedCellSource : public CellSource
+{
+public:
+    GeneratedCellSource(float cellSize, uint32_t objectsPerCell, uint32_t seed = 1);
+    SceneDescription load(CellCoord cell) override;
+
+private:
+    float cellSize;
+    uint32_t objectsPerCell;
+    uint32_t seed;
+};
+
+struct StreamingSettings
+{
+    float cellSize = 32.0f;
+    uint32_t loadRadius = 2;                         // Cells (Chebyshev distance) kept loaded around the camera
+    uint32_t unloadRadius = 3;                       // Loaded cells are dropped beyond this; > loadRadius avoids thrashing
+    uint64_t memoryBudget = 256ull * 1024 * 1024;    // Vertex bytes of resident and in-flight cells
+    uint32_t maxObjects = 65536;                     // Resident objects (each one costs frame ring space)
+    uint32_t workerThreads = 2;
+    uint32_t retireFrames = 4;                       // Frames an evicted cell's meshes outlive it (frames in flight + 1)
+};
+
+struct StreamingStats
+{
+    uint32_t residentCells = 0;
+    uint32_t pendingCells = 0; // Queued, loading or waiting for uploads
+    uint32_t residentObjects = 0;
+    uint64_t residentBytes = 0;
+    uint64_t memoryBudget = 0;
+    uint64_t cellsLoaded = 0;
+    uint64_t cellsEvicted = 0;
+    uint64_t cellsCancelled = 0; // Finished loading after they were no longer wanted
+};
+
+// Keeps the cells around the camera resident.
+//
+// update() runs on the render thread once per frame. It queues missing cells within
+// loadRadius, nearest first and those ahead of the camera before those behind; workers
+// pick the best queued cell whenever they are free, so priorities follow the camera even
+// for requests made frames ago. Workers read the cell, build its meshes and start their
+// uploads through the VulkanUploader without ever waiting on the GPU. A cell becomes
+// visible (its objects are reported in `added`) only once its uploads have completed,
+// so nothing is drawn from a half-written buffer. Cells beyond unloadRadius, or the
+// farthest ones when the memory or object budget is exceeded, are reported in `removed`
+// and their meshes destroyed retireFrames later, once no frame in flight can use them.
+//
+// Streamed objects are static; they are not part of the simulation.
+class WorldStreamer
+{
+public:
+    // Render thread: the material for a streamed color (the renderer caches and owns them)
+    using MaterialResolver = std::function<Material *(const glm::vec4 &baseColor)>;
+
+    struct Changes
+    {
+        std::vector<GameObject *> added;
+        std::vector<GameObject *> removed;
+    };
+
+    WorldStreamer(const VulkanDevice &device, VulkanUploader &uploader, std::unique_ptr<CellSource> source,
+                  MaterialResolver resolveMaterial, const StreamingSettings &settings = StreamingSettings());
+    ~WorldStreamer(); // Stops the workers; the caller must stop drawing removed objects first
+
+    WorldStreamer(const WorldStreamer &) = delete;
+    WorldStreamer &operator=(const WorldStreamer &) = delete;
+
+    // Render thread, once per frame, after the uploader's submit()
+    Changes update(const glm::vec3 &cameraPosition, const glm::vec3 &cameraForward, uint64_t frameNumber);
+
+    // Any thread (memory pressure callbacks): asks the next update() to shrink the budget
+    // to what is resident minus a quarter and evict down to it
+    void reduceBudget() { budgetReductionRequested = true; }
+
+    CellCoord cellAt(const glm::vec3 &position) const;
+    const StreamingSettings &getSettings() const { return settings; }
+    StreamingStats getStats() const;
+
+private:
+    enum class CellState
+    {
+        Requested, // Queued or being loaded by a worker
+        Uploading, // Built; waiting for the GPU copies
+        Resident
+    };
+
+    // Built by a worker, handed to the render thread
+    struct LoadedCell
+    {
+        CellCoord coord;
+        SceneDescription scene;
+        std::vector<std::unique_ptr<Mesh>> meshes;
+        uint64_t ticket = 0; // Upload ticket covering every mesh
+        uint64_t bytes = 0;
+        uint32_t objectCount = 0;
+    };
+
+    struct Cell
+    {
+        CellState state = CellState::Requested;
+        std::unique_ptr<LoadedCell> data;
+        std::vector<std::unique_ptr<GameObject>> objects;
+    };
+
+    struct Retired
+    {
+        uint64_t frame = 0; // Safe to destroy once frameNumber >= frame
+        std::unique_ptr<LoadedCell> data;
+        std::vector<std::unique_ptr<GameObject>> objects;
+    };
+
+    void workerLoop();
+    std::unique_ptr<LoadedCell> loadCell(CellCoord coord);
+    float priority(CellCoord coord) const; // Lower loads first; needs `mutex`
+    glm::vec3 cellCenter(CellCoord coord) const;
+    void evict(std::map<CellCoord, Cell>::iterator it, uint64_t frameNumber, Changes &changes);
+
+    const VulkanDevice &deviceRef;
+    VulkanUploader &uploader;
+    std::unique_ptr<CellSource> source;
+    MaterialResolver resolveMaterial;
+    StreamingSettings settings;
+
+    // Render thread only
+    std::map<CellCoord, Cell> cells;
+    std::deque<Retired> retired;
+    CellCoord cameraCell;
+    uint32_t budgetRadius = 0; // Cells at or beyond this are not requested (shrinks when over budget)
+    uint64_t residentBytes = 0; // Includes cells still uploading
+    uint32_t residentObjects = 0;
+    StreamingStats stats;
+
+    // Set by reduceBudget() from any thread, consumed by update()
+    std::atomic<bool> budgetReductionRequested{false};
+
+    // Shared with the workers
+    mutable std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::vector<CellCoord> queue;
+    std::vector<std::unique_ptr<LoadedCell>> finished;
+    glm::vec3 priorityOrigin = glm::vec3(0.0f); // Camera as of the last update()
+    glm::vec3 priorityForward = glm::vec3(0.0f, 0.0f, -1.0f);
+    uint32_t busyWorkers = 0;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+};
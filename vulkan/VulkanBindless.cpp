@@ -0,0 +1,165 @@
+#include "VulkanBindless.h"
+#include "VulkanDevice.h"
+#include "VulkanDebug.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+VulkanBindless::VulkanBindless(const VulkanDevice &device,
+                               uint32_t maxTextures,
+                               uint32_t maxMaterials)
+    : deviceRef(device), maxTextures(maxTextures), maxMaterials(maxMaterials)
+{
+    // Clamp the texture table to what the device allows for update-after-bind sets
+    vk::PhysicalDeviceVulkan12Properties props12;
+    vk::PhysicalDeviceProperties2 props;
+    props.pNext = &props12;
+    deviceRef.getPhysicalDevice().getProperties2(&props);
+
+    this->maxTextures = std::min({this->maxTextures,
+                                  props12.maxDescriptorSetUpdateAfterBindSampledImages,
+                                  props12.maxPerStageDescriptorUpdateAfterBindSampledImages});
+
+    createSampler();
+    createMaterialBuffer();
+    createDescriptors();
+}
+
+VulkanBindless::~VulkanBindless()
+{
+    auto device = deviceRef.getLogicalDevice();
+    if (descriptorPool)
+        device.destroyDescriptorPool(descriptorPool);
+    if (setLayout)
+        device.destroyDescriptorSetLayout(setLayout);
+    if (materialData)
+        device.unmapMemory(materialMemory);
+    if (materialBuffer)
+        device.destroyBuffer(materialBuffer);
+    deviceRef.freeMemory(materialMemory);
+    if (sampler)
+        device.destroySampler(sampler);
+}
+
+void VulkanBindless::createSampler()
+{
+    vk::SamplerCreateInfo samplerInfo;
+    samplerInfo.magFilter = vk::Filter::eLinear;
+    samplerInfo.minFilter = vk::Filter::eLinear;
+    samplerInfo.mipmapMode = vk::SamplerMipmapMode::eLinear;
+    samplerInfo.addressModeU = vk::SamplerAddressMode::eRepeat;
+    samplerInfo.addressModeV = vk::SamplerAddressMode::eRepeat;
+    samplerInfo.addressModeW = vk::SamplerAddressMode::eRepeat;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+
+    sampler = deviceRef.getLogicalDevice().createSampler(samplerInfo);
+    VK_DEBUG_NAME(deviceRef.getLogicalDevice(), sampler, "bindless sampler");
+}
+
+void VulkanBindless::createMaterialBuffer()
+{
+    auto device = deviceRef.getLogicalDevice();
+    vk::DeviceSize size = sizeof(MaterialParams) * maxMaterials;
+
+    vk::BufferCreateInfo bufferInfo({}, size, vk::BufferUsageFlagBits::eStorageBuffer, vk::SharingMode::eExclusive);
+    materialBuffer = device.createBuffer(bufferInfo);
+    VK_DEBUG_NAME(device, materialBuffer, "material table");
+
+    auto memReq = device.getBufferMemoryRequirements(materialBuffer);
+    uint32_t memoryType = deviceRef.findMemoryType(
+        memReq.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+    vk::MemoryAllocateInfo allocInfo(memReq.size, memoryType);
+    materialMemory = deviceRef.allocateMemory(allocInfo, MemoryCategory::FrameData);
+    device.bindBufferMemory(materialBuffer, materialMemory, 0);
+
+    materialData = static_cast<MaterialParams *>(device.mapMemory(materialMemory, 0, VK_WHOLE_SIZE));
+}
+
+void VulkanBindless::createDescriptors()
+{
+    auto device = deviceRef.getLogicalDevice();
+    const vk::ShaderStageFlags stages = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+
+    std::array<vk::DescriptorSetLayoutBinding, 3> bindings = {
+        vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eSampler, 1, stages),
+        vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageBuffer, 1, stages),
+        vk::DescriptorSetLayoutBinding(2, vk::DescriptorType::eSampledImage, maxTextures, stages)};
+
+    // Only the texture array is sparse and updated while in use; it must be the last binding
+    // because its size is chosen at allocation time (variable descriptor count)
+    std::array<vk::DescriptorBindingFlags, 3> bindingFlags = {
+        vk::DescriptorBindingFlags(),
+        vk::DescriptorBindingFlags(),
+        vk::DescriptorBindingFlagBits::ePartiallyBound |
+            vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+            vk::DescriptorBindingFlagBits::eVariableDescriptorCount};
+
+    vk::DescriptorSetLayoutBindingFlagsCreateInfo flagsInfo(static_cast<uint32_t>(bindingFlags.size()), bindingFlags.data());
+
+    vk::DescriptorSetLayoutCreateInfo layoutInfo(vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+                                                 static_cast<uint32_t>(bindings.size()), bindings.data());
+    layoutInfo.pNext = &flagsInfo;
+    setLayout = device.createDescriptorSetLayout(layoutInfo);
+    VK_DEBUG_NAME(device, setLayout, "bindless set layout");
+
+    std::array<vk::DescriptorPoolSize, 3> poolSizes = {
+        vk::DescriptorPoolSize(vk::DescriptorType::eSampler, 1),
+        vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, 1),
+        vk::DescriptorPoolSize(vk::DescriptorType::eSampledImage, maxTextures)};
+
+    vk::DescriptorPoolCreateInfo poolInfo(vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind, 1,
+                                          static_cast<uint32_t>(poolSizes.size()), poolSizes.data());
+    descriptorPool = device.createDescriptorPool(poolInfo);
+    VK_DEBUG_NAME(device, descriptorPool, "bindless pool");
+
+    vk::DescriptorSetVariableDescriptorCountAllocateInfo variableInfo(1, &maxTextures);
+    vk::DescriptorSetAllocateInfo allocInfo(descriptorPool, 1, &setLayout);
+    allocInfo.pNext = &variableInfo;
+    descriptorSet = device.allocateDescriptorSets(allocInfo)[0];
+    VK_DEBUG_NAME(device, descriptorSet, "bindless set");
+
+    vk::DescriptorImageInfo samplerInfo(sampler, nullptr, vk::ImageLayout::eUndefined);
+    vk::DescriptorBufferInfo materialInfo(materialBuffer, 0, VK_WHOLE_SIZE);
+
+    std::array<vk::WriteDescriptorSet, 2> writes = {
+        vk::WriteDescriptorSet(descriptorSet, 0, 0, 1, vk::DescriptorType::eSampler, &samplerInfo),
+        vk::WriteDescriptorSet(descriptorSet, 1, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &materialInfo)};
+
+    device.updateDescriptorSets(writes, nullptr);
+}
+
+uint32_t VulkanBindless::registerTexture(vk::ImageView view)
+{
+    if (textureCount >= maxTextures)
+        throw std::runtime_error("bindless texture table is full!");
+
+    uint32_t index = textureCount++;
+
+    // Update-after-bind: legal even while the set is bound in pending command buffers,
+    // as long as those never sample this slot
+    vk::DescriptorImageInfo imageInfo(nullptr, view, vk::ImageLayout::eShaderReadOnlyOptimal);
+    vk::WriteDescriptorSet write(descriptorSet, 2, index, 1, vk::DescriptorType::eSampledImage, &imageInfo);
+    deviceRef.getLogicalDevice().updateDescriptorSets(write, nullptr);
+
+    return index;
+}
+
+uint32_t VulkanBindless::registerMaterial(const MaterialParams &params)
+{
+    if (materialCount >= maxMaterials)
+        throw std::runtime_error("bindless material table is full!");
+
+    uint32_t id = materialCount++;
+    materialData[id] = params;
+    return id;
+}
+
+void VulkanBindless::updateMaterial(uint32_t materialId, const MaterialParams &params)
+{
+    if (materialId >= materialCount)
+        throw std::runtime_error("unknown material ID!");
+
+    materialData[materialId] = params;
+}
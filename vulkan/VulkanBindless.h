@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+#include <glm/glm.hpp>
+
+class VulkanDevice;
+
+// Shader-visible material record (must match set 1, binding 1 in shaders/cube.frag)
+struct MaterialParams
+{
+    glm::vec4 baseColor = glm::vec4(1.0f);
+    uint32_t textureIndex = 0;
+    uint32_t padding[3] = {0, 0, 0};
+};
+
+// Bindless descriptor set (set 1) shared by every material:
+//   binding 0: sampler used for all textures
+//   binding 1: storage buffer with one MaterialParams per material ID
+//   binding 2: update-after-bind array of sampled images, indexed by MaterialParams::textureIndex
+// Materials differ only by the ID pushed per draw, so they can share a single pipeline.
+class VulkanBindless
+{
+public:
+    VulkanBindless(const VulkanDevice &device,
+                   uint32_t maxTextures = 4096,
+                   uint32_t maxMaterials = 4096);
+    ~VulkanBindless();
+
+    VulkanBindless(const VulkanBindless &) = delete;
+    VulkanBindless &operator=(const VulkanBindless &) = delete;
+
+    // Image must stay in eShaderReadOnlyOptimal for as long as it is registered
+    uint32_t registerTexture(vk::ImageView view);
+    uint32_t registerMaterial(const MaterialParams &params);
+
+    // Writes straight into the mapped table; call between frames to avoid visible tearing
+    void updateMaterial(uint32_t materialId, const MaterialParams &params);
+
+    vk::DescriptorSetLayout getSetLayout() const { return setLayout; }
+    vk::DescriptorSet getDescriptorSet() const { return descriptorSet; }
+    uint32_t getTextureCount() const { return textureCount; }
+    uint32_t getMaterialCount() const { return materialCount; }
+
+private:
+    void createSampler();
+    void createMaterialBuffer();
+    void createDescriptors();
+
+    const VulkanDevice &deviceRef;
+
+    vk::Sampler sampler;
+    vk::Buffer materialBuffer;
+    vk::DeviceMemory materialMemory;
+    MaterialParams *materialData = nullptr;
+
+    vk::DescriptorSetLayout setLayout;
+    vk::DescriptorPool descriptorPool;
+    vk::DescriptorSet descriptorSet;
+
+    uint32_t maxTextures;
+    const uint32_t maxMaterials;
+    uint32_t textureCount = 0;
+    uint32_t materialCount = 0;
+};
@@ -1,5 +1,6 @@
 #include "VulkanCommand.h"
 #include "VulkanDevice.h"
+#include "VulkanDebug.h"
 
 VulkanCommand::VulkanCommand(const VulkanDevice &device, uint32_t maxFramesInFlight)
     : deviceRef(device)
@@ -29,6 +30,7 @@ void VulkanCommand::createCommandPool()
         graphicsFamily);
 
     commandPool = deviceRef.getLogicalDevice().createCommandPool(poolInfo);
+    VK_DEBUG_NAME(deviceRef.getLogicalDevice(), commandPool, "frame command pool");
 }
 
 void VulkanCommand::allocateCommandBuffers(uint32_t count)
@@ -39,4 +41,6 @@ void VulkanCommand::allocateCommandBuffers(uint32_t count)
         count);
 
     commandBuffers = deviceRef.getLogicalDevice().allocateCommandBuffers(allocInfo);
+    for (uint32_t i = 0; i < count; ++i)
+        VK_DEBUG_NAME(deviceRef.getLogicalDevice(), commandBuffers[i], "frame commands", i);
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "VulkanCommandCache.h"
+#include "VulkanDevice.h"
+#include "VulkanDebug.h"
+
+#include <stdexcept>
+
+VulkanCommandCache::VulkanCommandCache(const VulkanDevice &device, uint32_t maxFramesInFlight, uint32_t slotsPerFrame)
+    : deviceRef(device), slotsPerFrame(slotsPerFrame)
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    commandPool = dev.createCommandPool(vk::CommandPoolCreateInfo(vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+                                                                  deviceRef.getGraphicsQueueFamily()));
+    VK_DEBUG_NAME(dev, commandPool, "secondary command pool");
+
+    std::vector<vk::CommandBuffer> buffers = dev.allocateCommandBuffers(
+        vk::CommandBufferAllocateInfo(commandPool, vk::CommandBufferLevel::eSecondary, maxFramesInFlight * slotsPerFrame));
+    slots.resize(buffers.size());
+    for (size_t i = 0; i < buffers.size(); ++i)
+    {
+        slots[i].buffer = buffers[i];
+        VK_DEBUG_NAME(dev, buffers[i], "secondary commands", static_cast<uint32_t>(i));
+    }
+}
+
+VulkanCommandCache::~VulkanCommandCache()
+{
+    auto dev = deviceRef.getLogicalDevice();
+    if (commandPool)
+        dev.destroyCommandPool(commandPool); // Frees the buffers
+}
+
+VulkanCommandCache::Slot &VulkanCommandCache::slotAt(uint32_t frameIndex, uint32_t slot)
+{
+    if (slot >= slotsPerFrame)
+        throw std::runtime_error("command cache slot out of range!");
+    return slots.at(frameIndex * slotsPerFrame + slot);
+}
+
+void VulkanCommandCache::recordSlot(Slot &slot, const SecondaryInheritance &inheritance, const RecordFn &record)
+{
+    const vk::Format colorFormat = inheritance.colorFormat;
+    vk::CommandBufferInheritanceRenderingInfo rendering({}, 0, colorFormat != vk::Format::eUndefined ? 1 : 0,
+                                                        &colorFormat, inheritance.depthFormat, vk::Format::eUndefined,
+                                                        inheritance.samples);
+    vk::CommandBufferInheritanceInfo inheritanceInfo;
+    inheritanceInfo.pNext = &rendering;
+    inheritanceInfo.pipelineStatistics = inheritance.pipelineStatistics;
+
+    slot.buffer.reset();
+    slot.buffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eRenderPassContinue, &inheritanceInfo));
+    record(slot.buffer);
+    slot.buffer.end();
+    ++recordCount;
+}
+
+vk::CommandBuffer VulkanCommandCache::reuse(uint32_t frameIndex, uint32_t slot, uint64_t key,
+                                            const SecondaryInheritance &inheritance, const RecordFn &record)
+{
+    Slot &s = slotAt(frameIndex, slot);
+    if (s.valid && s.key == key)
+    {
+        ++reuseCount;
+        return s.buffer;
+    }
+
+    recordSlot(s, inheritance, record);
+    s.key = key;
+    s.valid = true;
+    return s.buffer;
+}
+
+vk::CommandBuffer VulkanCommandCache::record(uint32_t frameIndex, uint32_t slot,
+                                             const SecondaryInheritance &inheritance, const RecordFn &record)
+{
+    Slot &s = slotAt(frameIndex, slot);
+    recordSlot(s, inheritance, record);
+    s.valid = false; // A later reuse() of this slot must not trust the contents
+    return s.buffer;
+}
+
+void VulkanCommandCache::invalidate()
+{
+    for (Slot &slot : slots)
+        slot.valid = false;
+}
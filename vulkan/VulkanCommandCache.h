@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class VulkanDevice;
+
+// What a secondary command buffer inherits from the dynamic rendering pass it runs in
+struct SecondaryInheritance
+{
+    vk::Format colorFormat = vk::Format::eUndefined;
+    vk::Format depthFormat = vk::Format::eUndefined;
+    vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1;
+    vk::QueryPipelineStatisticFlags pipelineStatistics; // Statistics queries active in the primary
+};
+
+// Secondary command buffers for passes recorded with
+// VulkanRenderGraph::PassBuilder::secondaryCommandBuffers().
+//
+// Every frame in flight owns `slotsPerFrame` buffers. reuse() re-records a slot only when
+// the caller's key differs from the one it was last recorded with, so content whose
+// commands don't change between frames (the key covers everything the commands
+// reference: pipelines, buffers, descriptor offsets, viewport) costs nothing to record;
+// the data it reads changes through buffers instead. record() always re-records, for
+// per-frame content sharing the pass. A slot is only touched after its frame's fence
+// has been waited on, so buffers are never rewritten while the GPU may execute them.
+class VulkanCommandCache
+{
+public:
+    VulkanCommandCache(const VulkanDevice &device, uint32_t maxFramesInFlight, uint32_t slotsPerFrame);
+    ~VulkanCommandCache();
+
+    VulkanCommandCache(const VulkanCommandCache &) = delete;
+    VulkanCommandCache &operator=(const VulkanCommandCache &) = delete;
+
+    using RecordFn = std::function<void(vk::CommandBuffer)>;
+
+    vk::CommandBuffer reuse(uint32_t frameIndex, uint32_t slot, uint64_t key, const SecondaryInheritance &inheritance,
+                            const RecordFn &record);
+    vk::CommandBuffer record(uint32_t frameIndex, uint32_t slot, const SecondaryInheritance &inheritance,
+                             const RecordFn &record);
+
+    // Forget every recording (e.g. after destroying objects the buffers may reference)
+    void invalidate();
+
+    uint64_t getRecordCount() const { return recordCount; }
+    uint64_t getReuseCount() const { return reuseCount; }
+
+private:
+    struct Slot
+    {
+        vk::CommandBuffer buffer;
+        uint64_t key = 0;
+        bool valid = false;
+    };
+
+    Slot &slotAt(uint32_t frameIndex, uint32_t slot);
+    void recordSlot(Slot &slot, const SecondaryInheritance &inheritance, const RecordFn &record);
+
+    const VulkanDevice &deviceRef;
+    const uint32_t slotsPerFrame;
+    vk::CommandPool commandPool;
+    std::vector<Slot> slots;
+    uint64_t recordCount = 0;
+    uint64_t reuseCount = 0;
+};
@@ -0,0 +1,63 @@
+#include "VulkanDebug.h"
+
+namespace
+{
+    // Raw entry points: only the instance uses the dynamic dispatcher
+    PFN_vkSetDebugUtilsObjectNameEXT pfnSetObjectName = nullptr;
+    PFN_vkCmdBeginDebugUtilsLabelEXT pfnCmdBeginLabel = nullptr;
+    PFN_vkCmdEndDebugUtilsLabelEXT pfnCmdEndLabel = nullptr;
+}
+
+namespace VulkanDebug
+{
+    void init(vk::Instance instance)
+    {
+        VkInstance raw = static_cast<VkInstance>(instance);
+        pfnSetObjectName = reinterpret_cast<PFN_vkSetDebugUtilsObjectNameEXT>(
+            vkGetInstanceProcAddr(raw, "vkSetDebugUtilsObjectNameEXT"));
+        pfnCmdBeginLabel = reinterpret_cast<PFN_vkCmdBeginDebugUtilsLabelEXT>(
+            vkGetInstanceProcAddr(raw, "vkCmdBeginDebugUtilsLabelEXT"));
+        pfnCmdEndLabel = reinterpret_cast<PFN_vkCmdEndDebugUtilsLabelEXT>(
+            vkGetInstanceProcAddr(raw, "vkCmdEndDebugUtilsLabelEXT"));
+    }
+
+    bool enabled()
+    {
+        return pfnSetObjectName != nullptr;
+    }
+
+    void setObjectName(vk::Device device, vk::ObjectType type, uint64_t handle, const char *name)
+    {
+        if (!pfnSetObjectName || !handle)
+            return;
+
+        VkDebugUtilsObjectNameInfoEXT info{};
+        info.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
+        info.objectType = static_cast<VkObjectType>(type);
+        info.objectHandle = handle;
+        info.pObjectName = name;
+        pfnSetObjectName(static_cast<VkDevice>(device), &info);
+    }
+
+    void beginLabel(vk::CommandBuffer cmd, const char *name, const float color[4])
+    {
+        if (!pfnCmdBeginLabel)
+            return;
+
+        VkDebugUtilsLabelEXT label{};
+        label.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+        label.pLabelName = name;
+        if (color)
+        {
+            for (int i = 0; i < 4; ++i)
+                label.color[i] = color[i];
+        }
+        pfnCmdBeginLabel(static_cast<VkCommandBuffer>(cmd), &label);
+    }
+
+    void endLabel(vk::CommandBuffer cmd)
+    {
+        if (pfnCmdEndLabel)
+            pfnCmdEndLabel(static_cast<VkCommandBuffer>(cmd));
+    }
+}
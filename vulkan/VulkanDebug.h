@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+#include <cstdint>
+#include <string>
+
+// Object names and command buffer labels through VK_EXT_debug_utils, for validation
+// messages and captures in RenderDoc/Nsight. Compiled in only when the build defines
+// VULKAN_CUBE_DEBUG_UTILS (CMake option of the same name, off for Release builds);
+// otherwise the macros below expand to nothing and their arguments are never evaluated.
+// At runtime the entry points stay null unless the instance enabled the extension,
+// so an instrumented build without VULKAN_CUBE_DEBUG_LABELS pays one branch per call.
+namespace VulkanDebug
+{
+    // Loads the debug-utils entry points (call once the instance has the extension)
+    void init(vk::Instance instance);
+    bool enabled();
+
+    void setObjectName(vk::Device device, vk::ObjectType type, uint64_t handle, const char *name);
+
+    template <typename Handle>
+    void setName(vk::Device device, Handle handle, const char *name)
+    {
+        using CType = typename Handle::CType;
+        setObjectName(device, Handle::objectType,
+                      reinterpret_cast<uint64_t>(static_cast<CType>(handle)), name);
+    }
+
+    // "name #index", for per-frame and per-image objects
+    template <typename Handle>
+    void setName(vk::Device device, Handle handle, const char *name, uint32_t index)
+    {
+        setName(device, handle, (std::string(name) + " #" + std::to_string(index)).c_str());
+    }
+
+    void beginLabel(vk::CommandBuffer cmd, const char *name, const float color[4] = nullptr);
+    void endLabel(vk::CommandBuffer cmd);
+
+    class ScopedLabel
+    {
+    public:
+        ScopedLabel(vk::CommandBuffer cmd, const char *name, const float color[4] = nullptr) : cmd(cmd)
+        {
+            beginLabel(cmd, name, color);
+        }
+        ~ScopedLabel() { endLabel(cmd); }
+
+        ScopedLabel(const ScopedLabel &) = delete;
+        ScopedLabel &operator=(const ScopedLabel &) = delete;
+
+    private:
+        vk::CommandBuffer cmd;
+    };
+}
+
+#define VULKAN_DEBUG_CONCAT_INNER(a, b) a##b
+#define VULKAN_DEBUG_CONCAT(a, b) VULKAN_DEBUG_CONCAT_INNER(a, b)
+
+#if VULKAN_CUBE_DEBUG_UTILS
+#define VK_DEBUG_NAME(device, handle, ...) VulkanDebug::setName((device), (handle), __VA_ARGS__)
+#define VK_DEBUG_LABEL_BEGIN(cmd, ...) VulkanDebug::beginLabel((cmd), __VA_ARGS__)
+#define VK_DEBUG_LABEL_END(cmd) VulkanDebug::endLabel(cmd)
+#define VK_DEBUG_LABEL_SCOPE(cmd, ...) \
+    VulkanDebug::ScopedLabel VULKAN_DEBUG_CONCAT(debugLabel_, __LINE__)((cmd), __VA_ARGS__)
+#else
+#define VK_DEBUG_NAME(device, handle, ...) ((void)0)
+#define VK_DEBUG_LABEL_BEGIN(cmd, ...) ((void)0)
+#define VK_DEBUG_LABEL_END(cmd) ((void)0)
+#define VK_DEBUG_LABEL_SCOPE(cmd, ...) ((void)0)
+#endif
@@ -1,15 +1,37 @@
 #include "VulkanDevice.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
 #include <set>
 
-VulkanDevice::VulkanDevice(vk::Instance instance, vk::SurfaceKHR surface)
+VulkanDevice::VulkanDevice(vk::Instance instance, vk::SurfaceKHR surface, const std::string &preference)
 {
-    pickPhysicalDevice(instance, surface);
+    if (!surface)
+        deviceExtensions.clear(); // Headless: nothing to present to
+
+    pickPhysicalDevice(instance, surface, preference);
+
+    // Optional: real per-heap budgets for memory accounting
+    bool memoryBudget = false;
+    for (const auto &ext : physicalDevice.enumerateDeviceExtensionProperties())
+    {
+        if (std::strcmp(ext.extensionName.data(), VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0)
+            memoryBudget = true;
+    }
+    if (memoryBudget)
+        deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
 
     std::set<uint32_t> uniqueQueueFamilies = {
         queueIndices.graphicsFamily.value(),
         queueIndices.presentFamily.value()};
+    if (queueIndices.transferFamily)
+        uniqueQueueFamilies.insert(*queueIndices.transferFamily);
+    if (queueIndices.computeFamily)
+        uniqueQueueFamilies.insert(*queueIndices.computeFamily);
 
     std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
     float queuePriority = 1.0f;
@@ -18,14 +40,39 @@ VulkanDevice::VulkanDevice(vk::Instance instance, vk::SurfaceKHR surface)
         queueCreateInfos.emplace_back(vk::DeviceQueueCreateFlags(), queueFamily, 1, &queuePriority);
     }
 
-    vk::PhysicalDeviceFeatures deviceFeatures{};
+    // Descriptor indexing for the bindless material/texture tables
+    enabledFeatures12.runtimeDescriptorArray = true;
+    enabledFeatures12.descriptorBindingPartiallyBound = true;
+    enabledFeatures12.descriptorBindingSampledImageUpdateAfterBind = true;
+    enabledFeatures12.descriptorBindingVariableDescriptorCount = true;
+    enabledFeatures12.shaderSampledImageArrayNonUniformIndexing = true;
+    enabledFeatures12.pNext = &enabledFeatures13;
+    enabledFeatures.pNext = &enabledFeatures12;
+
+    // vkCmdPipelineBarrier2 for the render graph; vkCmdBeginRendering instead of render passes
+    enabledFeatures13.synchronization2 = true;
+    enabledFeatures13.dynamicRendering = true;
+
+    // Optional: fragment shader invocation counts for overdraw measurement
+    enabledFeatures.features.pipelineStatisticsQuery = physicalDevice.getFeatures().pipelineStatisticsQuery;
+    // ...which secondary command buffers can only run inside with inherited queries
+    enabledFeatures.features.inheritedQueries = physicalDevice.getFeatures().inheritedQueries;
+
+    // Optional: compacted occlusion-culled draws (vkCmdDrawIndirectCount, draw index in firstInstance)
+    vk::PhysicalDeviceVulkan12Features supported12;
+    vk::PhysicalDeviceFeatures2 supported;
+    supported.pNext = &supported12;
+    physicalDevice.getFeatures2(&supported);
+    enabledFeatures12.drawIndirectCount = supported12.drawIndirectCount;
+    enabledFeatures.features.drawIndirectFirstInstance = supported.features.drawIndirectFirstInstance;
 
     vk::DeviceCreateInfo createInfo;
+    createInfo.pNext = &enabledFeatures;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
     createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
     createInfo.ppEnabledExtensionNames = deviceExtensions.data();
-    createInfo.pEnabledFeatures = &deviceFeatures;
+    createInfo.pEnabledFeatures = nullptr; // Core features travel in enabledFeatures (pNext chain)
 
     device = physicalDevice.createDevice(createInfo);
 
@@ -33,6 +80,10 @@ VulkanDevice::VulkanDevice(vk::Instance instance, vk::SurfaceKHR surface)
 
     graphicsQueue = device.getQueue(queueIndices.graphicsFamily.value(), 0);
     presentQueue = device.getQueue(queueIndices.presentFamily.value(), 0);
+    transferQueue = device.getQueue(getTransferQueueFamily(), 0);
+    computeQueue = device.getQueue(getComputeQueueFamily(), 0);
+
+    memoryTracker = std::make_unique<VulkanMemoryTracker>(physicalDevice, memoryBudget);
 }
 
 VulkanDevice::~VulkanDevice()
@@ -43,7 +94,7 @@ VulkanDevice::~VulkanDevice()
     }
 }
 
-void VulkanDevice::pickPhysicalDevice(vk::Instance instance, vk::SurfaceKHR surface)
+void VulkanDevice::pickPhysicalDevice(vk::Instance instance, vk::SurfaceKHR surface, const std::string &preference)
 {
     auto devices = instance.enumeratePhysicalDevices();
     if (devices.empty())
@@ -51,40 +102,278 @@ void VulkanDevice::pickPhysicalDevice(vk::Instance instance, vk::SurfaceKHR surf
         throw std::runtime_error("failed to find GPUs with Vulkan support!");
     }
 
-    for (const auto &dev : devices)
+    struct Candidate
+    {
+        uint32_t index;
+        vk::PhysicalDevice device;
+        QueueFamilyIndices indices;
+        uint64_t score;
+    };
+    std::vector<Candidate> candidates;
+    for (uint32_t i = 0; i < devices.size(); ++i)
+    {
+        QueueFamilyIndices indices = findQueueFamilies(devices[i], surface);
+        if (indices.isComplete() && supportsRequiredFeatures(devices[i]))
+            candidates.push_back({i, devices[i], indices, scoreDevice(devices[i], indices)});
+    }
+    if (candidates.empty())
+    {
+        throw std::runtime_error("failed to find a suitable GPU!");
+    }
+
+    // Highest score; the first listed wins ties
+    const Candidate *chosen = &candidates.front();
+    for (const Candidate &candidate : candidates)
+    {
+        if (candidate.score > chosen->score)
+            chosen = &candidate;
+    }
+
+    if (!preference.empty())
     {
-        QueueFamilyIndices indices = findQueueFamilies(dev, surface);
-        if (indices.isComplete())
+        auto lower = [](std::string text)
         {
-            physicalDevice = dev;
-            queueIndices = indices; // Store only when we pick the device
-            return;
-        }
+            std::transform(text.begin(), text.end(), text.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return text;
+        };
+        char *end = nullptr;
+        const unsigned long index = std::strtoul(preference.c_str(), &end, 10);
+        const bool byIndex = end && *end == '\0';
+
+        auto match = std::find_if(candidates.begin(), candidates.end(), [&](const Candidate &candidate)
+                                  {
+                                      if (byIndex)
+                                          return candidate.index == index;
+                                      std::string name = candidate.device.getProperties().deviceName.data();
+                                      return lower(name).find(lower(preference)) != std::string::npos;
+                                  });
+        if (match != candidates.end())
+            chosen = &*match;
+        else
+            std::cerr << "No suitable GPU matches \"" << preference << "\"; using the best scored one" << std::endl;
+    }
+
+    for (const Candidate &candidate : candidates)
+    {
+        auto props = candidate.device.getProperties();
+        std::cout << (&candidate == chosen ? "* " : "  ") << "GPU " << candidate.index << ": "
+                  << props.deviceName.data() << " (" << vk::to_string(props.deviceType) << ", score "
+                  << candidate.score << ")" << std::endl;
     }
 
-    throw std::runtime_error("failed to find a suitable GPU!");
+    physicalDevice = chosen->device;
+    queueIndices = chosen->indices; // Store only when we pick the device
+
+    std::cout << "Queues: graphics family " << *queueIndices.graphicsFamily << ", transfer "
+              << (queueIndices.transferFamily ? "family " + std::to_string(*queueIndices.transferFamily)
+                                              : std::string("shares graphics"))
+              << ", compute "
+              << (queueIndices.computeFamily ? "family " + std::to_string(*queueIndices.computeFamily)
+                                             : std::string("shares graphics"))
+              << std::endl;
+}
+
+// Type dominates (each tier is worth more than anything below it can add up to); the
+// largest device-local heap, limits and dedicated queues order devices of one type.
+// Software rasterizers report system memory as device local, so memory alone would
+// happily pick one.
+uint64_t VulkanDevice::scoreDevice(vk::PhysicalDevice device, const QueueFamilyIndices &indices)
+{
+    auto props = device.getProperties();
+
+    uint64_t score = 0;
+    switch (props.deviceType)
+    {
+    case vk::PhysicalDeviceType::eDiscreteGpu:
+        score = 4000000;
+        break;
+    case vk::PhysicalDeviceType::eIntegratedGpu:
+        score = 3000000;
+        break;
+    case vk::PhysicalDeviceType::eVirtualGpu:
+        score = 2000000;
+        break;
+    case vk::PhysicalDeviceType::eCpu:
+        score = 0;
+        break;
+    default:
+        score = 1000000;
+        break;
+    }
+
+    vk::DeviceSize localHeap = 0;
+    auto memory = device.getMemoryProperties();
+    for (uint32_t i = 0; i < memory.memoryHeapCount; ++i)
+    {
+        if (memory.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal)
+            localHeap = std::max(localHeap, memory.memoryHeaps[i].size);
+    }
+    score += std::min<uint64_t>(localHeap >> 20, 256 * 1024); // MB, capped at 256 GB
+    score += props.limits.maxImageDimension2D / 256;
+    if (indices.transferFamily)
+        score += 1000;
+    if (indices.computeFamily)
+        score += 1000;
+    return score;
+}
+
+bool VulkanDevice::supportsRequiredFeatures(vk::PhysicalDevice device)
+{
+    if (device.getProperties().apiVersion < VK_API_VERSION_1_3)
+    {
+        std::cerr << "Skipping " << device.getProperties().deviceName.data()
+                  << ": Vulkan 1.3 not supported" << std::endl;
+        return false;
+    }
+
+    vk::PhysicalDeviceVulkan13Features supported13;
+    vk::PhysicalDeviceVulkan12Features supported12;
+    vk::PhysicalDeviceFeatures2 supported;
+    supported12.pNext = &supported13;
+    supported.pNext = &supported12;
+    device.getFeatures2(&supported);
+
+    bool bindless = supported12.runtimeDescriptorArray &&
+                    supported12.descriptorBindingPartiallyBound &&
+                    supported12.descriptorBindingSampledImageUpdateAfterBind &&
+                    supported12.descriptorBindingVariableDescriptorCount &&
+                    supported12.shaderSampledImageArrayNonUniformIndexing;
+    if (!bindless)
+    {
+        std::cerr << "Skipping " << device.getProperties().deviceName.data()
+                  << ": descriptor indexing (bindless) not supported" << std::endl;
+        return false;
+    }
+
+    if (!supported13.synchronization2)
+    {
+        std::cerr << "Skipping " << device.getProperties().deviceName.data()
+                  << ": synchronization2 not supported" << std::endl;
+        return false;
+    }
+
+    if (!supported13.dynamicRendering)
+    {
+        std::cerr << "Skipping " << device.getProperties().deviceName.data()
+                  << ": dynamic rendering not supported" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+vk::Format VulkanDevice::findDepthFormat(bool sampled) const
+{
+    vk::FormatFeatureFlags required = vk::FormatFeatureFlagBits::eDepthStencilAttachment;
+    if (sampled)
+        required |= vk::FormatFeatureFlagBits::eSampledImage;
+
+    for (vk::Format format : {vk::Format::eD32Sfloat, vk::Format::eD24UnormS8Uint, vk::Format::eD16Unorm})
+    {
+        // A sampled view may only cover the depth aspect; keep to depth-only formats
+        if (sampled && format == vk::Format::eD24UnormS8Uint)
+            continue;
+
+        vk::FormatProperties props = physicalDevice.getFormatProperties(format);
+        if ((props.optimalTilingFeatures & required) == required)
+            return format;
+    }
+
+    throw std::runtime_error("failed to find a supported depth format!");
+}
+
+vk::SampleCountFlagBits VulkanDevice::clampSampleCount(uint32_t requested) const
+{
+    auto limits = physicalDevice.getProperties().limits;
+    vk::SampleCountFlags supported = limits.framebufferColorSampleCounts & limits.framebufferDepthSampleCounts;
+
+    for (vk::SampleCountFlagBits count : {vk::SampleCountFlagBits::e64, vk::SampleCountFlagBits::e32,
+                                          vk::SampleCountFlagBits::e16, vk::SampleCountFlagBits::e8,
+                                          vk::SampleCountFlagBits::e4, vk::SampleCountFlagBits::e2})
+    {
+        if (static_cast<uint32_t>(count) <= requested && (supported & count))
+            return count;
+    }
+    return vk::SampleCountFlagBits::e1;
 }
 
 QueueFamilyIndices VulkanDevice::findQueueFamilies(vk::PhysicalDevice device, vk::SurfaceKHR surface)
 {
     QueueFamilyIndices indices;
+    bool graphicsPresents = false;
 
     auto queueFamilies = device.getQueueFamilyProperties();
-    uint32_t i = 0;
-    for (const auto &queueFamily : queueFamilies)
+    for (uint32_t i = 0; i < queueFamilies.size(); ++i)
     {
-        if (queueFamily.queueFlags & vk::QueueFlagBits::eGraphics)
+        const vk::QueueFlags flags = queueFamilies[i].queueFlags;
+        const bool graphics = static_cast<bool>(flags & vk::QueueFlagBits::eGraphics);
+        const bool compute = static_cast<bool>(flags & vk::QueueFlagBits::eCompute);
+        const bool present = surface ? device.getSurfaceSupportKHR(i, surface) == VK_TRUE : graphics;
+
+        // One family for graphics and present where possible
+        if (graphics && (!indices.graphicsFamily || (present && !graphicsPresents)))
         {
             indices.graphicsFamily = i;
+            graphicsPresents = present;
         }
-        if (device.getSurfaceSupportKHR(i, surface))
-        {
+        if (present && !indices.presentFamily)
             indices.presentFamily = i;
-        }
-        if (indices.isComplete())
-            break;
-        ++i;
+
+        if (compute && !graphics && !indices.computeFamily)
+            indices.computeFamily = i;
+        if ((flags & vk::QueueFlagBits::eTransfer) && !graphics && !compute && !indices.transferFamily)
+            indices.transferFamily = i;
     }
+    if (graphicsPresents)
+        indices.presentFamily = indices.graphicsFamily;
 
     return indices;
-}
\ No newline at end of file
+}
+
+std::vector<uint32_t> VulkanDevice::getSharingFamilies(uint32_t other) const
+{
+    std::vector<uint32_t> families = {getGraphicsQueueFamily()};
+    if (other != families[0])
+        families.push_back(other);
+    return families;
+}
+
+uint32_t VulkanDevice::findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const
+{
+    uint32_t memoryType = findMemoryType(typeFilter, std::vector<vk::MemoryPropertyFlags>{properties});
+    if (memoryType == UINT32_MAX)
+        throw std::runtime_error("failed to find suitable memory type!");
+    return memoryType;
+}
+
+uint32_t VulkanDevice::findMemoryType(uint32_t typeFilter, const std::vector<vk::MemoryPropertyFlags> &preferences) const
+{
+    auto memProperties = physicalDevice.getMemoryProperties();
+    for (auto wanted : preferences)
+    {
+        for (uint32_t i = 0; i < memProperties.memoryTypeCount; ++i)
+        {
+            if ((typeFilter & (1 << i)) &&
+                (memProperties.memoryTypes[i].propertyFlags & wanted) == wanted)
+            {
+                return i;
+            }
+        }
+    }
+    return UINT32_MAX;
+}
+
+vk::DeviceMemory VulkanDevice::allocateMemory(const vk::MemoryAllocateInfo &info, MemoryCategory category) const
+{
+    vk::DeviceMemory memory = device.allocateMemory(info);
+    memoryTracker->recordAllocation(memory, info.allocationSize, info.memoryTypeIndex, category);
+    return memory;
+}
+
+void VulkanDevice::freeMemory(vk::DeviceMemory memory) const
+{
+    if (!memory)
+        return;
+    memoryTracker->recordFree(memory);
+    device.freeMemory(memory);
+}
@@ -1,13 +1,18 @@
 #pragma once
 
 #include <vulkan/vulkan.hpp>
+#include <memory>
 #include <optional>
+#include <string>
 #include <vector>
+#include "VulkanMemoryTracker.h"
 
 struct QueueFamilyIndices
 {
     std::optional<uint32_t> graphicsFamily;
     std::optional<uint32_t> presentFamily;
+    std::optional<uint32_t> transferFamily; // Transfer only (a DMA engine), if the device has one
+    std::optional<uint32_t> computeFamily;  // Compute without graphics (async compute), if any
 
     bool isComplete() const
     {
@@ -18,7 +23,11 @@ struct QueueFamilyIndices
 class VulkanDevice
 {
 public:
-    VulkanDevice(vk::Instance instance, vk::SurfaceKHR surface);
+    // A null surface creates a headless device (no presentation; present queue = graphics queue).
+    // Among the suitable GPUs the best scored one is used (discrete over integrated over
+    // software, then memory and limits) unless `preference` names one: an index into the
+    // instance's device list or part of a device name (case-insensitive).
+    VulkanDevice(vk::Instance instance, vk::SurfaceKHR surface, const std::string &preference = std::string());
     ~VulkanDevice();
 
     vk::PhysicalDevice getPhysicalDevice() const { return physicalDevice; }
@@ -29,9 +38,48 @@ public:
     uint32_t getGraphicsQueueFamily() const { return queueIndices.graphicsFamily.value(); }
     uint32_t getPresentQueueFamily() const { return queueIndices.presentFamily.value(); }
 
+    // Dedicated queues where the device has them, the graphics queue otherwise. Work on a
+    // dedicated queue overlaps graphics; resources shared with it need concurrent sharing
+    // (see getSharingFamilies) or ownership transfers.
+    vk::Queue getTransferQueue() const { return transferQueue; }
+    vk::Queue getComputeQueue() const { return computeQueue; }
+    uint32_t getTransferQueueFamily() const { return queueIndices.transferFamily.value_or(getGraphicsQueueFamily()); }
+    uint32_t getComputeQueueFamily() const { return queueIndices.computeFamily.value_or(getGraphicsQueueFamily()); }
+    bool hasDedicatedTransferQueue() const { return queueIndices.transferFamily.has_value(); }
+    bool hasAsyncComputeQueue() const { return queueIndices.computeFamily.has_value(); }
+
+    // Distinct families among graphics and `other` (for vk::SharingMode::eConcurrent when > 1)
+    std::vector<uint32_t> getSharingFamilies(uint32_t other) const;
+
+    // Best supported depth attachment format (D32, then D24S8, then D16). `sampled`
+    // additionally requires sampled-image support and a depth-only format (e.g. for a depth pyramid).
+    vk::Format findDepthFormat(bool sampled = false) const;
+
+    // Highest sample count <= requested usable for both color and depth attachments
+    vk::SampleCountFlagBits clampSampleCount(uint32_t requested) const;
+
+    // Core features enabled on the logical device (optional ones may be off)
+    const vk::PhysicalDeviceFeatures &getEnabledFeatures() const { return enabledFeatures.features; }
+
+    // Vulkan 1.2 features enabled on the logical device (descriptor indexing etc.)
+    const vk::PhysicalDeviceVulkan12Features &getEnabledFeatures12() const { return enabledFeatures12; }
+    const vk::PhysicalDeviceVulkan13Features &getEnabledFeatures13() const { return enabledFeatures13; }
+
+    // First memory type allowed by typeFilter with all of `properties`; throws if none
+    uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const;
+    // First type matching any of `preferences`, tried in order; UINT32_MAX if none
+    uint32_t findMemoryType(uint32_t typeFilter, const std::vector<vk::MemoryPropertyFlags> &preferences) const;
+
+    // All device memory goes through these so it is accounted per heap and category
+    vk::DeviceMemory allocateMemory(const vk::MemoryAllocateInfo &info, MemoryCategory category) const;
+    void freeMemory(vk::DeviceMemory memory) const;
+    VulkanMemoryTracker &getMemoryTracker() const { return *memoryTracker; }
+
 private:
-    void pickPhysicalDevice(vk::Instance instance, vk::SurfaceKHR surface);
+    void pickPhysicalDevice(vk::Instance instance, vk::SurfaceKHR surface, const std::string &preference);
     QueueFamilyIndices findQueueFamilies(vk::PhysicalDevice device, vk::SurfaceKHR surface);
+    bool supportsRequiredFeatures(vk::PhysicalDevice device);
+    static uint64_t scoreDevice(vk::PhysicalDevice device, const QueueFamilyIndices &indices);
 
     vk::PhysicalDevice physicalDevice = VK_NULL_HANDLE;
     vk::Device device;
@@ -39,7 +87,15 @@ private:
     QueueFamilyIndices queueIndices;
     vk::Queue graphicsQueue;
     vk::Queue presentQueue;
+    vk::Queue transferQueue;
+    vk::Queue computeQueue;
+
+    vk::PhysicalDeviceFeatures2 enabledFeatures;
+    vk::PhysicalDeviceVulkan12Features enabledFeatures12;
+    vk::PhysicalDeviceVulkan13Features enabledFeatures13;
+
+    std::unique_ptr<VulkanMemoryTracker> memoryTracker;
 
-    const std::vector<const char *> deviceExtensions = {
+    std::vector<const char *> deviceExtensions = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 };
\ No newline at end of file
@@ -1,45 +1,160 @@
 #include "VulkanFrame.h"
 #include "VulkanDevice.h"
 #include "VulkanSwapchain.h"
-#include "VulkanRenderPass.h"
 #include "VulkanCommand.h"
 #include "VulkanSync.h"
+#include "VulkanFrameRing.h"
+#include "VulkanBindless.h"
+#include "VulkanOcclusionCuller.h"
+#include "VulkanRenderGraph.h"
+#include "VulkanFrameCapture.h"
+#include "VulkanInstanceAnimator.h"
+#include "VulkanParticleSystem.h"
+#include "VulkanHud.h"
+#include "VulkanCommandCache.h"
 #include "src/Mesh.h"
 #include "src/GameObject.h"
 #include "src/Material.h"
+#include "VulkanDebug.h"
 
+#include <algorithm>
 #include <array>
-#include <unordered_map>
+#include <cmath>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+namespace
+{
+    // FNV-1a over the bytes of a padding-free value
+    template <typename T>
+    uint64_t hashValue(uint64_t hash, const T &value)
+    {
+        const auto *bytes = reinterpret_cast<const unsigned char *>(&value);
+        for (size_t i = 0; i < sizeof(T); ++i)
+            hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+        return hash;
+    }
+}
+
 VulkanFrame::VulkanFrame(const VulkanDevice &device,
                          const VulkanSwapchain &swapchain,
-                         const VulkanRenderPass &renderPass,
                          VulkanCommand &command,
                          VulkanSync &sync,
-                         uint32_t maxFramesInFlight)
+                         VulkanFrameRing &frameRing,
+                         const VulkanBindless &bindless,
+                         uint32_t maxFramesInFlight,
+                         const RenderSettings &settings)
     : deviceRef(device),
       swapchainRef(swapchain),
-      renderPassRef(renderPass),
       commandRef(command),
       syncRef(sync),
-      maxFramesInFlight(maxFramesInFlight)
+      frameRingRef(frameRing),
+      bindlessRef(bindless),
+      maxFramesInFlight(maxFramesInFlight),
+      sortDraws(settings.sortDraws),
+      renderGraph(std::make_unique<VulkanRenderGraph>(device, maxFramesInFlight))
 {
     auto ext = swapchainRef.getExtent();
     if (ext.height > 0)
         targetAspect = static_cast<float>(ext.width) / static_cast<float>(ext.height);
+
+    setViews({FrameView()});
+
+    if (settings.prerecordDraws)
+    {
+        commandCache = std::make_unique<VulkanCommandCache>(device, maxFramesInFlight, kCommandSlots);
+        recordedStats.resize(maxFramesInFlight * kCommandSlots);
+    }
+
+    // Secondary command buffers may only run inside the statistics query with inherited queries
+    const vk::PhysicalDeviceFeatures &features = deviceRef.getEnabledFeatures();
+    if (features.pipelineStatisticsQuery && (!commandCache || features.inheritedQueries))
+    {
+        vk::QueryPoolCreateInfo queryInfo;
+        queryInfo.queryType = vk::QueryType::ePipelineStatistics;
+        queryInfo.queryCount = maxFramesInFlight;
+        queryInfo.pipelineStatistics = vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations;
+        statsQueryPool = deviceRef.getLogicalDevice().createQueryPool(queryInfo);
+        VK_DEBUG_NAME(deviceRef.getLogicalDevice(), statsQueryPool, "fragment statistics");
+        statsQueryIssued.assign(maxFramesInFlight, false);
+    }
+}
+
+VulkanFrame::~VulkanFrame()
+{
+    if (statsQueryPool)
+        deviceRef.getLogicalDevice().destroyQueryPool(statsQueryPool);
+}
+
+void VulkanFrame::readStatsQuery(uint32_t frame)
+{
+    if (!statsQueryPool || !statsQueryIssued[frame])
+        return;
+
+    // Called after the frame's fence wait, so the result is ready; don't block if not
+    uint64_t invocations = 0;
+    vk::Result result = deviceRef.getLogicalDevice().getQueryPoolResults(
+        statsQueryPool, frame, 1, sizeof(invocations), &invocations, sizeof(invocations),
+        vk::QueryResultFlagBits::e64);
+    if (result == vk::Result::eSuccess)
+        lastFragmentInvocations = invocations;
 }
 
 void VulkanFrame::addGameObject(GameObject *obj)
 {
     if (obj)
+    {
         gameObjects.push_back(obj);
+        objectsChanged = true;
+    }
+}
+
+void VulkanFrame::removeGameObjects(const std::vector<GameObject *> &objects)
+{
+    std::unordered_set<GameObject *> removed(objects.begin(), objects.end());
+    gameObjects.erase(std::remove_if(gameObjects.begin(), gameObjects.end(),
+                                     [&removed](GameObject *obj) { return removed.count(obj) != 0; }),
+                      gameObjects.end());
+    objectsChanged = true;
 }
 
 void VulkanFrame::clearGameObjects()
 {
     gameObjects.clear();
+    objectsChanged = true;
+}
+
+void VulkanFrame::setCamera(const glm::vec3 &eye, const glm::vec3 &target)
+{
+    views[0].eye = eye;
+    views[0].target = target;
+}
+
+void VulkanFrame::setViews(const std::vector<FrameView> &frameViews)
+{
+    if (frameViews.empty() || frameViews.size() > kMaxViews)
+        throw std::runtime_error("a frame needs between 1 and " + std::to_string(kMaxViews) + " views!");
+    for (const FrameView &view : frameViews)
+    {
+        const glm::vec4 &r = view.rect;
+        if (r.x < 0.0f || r.y < 0.0f || r.z <= 0.0f || r.w <= 0.0f || r.x + r.z > 1.0f || r.y + r.w > 1.0f)
+            throw std::runtime_error("view rectangle must lie within the frame!");
+    }
+
+    views = frameViews;
+    viewQueues.resize(views.size());
+    for (size_t v = 0; v < viewQueues.size(); ++v)
+    {
+        viewQueues[v].setSortingEnabled(sortDraws);
+        viewQueues[v].setLodOwner(v == 0); // The main view's LOD choices carry the hysteresis
+    }
+    if (commandCache)
+        commandCache->invalidate();
 }
 
 void VulkanFrame::updateTargetAspect()
@@ -47,46 +162,377 @@ void VulkanFrame::updateTargetAspect()
     auto ext = swapchainRef.getExtent();
     if (ext.height > 0)
         targetAspect = static_cast<float>(ext.width) / static_cast<float>(ext.height);
+    if (commandCache)
+        commandCache->invalidate();
+}
+
+void VulkanFrame::setOcclusionCulling(VulkanOcclusionCuller *culler)
+{
+    occlusionCuller = culler;
 }
 
-void VulkanFrame::renderObjects(vk::CommandBuffer cmd,
-                                const glm::mat4 &view,
-                                const glm::mat4 &proj)
+void VulkanFrame::setCapture(VulkanFrameCapture *frameCapture)
 {
-    // Batch objects by material to minimize pipeline switches
-    std::unordered_map<Material *, std::vector<GameObject *>> batchedObjects;
+    capture = frameCapture;
+}
+
+void VulkanFrame::setAnimator(VulkanInstanceAnimator *instanceAnimator)
+{
+    animator = instanceAnimator;
+}
+
+void VulkanFrame::setParticles(VulkanParticleSystem *particleSystem)
+{
+    particles = particleSystem;
+}
+
+void VulkanFrame::setHud(VulkanHud *overlay)
+{
+    hud = overlay;
+}
 
-    for (GameObject *obj : gameObjects)
+void VulkanFrame::prepareObjects(const std::vector<CameraData> &cameras)
+{
+    viewProjs.clear();
+    for (const CameraData &camera : cameras)
+        viewProjs.push_back(camera.viewProj);
+
+    // Nothing moved and every view sees what it saw last frame: the queues (with their
+    // signatures) and the draw data still hold, only this frame's ring space is new
+    const bool occlusion = occlusionCuller != nullptr;
+    if (objectsChanged || occlusion != preparedForOcclusion || viewProjs != preparedViewProjs)
     {
-        if (obj && obj->enabled && obj->mesh && obj->material)
-        {
-            batchedObjects[obj->material].push_back(obj);
-        }
+        buildQueues(cameras);
+        objectsChanged = false;
+        preparedForOcclusion = occlusion;
+        preparedViewProjs = viewProjs;
     }
+    if (drawData.empty())
+        return;
+
+    // One sequential copy into the (possibly write-combined) ring
+    RingAllocation drawAlloc = frameRingRef.allocateStorage(sizeof(DrawData) * drawData.size());
+    std::memcpy(drawAlloc.data, drawData.data(), sizeof(DrawData) * drawData.size());
+    drawDataOffset = drawAlloc.offset;
+}
 
-    // Render each material batch (C++11 compatible iteration)
-    for (auto it = batchedObjects.begin(); it != batchedObjects.end(); ++it)
+void VulkanFrame::buildQueues(const std::vector<CameraData> &cameras)
+{
+    // Sort draws by state and depth to minimize switches and overdraw; materials sharing
+    // a pipeline differ only by the bindless material ID pushed per draw
+    if (occlusionCuller)
     {
-        Material *material = it->first;
-        std::vector<GameObject *> &objects = it->second;
+        // The GPU culler tests one camera against item-indexed draw data
+        RenderQueue &queue = viewQueues[0];
+        queue.setIndexByObject(false);
+        queue.setGpuCulling(true);
+        queue.build(gameObjects, cameras[0]);
+        drawData.resize(queue.getDrawCount());
+        queue.writeDrawData(drawData.data());
+        return;
+    }
 
-        // Bind pipeline once per material
-        cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, material->getPipeline());
+    // One frustum pass for all views; each view then queues only what it can see
+    visibility.update(gameObjects, viewProjs);
+    for (size_t v = 0; v < cameras.size(); ++v)
+    {
+        viewQueues[v].setIndexByObject(true);
+        viewQueues[v].setGpuCulling(false);
+        viewQueues[v].build(gameObjects, cameras[v], &visibility.getVisibleObjects(v));
+    }
 
-        // Render all objects using this material
-        for (GameObject *obj : objects)
-        {
-            glm::mat4 model = obj->transform.getMatrix();
-            glm::mat4 mvp = proj * view * model;
+    // Indexed by object, so an object seen by several views is written once
+    drawData.resize(visibility.getVisibleCount() > 0 ? gameObjects.size() : 0);
+    visibility.writeDrawData(gameObjects, drawData.data());
+}
+
+void VulkanFrame::renderObjects(vk::CommandBuffer cmd, RenderQueue &queue, uint32_t cameraOffset,
+                                vk::Buffer indirectBuffer, vk::DeviceSize indirectOffset, vk::DeviceSize countOffset)
+{
+    if (queue.getDrawCount() == 0)
+        return;
+
+    uint32_t dynamicOffsets[] = {cameraOffset, drawDataOffset};
+    std::array<vk::DescriptorSet, 2> sets = {frameRingRef.getDescriptorSet(), bindlessRef.getDescriptorSet()};
 
-            cmd.pushConstants(material->getLayout(),
-                              vk::ShaderStageFlagBits::eVertex,
-                              0, sizeof(glm::mat4), &mvp);
+    queue.record(cmd, static_cast<uint32_t>(sets.size()), sets.data(), 2, dynamicOffsets,
+                 indirectBuffer, indirectOffset, countOffset);
+}
 
-            obj->mesh->bind(cmd);
-            obj->mesh->draw(cmd);
+void VulkanFrame::recordScene(vk::CommandBuffer cmd, uint32_t imageIndex, uint32_t frameIndex,
+                              const CameraData &mainCamera)
+{
+    using Handle = VulkanRenderGraph::Handle;
+    const vk::Extent2D extent = swapchainRef.getExtent();
+    const vk::SampleCountFlagBits samples = swapchainRef.getSampleCount();
+    const vk::PipelineStageFlags2 depthStages =
+        vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests;
+
+    renderGraph->reset();
+
+    // The acquire semaphore is waited on at color attachment output
+    Handle backbuffer = renderGraph->importImage(
+        "backbuffer", swapchainRef.getImage(imageIndex), swapchainRef.getImageViews()[imageIndex],
+        {swapchainRef.getImageFormat(), extent}, vk::ImageLayout::eUndefined,
+        vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+    renderGraph->exportImage(backbuffer, vk::ImageLayout::ePresentSrcKHR);
+
+    // Shared by every frame in flight; contents are never carried over
+    Handle depth = renderGraph->importImage(
+        "depth", swapchainRef.getDepthImage(), swapchainRef.getDepthImageView(),
+        {swapchainRef.getDepthFormat(), extent, samples, swapchainRef.getDepthAspect()}, vk::ImageLayout::eUndefined,
+        depthStages | vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eDepthStencilAttachmentWrite);
+
+    // Each frame writes only its own ring region, which its fence wait already freed
+    Handle ring = renderGraph->importBuffer("frame-ring", frameRingRef.getBuffer());
+
+    // Animated instances are drawn once, in the first scene pass
+    const bool animating = animator && animator->getInstanceCount() > 0;
+    Handle instances = 0;
+    if (animating)
+    {
+        // Last frame's draws read the matrices this frame's compute pass overwrites
+        instances = renderGraph->importBuffer("instances", animator->getInstanceBuffer(),
+                                              vk::PipelineStageFlagBits2::eVertexShader);
+        renderGraph->addPass("animate", [this](const VulkanRenderGraph::PassContext &ctx)
+                             { animator->animate(ctx.cmd); })
+            .write(instances, RGAccess::storageWrite(vk::PipelineStageFlagBits2::eComputeShader));
+    }
+
+    // Particles are blended over everything else, so they are drawn in the last scene pass
+    Handle particleBuffer = 0;
+    if (particles)
+    {
+        particles->prepare();
+
+        // Last frame's draw read the alive list and counters this frame's passes rewrite
+        const vk::PipelineStageFlags2 particleStages =
+            vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eDrawIndirect;
+        particleBuffer = renderGraph->importBuffer("particles", particles->getBuffer(),
+                                                   particleStages | vk::PipelineStageFlagBits2::eVertexShader,
+                                                   vk::AccessFlagBits2::eShaderStorageWrite);
+        renderGraph->addPass("particles", [this](const VulkanRenderGraph::PassContext &ctx)
+                             { particles->simulate(ctx.cmd); })
+            .write(particleBuffer, {particleStages,
+                                    vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite |
+                                        vk::AccessFlagBits2::eIndirectCommandRead});
+    }
+
+    // With prerecording the scene passes only execute secondaries: the queued draws from a
+    // cached one, the per-frame animated and particle draws from one recorded each frame
+    SecondaryInheritance inheritance;
+    inheritance.colorFormat = swapchainRef.getImageFormat();
+    inheritance.depthFormat = swapchainRef.getDepthFormat();
+    inheritance.samples = samples;
+    if (statsQueryPool)
+        inheritance.pipelineStatistics = vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations;
+
+    // Views are drawn in order. Each later view first clears its rectangle, since it may
+    // cover part of an earlier one.
+    auto scenePass = [this, frameIndex, inheritance](vk::Buffer indirectBuffer, vk::DeviceSize indirectOffset,
+                                                     vk::DeviceSize countOffset, bool drawAnimated,
+                                                     bool drawParticles, uint32_t passIndex)
+    {
+        return [this, frameIndex, inheritance, indirectBuffer, indirectOffset, countOffset, drawAnimated,
+                drawParticles, passIndex](const VulkanRenderGraph::PassContext &ctx)
+        {
+            std::array<vk::CommandBuffer, 2 * kMaxViews> secondaries;
+            uint32_t secondaryCount = 0;
+
+            for (uint32_t v = 0; v < static_cast<uint32_t>(viewTargets.size()); ++v)
+            {
+                const ViewTarget &target = viewTargets[v];
+                RenderQueue &queue = viewQueues[v];
+                const bool clearView = v > 0;
+                const bool hasQueued = queue.getDrawCount() > 0;
+
+                auto drawQueued = [&](vk::CommandBuffer cmd)
+                {
+                    cmd.setViewport(0, 1, &target.viewport);
+                    cmd.setScissor(0, 1, &target.scissor);
+                    if (clearView)
+                    {
+                        std::array<vk::ClearAttachment, 2> clears = {
+                            vk::ClearAttachment(vk::ImageAspectFlagBits::eColor, 0,
+                                                vk::ClearColorValue(std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f})),
+                            vk::ClearAttachment(vk::ImageAspectFlagBits::eDepth, 0,
+                                                vk::ClearDepthStencilValue(1.0f, 0))};
+                        vk::ClearRect rect(target.scissor, 0, 1);
+                        cmd.clearAttachments(static_cast<uint32_t>(clears.size()), clears.data(), 1, &rect);
+                    }
+                    renderObjects(cmd, queue, target.cameraOffset, indirectBuffer, indirectOffset, countOffset);
+                };
+                auto drawPerFrame = [&](vk::CommandBuffer cmd)
+                {
+                    if (drawAnimated)
+                    {
+                        animator->draw(cmd, target.cameraOffset, bindlessRef.getDescriptorSet());
+                        stats.add(animator->getStats());
+                    }
+                    if (drawParticles)
+                    {
+                        particles->draw(cmd, target.cameraOffset);
+                        ++stats.drawCalls;
+                    }
+                };
+
+                if (!commandCache)
+                {
+                    drawQueued(ctx.cmd);
+                    if (hasQueued)
+                        stats.add(queue.getStats());
+                    drawPerFrame(ctx.cmd);
+                    continue;
+                }
+
+                const uint32_t slot = (passIndex * kMaxViews + v) * 2;
+                if (hasQueued || clearView)
+                {
+                    // Everything the recorded commands reference; the draw data itself is rewritten every frame
+                    uint64_t key = queue.getSignature();
+                    key = hashValue(key, target.cameraOffset);
+                    key = hashValue(key, drawDataOffset);
+                    key = hashValue(key, static_cast<VkBuffer>(indirectBuffer));
+                    key = hashValue(key, indirectOffset);
+                    key = hashValue(key, countOffset);
+                    key = hashValue(key, static_cast<VkViewport>(target.viewport));
+                    key = hashValue(key, static_cast<VkRect2D>(target.scissor));
+                    key = hashValue(key, static_cast<VkFormat>(inheritance.colorFormat));
+                    key = hashValue(key, static_cast<VkFormat>(inheritance.depthFormat));
+                    key = hashValue(key, static_cast<VkSampleCountFlagBits>(inheritance.samples));
+
+                    FrameStats &recorded = recordedStats[frameIndex * kCommandSlots + slot];
+                    secondaries[secondaryCount++] =
+                        commandCache->reuse(frameIndex, slot, key, inheritance, [&](vk::CommandBuffer cmd)
+                                            {
+                                                drawQueued(cmd);
+                                                recorded = hasQueued ? queue.getStats() : FrameStats();
+                                            });
+                    stats.add(recorded);
+                }
+                if (drawAnimated || drawParticles)
+                {
+                    secondaries[secondaryCount++] =
+                        commandCache->record(frameIndex, slot + 1, inheritance, [&](vk::CommandBuffer cmd)
+                                             {
+                                                 cmd.setViewport(0, 1, &target.viewport);
+                                                 cmd.setScissor(0, 1, &target.scissor);
+                                                 drawPerFrame(cmd);
+                                             });
+                }
+            }
+            if (secondaryCount > 0)
+                ctx.cmd.executeCommands(secondaryCount, secondaries.data());
+        };
+    };
+
+    if (occlusionCuller)
+    {
+        // Phase 1: what was visible last frame. Phase 2: what the new depth pyramid reveals.
+        occlusionCuller->prepare(viewQueues[0], static_cast<uint32_t>(gameObjects.size()));
+
+        Handle visibility = renderGraph->importBuffer("visibility", occlusionCuller->getVisibilityBuffer(),
+                                                      vk::PipelineStageFlagBits2::eComputeShader,
+                                                      vk::AccessFlagBits2::eShaderStorageWrite);
+        Handle pyramid = renderGraph->importImage(
+            "depth-pyramid", occlusionCuller->getPyramidImage(), occlusionCuller->getPyramidView(),
+            {vk::Format::eR32Sfloat, occlusionCuller->getPyramidExtent()}, vk::ImageLayout::eUndefined,
+            vk::PipelineStageFlagBits2::eComputeShader);
+
+        const RGAccess cullWrite = RGAccess::storageWrite(vk::PipelineStageFlagBits2::eComputeShader);
+        RGAccess clearAndCull = cullWrite; // Visibility is cleared after (re)allocation
+        clearAndCull.stages |= vk::PipelineStageFlagBits2::eClear;
+        clearAndCull.access |= vk::AccessFlagBits2::eTransferWrite;
+
+        vk::Buffer indirectBuffer = occlusionCuller->getIndirectBuffer();
+
+        const vk::Rect2D scissor = viewTargets[0].scissor;
+        renderGraph->addPass("cull-early", [this, &mainCamera, scissor](const VulkanRenderGraph::PassContext &ctx)
+                             { occlusionCuller->cullEarly(ctx.cmd, mainCamera, scissor); })
+            .write(visibility, clearAndCull)
+            .write(ring, cullWrite);
+
+        auto sceneEarly =
+            renderGraph->addPass("scene-early", scenePass(indirectBuffer, occlusionCuller->getEarlyCommandsOffset(),
+                                                          occlusionCuller->getEarlyCountsOffset(), animating, false, 0))
+                .color(backbuffer)
+                .depth(depth)
+                .read(ring, RGAccess::drawInputs());
+        if (animating)
+            sceneEarly.read(instances, RGAccess::drawInputs());
+        if (commandCache)
+            sceneEarly.secondaryCommandBuffers();
+
+        renderGraph->addPass("depth-pyramid", [this](const VulkanRenderGraph::PassContext &ctx)
+                             { occlusionCuller->buildPyramid(ctx.cmd); })
+            .read(depth, RGAccess::sampled(vk::PipelineStageFlagBits2::eComputeShader))
+            .write(pyramid, cullWrite);
+
+        renderGraph->addPass("cull-late", [this, &mainCamera, scissor](const VulkanRenderGraph::PassContext &ctx)
+                             { occlusionCuller->cullLate(ctx.cmd, mainCamera, scissor); })
+            .read(pyramid, RGAccess::sampled(vk::PipelineStageFlagBits2::eComputeShader, vk::ImageLayout::eGeneral))
+            .write(visibility, cullWrite)
+            .write(ring, cullWrite);
+
+        auto sceneLate = renderGraph->addPass("scene-late", scenePass(indirectBuffer,
+                                                                      occlusionCuller->getLateCommandsOffset(),
+                                                                      occlusionCuller->getLateCountsOffset(), false,
+                                                                      particles != nullptr, 1))
+                             .color(backbuffer, vk::AttachmentLoadOp::eLoad)
+                             .depth(depth, vk::AttachmentLoadOp::eLoad)
+                             .read(ring, RGAccess::drawInputs());
+        if (particles)
+            sceneLate.read(particleBuffer, RGAccess::drawInputs());
+        if (commandCache)
+            sceneLate.secondaryCommandBuffers();
+    }
+    else
+    {
+        auto scene = renderGraph->addPass("scene", scenePass(vk::Buffer(), 0, 0, animating, particles != nullptr, 0));
+        if (samples != vk::SampleCountFlagBits::e1)
+        {
+            Handle msaaColor = renderGraph->importImage(
+                "msaa-color", swapchainRef.getMsaaColorImage(), swapchainRef.getMsaaColorImageView(),
+                {swapchainRef.getImageFormat(), extent, samples}, vk::ImageLayout::eUndefined,
+                vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentWrite);
+            scene.color(msaaColor).resolve(backbuffer);
+        }
+        else
+        {
+            scene.color(backbuffer);
         }
+        scene.depth(depth).read(ring, RGAccess::drawInputs());
+        if (animating)
+            scene.read(instances, RGAccess::drawInputs());
+        if (particles)
+            scene.read(particleBuffer, RGAccess::drawInputs());
+        if (commandCache)
+            scene.secondaryCommandBuffers();
+    }
+
+    // Over the resolved image, so the overlay is single-sampled and independent of the views
+    if (hud)
+    {
+        renderGraph->addPass("hud", [this](const VulkanRenderGraph::PassContext &ctx) { hud->draw(ctx.cmd); })
+            .color(backbuffer, vk::AttachmentLoadOp::eLoad)
+            .read(ring, RGAccess::drawInputs());
     }
+
+    // After the scene; the graph moves the backbuffer to transfer source and back to present
+    if (capture && capture->beginFrame(frameIndex))
+    {
+        const vk::Format format = swapchainRef.getImageFormat();
+        renderGraph->addPass("capture",
+                             [this, frameIndex, backbuffer, format, extent](const VulkanRenderGraph::PassContext &ctx)
+                             { capture->record(ctx.cmd, frameIndex, ctx.image(backbuffer), format, extent); })
+            .read(backbuffer, RGAccess::transferRead())
+            .sideEffects();
+    }
+
+    renderGraph->execute(cmd, frameIndex);
+
+    if (occlusionCuller)
+        stats.occlusionCulled = occlusionCuller->getCulledCount();
 }
 
 FrameResult VulkanFrame::draw(uint32_t &currentFrame)
@@ -122,26 +568,28 @@ FrameResult VulkanFrame::draw(uint32_t &currentFrame)
 
     (void)deviceRef.getLogicalDevice().resetFences(1, &syncRef.getInFlightFence(currentFrame));
 
+    // The fence guarantees the GPU is done with this frame's ring region and query
+    frameRingRef.beginFrame(currentFrame);
+    readStatsQuery(currentFrame);
+    renderGraph->collectTimings(currentFrame);
+    if (capture)
+        capture->collect(currentFrame);
+
+    if (occlusionCuller)
+        occlusionCuller->beginFrame(currentFrame);
+
     vk::CommandBuffer cmd = commandRef.getBuffer(currentFrame);
     cmd.reset();
 
     vk::CommandBufferBeginInfo beginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
     cmd.begin(beginInfo);
 
-    // Clear both color AND depth attachments
-    std::array<vk::ClearValue, 2> clearValues;
-    clearValues[0].color = vk::ClearColorValue(std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f});
-    clearValues[1].depthStencil = vk::ClearDepthStencilValue(1.0f, 0);
-
-    vk::RenderPassBeginInfo renderPassInfo;
-    renderPassInfo.renderPass = renderPassRef.get();
-    renderPassInfo.framebuffer = swapchainRef.getFramebuffer(imageIndex);
-    renderPassInfo.renderArea.offset = vk::Offset2D(0, 0);
-    renderPassInfo.renderArea.extent = swapchainRef.getExtent();
-    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-    renderPassInfo.pClearValues = clearValues.data();
-
-    cmd.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+    // Spans every scene pass of the frame
+    if (statsQueryPool)
+    {
+        cmd.resetQueryPool(statsQueryPool, currentFrame, 1);
+        cmd.beginQuery(statsQueryPool, currentFrame, {});
+    }
 
     // Setup viewport and scissor
     auto extent = swapchainRef.getExtent();
@@ -163,25 +611,66 @@ FrameResult VulkanFrame::draw(uint32_t &currentFrame)
     float vpX = (curW - vpW) * 0.5f;
     float vpY = (curH - vpH) * 0.5f;
 
-    vk::Viewport viewport(vpX, vpY, vpW, vpH, 0.0f, 1.0f);
-    cmd.setViewport(0, 1, &viewport);
+    // Each view's camera and rectangle within the letterboxed area. View and projection
+    // matrices are computed once per frame; the shader applies the model matrix.
+    const size_t viewCount = occlusionCuller ? 1 : views.size();
+    std::vector<CameraData> cameras(viewCount);
+    viewTargets.resize(viewCount);
+    uint64_t viewportPixels = 0;
+    for (size_t v = 0; v < viewCount; ++v)
+    {
+        const FrameView &view = views[v];
+        const float x = vpX + view.rect.x * vpW;
+        const float y = vpY + view.rect.y * vpH;
+        const float w = view.rect.z * vpW;
+        const float h = view.rect.w * vpH;
+
+        ViewTarget &target = viewTargets[v];
+        target.viewport = vk::Viewport(x, y, w, h, 0.0f, 1.0f);
+
+        // Rounding the edges rather than the size keeps adjacent views from overlapping
+        const int32_t left = static_cast<int32_t>(std::round(x));
+        const int32_t top = static_cast<int32_t>(std::round(y));
+        target.scissor = vk::Rect2D(vk::Offset2D(left, top),
+                                    vk::Extent2D(static_cast<uint32_t>(std::round(x + w)) - left,
+                                                 static_cast<uint32_t>(std::round(y + h)) - top));
+        viewportPixels += static_cast<uint64_t>(target.scissor.extent.width) * target.scissor.extent.height;
+
+        CameraData &camera = cameras[v];
+        camera.view = glm::lookAt(view.eye, view.target, glm::vec3(0.0f, 1.0f, 0.0f));
+        camera.proj = glm::perspective(glm::radians(view.fovY), targetAspect * view.rect.z / view.rect.w,
+                                       view.nearPlane, view.farPlane);
+        camera.proj[1][1] *= -1;
+        camera.viewProj = camera.proj * camera.view;
+
+        RingAllocation cameraAlloc = frameRingRef.allocateUniform(sizeof(CameraData));
+        std::memcpy(cameraAlloc.data, &camera, sizeof(CameraData));
+        target.cameraOffset = cameraAlloc.offset;
+    }
 
-    vk::Offset2D scOff(static_cast<int32_t>(std::round(vpX)), static_cast<int32_t>(std::round(vpY)));
-    vk::Extent2D scExt(static_cast<uint32_t>(std::round(vpW)), static_cast<uint32_t>(std::round(vpH)));
-    vk::Rect2D scissor(scOff, scExt);
-    cmd.setScissor(0, 1, &scissor);
+    prepareObjects(cameras);
+    if (hud)
+    {
+        std::optional<uint32_t> frustumCulled;
+        if (!occlusionCuller)
+            frustumCulled = visibility.getCulledCount(0);
+        hud->prepare(stats, static_cast<uint32_t>(gameObjects.size()), frustumCulled, extent);
+    }
+    stats = FrameStats();
 
-    // Compute view and projection matrices
-    glm::mat4 view = glm::lookAt(glm::vec3(3.0f, 3.0f, 3.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-    glm::mat4 proj = glm::perspective(glm::radians(45.0f), targetAspect, 0.1f, 100.0f);
-    proj[1][1] *= -1;
+    recordScene(cmd, imageIndex, currentFrame, cameras[0]);
 
-    // Render all objects (batched by material)
-    renderObjects(cmd, view, proj);
+    if (statsQueryPool)
+    {
+        cmd.endQuery(statsQueryPool, currentFrame);
+        statsQueryIssued[currentFrame] = true;
+    }
 
-    cmd.endRenderPass();
     cmd.end();
 
+    stats.fragmentInvocations = lastFragmentInvocations;
+    stats.viewportPixels = viewportPixels;
+
     vk::SubmitInfo submitInfo;
     vk::Semaphore waitSemaphores[] = {syncRef.getImageAvailableSemaphore(currentFrame)};
     vk::PipelineStageFlags waitStages[] = {vk::PipelineStageFlagBits::eColorAttachmentOutput};
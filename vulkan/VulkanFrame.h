@@ -3,12 +3,23 @@
 #include <vector>
 #include <memory>
 #include <glm/glm.hpp>
+#include "src/RenderQueue.h"
+#include "src/RenderSettings.h"
+#include "src/ViewVisibility.h"
 
 class VulkanDevice;
 class VulkanSwapchain;
-class VulkanRenderPass;
 class VulkanCommand;
 class VulkanSync;
+class VulkanFrameRing;
+class VulkanBindless;
+class VulkanOcclusionCuller;
+class VulkanRenderGraph;
+class VulkanFrameCapture;
+class VulkanInstanceAnimator;
+class VulkanParticleSystem;
+class VulkanHud;
+class VulkanCommandCache;
 class Mesh;
 class Material;
 struct GameObject;
@@ -19,39 +30,150 @@ enum class FrameResult
     SwapchainOutOfDate
 };
 
+struct CameraData;
+
+// A camera and the part of the (letterboxed) frame it renders to
+struct FrameView
+{
+    glm::vec3 eye = glm::vec3(3.0f, 3.0f, 3.0f);
+    glm::vec3 target = glm::vec3(0.0f);
+    float fovY = 45.0f; // Degrees
+    float nearPlane = 0.1f;
+    float farPlane = 100.0f;
+    glm::vec4 rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f); // x, y, width, height as fractions of the frame
+};
+
 class VulkanFrame
 {
 public:
     VulkanFrame(const VulkanDevice &device,
                 const VulkanSwapchain &swapchain,
-                const VulkanRenderPass &renderPass,
                 VulkanCommand &command,
                 VulkanSync &sync,
-                uint32_t maxFramesInFlight);
+                VulkanFrameRing &frameRing,
+                const VulkanBindless &bindless,
+                uint32_t maxFramesInFlight,
+                const RenderSettings &settings = RenderSettings());
+    ~VulkanFrame();
+
+    // Delete copy operations
+    VulkanFrame(const VulkanFrame &) = delete;
+    VulkanFrame &operator=(const VulkanFrame &) = delete;
 
     FrameResult draw(uint32_t &currentFrame);
 
     // Add/remove game objects
     void addGameObject(GameObject *obj);
+    void removeGameObjects(const std::vector<GameObject *> &objects); // One pass over the list
     void clearGameObjects();
 
-    // Update target aspect ratio (call after swapchain recreation)
+    // Call after changing any object's transform, mesh, material or enabled flag. Until
+    // then each frame reuses the previous frame's culling, queues and draw data unless a
+    // view has moved.
+    void markObjectsChanged() { objectsChanged = true; }
+
+    // Where the main view's camera sits and looks (defaults to the demo's fixed view)
+    void setCamera(const glm::vec3 &eye, const glm::vec3 &target);
+    const glm::vec3 &getCameraPosition() const { return views[0].eye; }
+
+    // Views drawn in order, each over the ones before it (split-screen, picture-in-picture).
+    // View 0 is the main view. They share one visibility pass and one set of per-draw data;
+    // each records its own draws. With occlusion culling only the main view is drawn.
+    static constexpr uint32_t kMaxViews = 4;
+    void setViews(const std::vector<FrameView> &frameViews);
+    const std::vector<FrameView> &getViews() const { return views; }
+
+    // Update target aspect ratio and drop prerecorded commands (call after swapchain recreation)
     void updateTargetAspect();
 
+    // Split the scene into two passes around GPU occlusion culling (nullptr: single pass)
+    void setOcclusionCulling(VulkanOcclusionCuller *culler);
+
+    // Copy presented frames into the capture's readback ring (nullptr: no capture)
+    void setCapture(VulkanFrameCapture *frameCapture);
+
+    // GPU-animated instance groups, drawn after the queued objects (nullptr: none)
+    void setAnimator(VulkanInstanceAnimator *instanceAnimator);
+
+    // GPU particles, simulated before the scene and blended over it (nullptr: none)
+    void setParticles(VulkanParticleSystem *particleSystem);
+
+    // Performance overlay drawn over the finished image, showing last frame's stats (nullptr: none)
+    void setHud(VulkanHud *overlay);
+
+    const FrameStats &getStats() const { return stats; }
+    const VulkanRenderGraph &getRenderGraph() const { return *renderGraph; }
+    const VulkanCommandCache *getCommandCache() const { return commandCache.get(); } // Null unless prerecording
+
 private:
     const VulkanDevice &deviceRef;
     const VulkanSwapchain &swapchainRef;
-    const VulkanRenderPass &renderPassRef;
     VulkanCommand &commandRef;
     VulkanSync &syncRef;
+    VulkanFrameRing &frameRingRef;
+    const VulkanBindless &bindlessRef;
 
     std::vector<GameObject *> gameObjects;
 
     const uint32_t maxFramesInFlight;
+    const bool sortDraws;
     float targetAspect = 1.0f;
+    FrameStats stats;
+
+    std::vector<FrameView> views;
+    std::vector<RenderQueue> viewQueues; // One per view
+    ViewVisibility visibility;
+    std::vector<glm::mat4> viewProjs;    // Scratch for the visibility pass
+
+    // Where each view drawn this frame renders
+    struct ViewTarget
+    {
+        uint32_t cameraOffset = 0; // Dynamic offset of the view's CameraData in the frame ring
+        vk::Viewport viewport;
+        vk::Rect2D scissor;
+    };
+    std::vector<ViewTarget> viewTargets;
+
+    // One fragment-invocation query per frame in flight (null without pipelineStatisticsQuery)
+    vk::QueryPool statsQueryPool;
+    std::vector<bool> statsQueryIssued;
+    uint64_t lastFragmentInvocations = 0;
+
+    void readStatsQuery(uint32_t frame);
+
+    VulkanOcclusionCuller *occlusionCuller = nullptr;
+    VulkanFrameCapture *capture = nullptr;
+    VulkanInstanceAnimator *animator = nullptr;
+    VulkanParticleSystem *particles = nullptr;
+    VulkanHud *hud = nullptr;
+
+    // Rebuilt every frame; records the scene passes and the barriers between them
+    std::unique_ptr<VulkanRenderGraph> renderGraph;
+
+    // Prerecorded scene draws (settings.prerecordDraws). Per frame in flight, each view in
+    // each of the up to two scene passes has a cached slot for the queued draws and a slot
+    // re-recorded every frame for animated instances and particles.
+    static constexpr uint32_t kCommandSlots = 2 * kMaxViews * 2;
+    std::unique_ptr<VulkanCommandCache> commandCache;
+    std::vector<FrameStats> recordedStats; // Stats of each cached slot's recording
+
+    // Culls for every view, builds their render queues and uploads per-draw data for this
+    // frame; rebuilds only when the objects or the views changed since the last build
+    void prepareObjects(const std::vector<CameraData> &cameras);
+    void buildQueues(const std::vector<CameraData> &cameras);
+    uint32_t drawDataOffset = 0;
+    std::vector<DrawData> drawData; // Last build's, copied into each frame's ring space
+    std::vector<glm::mat4> preparedViewProjs;
+    bool preparedForOcclusion = false;
+    bool objectsChanged = true;
+
+    // Records a view's queued draws (from the culler's compacted commands and counts when
+    // a buffer is given). cameraOffset is the dynamic offset of the view's CameraData in the frame ring.
+    void renderObjects(vk::CommandBuffer cmd, RenderQueue &queue, uint32_t cameraOffset,
+                       vk::Buffer indirectBuffer = {}, vk::DeviceSize indirectOffset = 0,
+                       vk::DeviceSize countOffset = 0);
 
-    // Helper to batch objects by material for efficient rendering
-    void renderObjects(vk::CommandBuffer cmd,
-                       const glm::mat4 &view,
-                       const glm::mat4 &proj);
+    // Declares this frame's passes and records them through the render graph (the occlusion
+    // culler sees the main view's camera)
+    void recordScene(vk::CommandBuffer cmd, uint32_t imageIndex, uint32_t frameIndex, const CameraData &mainCamera);
 };
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include "VulkanFrameCapture.h"
+#include "VulkanDevice.h"
+#include "VulkanDebug.h"
+#include "src/PngWriter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+    bool isBgra(vk::Format format)
+    {
+        return format == vk::Format::eB8G8R8A8Srgb || format == vk::Format::eB8G8R8A8Unorm;
+    }
+}
+
+VulkanFrameCapture::VulkanFrameCapture(const VulkanDevice &device, uint32_t maxFramesInFlight, uint32_t interval)
+    : deviceRef(device), interval(std::max(interval, 1u)), slots(maxFramesInFlight)
+{
+    worker = std::thread(&VulkanFrameCapture::workerLoop, this);
+}
+
+VulkanFrameCapture::~VulkanFrameCapture()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    if (worker.joinable())
+        worker.join();
+
+    for (auto &slot : slots)
+        destroySlot(slot);
+}
+
+void VulkanFrameCapture::setCallback(Callback newCallback)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    callback = std::move(newCallback);
+}
+
+void VulkanFrameCapture::setOutputDirectory(const std::string &directory, CaptureFileFormat format)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    outputDirectory = directory;
+    fileFormat = format;
+}
+
+bool VulkanFrameCapture::supportsFormat(vk::Format format)
+{
+    switch (format)
+    {
+    case vk::Format::eB8G8R8A8Srgb:
+    case vk::Format::eB8G8R8A8Unorm:
+    case vk::Format::eR8G8B8A8Srgb:
+    case vk::Format::eR8G8B8A8Unorm:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void VulkanFrameCapture::collect(uint32_t frameIndex)
+{
+    Slot &slot = slots[frameIndex];
+    if (slot.state.load() != SlotState::Recorded)
+        return;
+
+    // The fence has been waited on, so the copy is complete; make it visible to the host
+    if (!slot.coherent)
+        deviceRef.getLogicalDevice().invalidateMappedMemoryRanges(vk::MappedMemoryRange(slot.memory, 0, VK_WHOLE_SIZE));
+
+    slot.state = SlotState::Processing;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(frameIndex);
+        ++jobsQueued;
+    }
+    jobReady.notify_one();
+}
+
+bool VulkanFrameCapture::beginFrame(uint32_t frameIndex)
+{
+    bool wanted = frameNumber++ % interval == 0;
+    if (!wanted)
+        return false;
+
+    // The worker still owns this slot: drop the frame rather than stall the render loop
+    if (slots[frameIndex].state.load() != SlotState::Idle)
+    {
+        ++dropped;
+        return false;
+    }
+    return true;
+}
+
+void VulkanFrameCapture::record(vk::CommandBuffer cmd, uint32_t frameIndex, vk::Image image, vk::Format format,
+                                vk::Extent2D extent)
+{
+    Slot &slot = slots[frameIndex];
+    if (!supportsFormat(format) || slot.state.load() != SlotState::Idle)
+        return;
+
+    const uint32_t rowPitch = extent.width * 4;
+    ensureCapacity(slot, static_cast<vk::DeviceSize>(rowPitch) * extent.height);
+
+    vk::BufferImageCopy region(0, 0, 0, vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1),
+                               vk::Offset3D(0, 0, 0), vk::Extent3D(extent.width, extent.height, 1));
+    cmd.copyImageToBuffer(image, vk::ImageLayout::eTransferSrcOptimal, slot.buffer, region);
+
+    // Host reads happen after the fence wait, but the write still needs a host-visibility barrier
+    vk::MemoryBarrier2 toHost(vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferWrite,
+                              vk::PipelineStageFlagBits2::eHost, vk::AccessFlagBits2::eHostRead);
+    cmd.pipelineBarrier2(vk::DependencyInfo({}, toHost, nullptr, nullptr));
+
+    slot.frame.pixels = slot.mapped;
+    slot.frame.width = extent.width;
+    slot.frame.height = extent.height;
+    slot.frame.rowPitch = rowPitch;
+    slot.frame.format = format;
+    slot.frame.frameNumber = frameNumber - 1;
+    slot.state = SlotState::Recorded;
+    ++captured;
+}
+
+void VulkanFrameCapture::flush()
+{
+    // The device is idle, so copies still waiting on a fence are complete too
+    for (uint32_t i = 0; i < slots.size(); ++i)
+        collect(i);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    jobDone.wait(lock, [this]
+                 { return jobsFinished == jobsQueued; });
+}
+
+void VulkanFrameCapture::ensureCapacity(Slot &slot, vk::DeviceSize size)
+{
+    if (slot.size >= size)
+        return;
+
+    // Only called on idle slots, so no copy or worker can still be using the old buffer
+    destroySlot(slot);
+
+    auto device = deviceRef.getLogicalDevice();
+    vk::BufferCreateInfo bufferInfo({}, size, vk::BufferUsageFlagBits::eTransferDst, vk::SharingMode::eExclusive);
+    slot.buffer = device.createBuffer(bufferInfo);
+    VK_DEBUG_NAME(device, slot.buffer, "capture readback", static_cast<uint32_t>(&slot - slots.data()));
+
+    auto memReq = device.getBufferMemoryRequirements(slot.buffer);
+    auto memProps = deviceRef.getPhysicalDevice().getMemoryProperties();
+
+    // Cached memory makes the worker's reads fast; coherent-only memory is the fallback
+    uint32_t memoryType = deviceRef.findMemoryType(
+        memReq.memoryTypeBits,
+        {vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCached,
+         vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent});
+    if (memoryType == UINT32_MAX)
+        throw std::runtime_error("No host-visible memory type for frame capture");
+
+    slot.memory = deviceRef.allocateMemory(vk::MemoryAllocateInfo(memReq.size, memoryType), MemoryCategory::FrameData);
+    device.bindBufferMemory(slot.buffer, slot.memory, 0);
+    slot.mapped = static_cast<uint8_t *>(device.mapMemory(slot.memory, 0, VK_WHOLE_SIZE));
+    slot.coherent = static_cast<bool>(memProps.memoryTypes[memoryType].propertyFlags &
+                                      vk::MemoryPropertyFlagBits::eHostCoherent);
+    slot.size = size;
+}
+
+void VulkanFrameCapture::destroySlot(Slot &slot)
+{
+    auto device = deviceRef.getLogicalDevice();
+    if (slot.mapped)
+        device.unmapMemory(slot.memory);
+    if (slot.buffer)
+        device.destroyBuffer(slot.buffer);
+    deviceRef.freeMemory(slot.memory);
+    slot.mapped = nullptr;
+    slot.buffer = nullptr;
+    slot.memory = nullptr;
+    slot.size = 0;
+}
+
+void VulkanFrameCapture::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;)
+    {
+        jobReady.wait(lock, [this]
+                      { return stopping || !jobs.empty(); });
+        if (jobs.empty())
+            return; // Stopping with nothing left to do
+
+        uint32_t index = jobs.front();
+        jobs.pop_front();
+
+        lock.unlock();
+        process(slots[index]);
+        slots[index].state = SlotState::Idle;
+        lock.lock();
+
+        ++jobsFinished;
+        jobDone.notify_all();
+    }
+}
+
+void VulkanFrameCapture::process(const Slot &slot)
+{
+    const CapturedFrame &frame = slot.frame;
+
+    // Settings are only changed before capture starts; copy under the lock anyway
+    Callback cb;
+    std::string directory;
+    CaptureFileFormat format;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        cb = callback;
+        directory = outputDirectory;
+        format = fileFormat;
+    }
+
+    if (cb)
+        cb(frame);
+    if (directory.empty())
+        return;
+
+    char name[64];
+    if (format == CaptureFileFormat::Png)
+    {
+        std::snprintf(name, sizeof(name), "/frame_%06llu.png", static_cast<unsigned long long>(frame.frameNumber));
+        if (!PngWriter::write(directory + name, frame.width, frame.height, frame.pixels, frame.rowPitch,
+                              isBgra(frame.format)))
+            std::cerr << "Frame capture: failed to write " << directory + name << std::endl;
+    }
+    else
+    {
+        std::snprintf(name, sizeof(name), "/frame_%06llu_%ux%u.raw", static_cast<unsigned long long>(frame.frameNumber),
+                      frame.width, frame.height);
+        std::ofstream file(directory + name, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(frame.pixels),
+                   static_cast<std::streamsize>(frame.rowPitch) * frame.height);
+        if (!file)
+            std::cerr << "Frame capture: failed to write " << directory + name << std::endl;
+    }
+}
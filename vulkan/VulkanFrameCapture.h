@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class VulkanDevice;
+
+// A frame read back to the CPU. pixels are only valid during the callback.
+struct CapturedFrame
+{
+    const uint8_t *pixels = nullptr;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t rowPitch = 0;
+    vk::Format format = vk::Format::eUndefined; // 8-bit RGBA or BGRA
+    uint64_t frameNumber = 0;
+};
+
+enum class CaptureFileFormat
+{
+    Png,
+    Raw // Tightly packed texels in the image's channel order, size in the file name
+};
+
+// Pipelined frame readback. record() copies the rendered image into a host-visible
+// buffer owned by that frame-in-flight slot; once the slot's fence has been waited on
+// (maxFramesInFlight frames later), collect() hands the buffer to a worker thread that
+// runs the callback or writes a file and then releases the slot. The render thread never
+// waits: a frame whose slot is still being processed is simply not captured.
+class VulkanFrameCapture
+{
+public:
+    using Callback = std::function<void(const CapturedFrame &)>;
+
+    // Every `interval`-th frame is captured
+    VulkanFrameCapture(const VulkanDevice &device, uint32_t maxFramesInFlight, uint32_t interval = 1);
+    ~VulkanFrameCapture();
+
+    VulkanFrameCapture(const VulkanFrameCapture &) = delete;
+    VulkanFrameCapture &operator=(const VulkanFrameCapture &) = delete;
+
+    // Where captures go: a callback (runs on the worker thread) or files in a directory
+    void setCallback(Callback callback);
+    void setOutputDirectory(const std::string &directory, CaptureFileFormat format = CaptureFileFormat::Png);
+
+    static bool supportsFormat(vk::Format format);
+
+    // Call after the frame's fence wait: queues that frame's readback for the worker
+    void collect(uint32_t frameIndex);
+
+    // Advances the frame counter; true if this frame should be captured and its slot is free
+    bool beginFrame(uint32_t frameIndex);
+
+    // Records the copy (image must be in eTransferSrcOptimal) and the host-read barrier
+    void record(vk::CommandBuffer cmd, uint32_t frameIndex, vk::Image image, vk::Format format, vk::Extent2D extent);
+
+    // After waitIdle: collects every outstanding copy and blocks until the worker is done
+    void flush();
+
+    uint64_t getCapturedCount() const { return captured; }
+    uint64_t getDroppedCount() const { return dropped; }
+
+private:
+    enum class SlotState
+    {
+        Idle,       // Free for a new capture
+        Recorded,   // Copy recorded; waiting for the frame's fence
+        Processing  // Owned by the worker
+    };
+
+    struct Slot
+    {
+        vk::Buffer buffer;
+        vk::DeviceMemory memory;
+        uint8_t *mapped = nullptr;
+        vk::DeviceSize size = 0;
+        bool coherent = true;
+        CapturedFrame frame;
+        std::atomic<SlotState> state{SlotState::Idle};
+    };
+
+    void ensureCapacity(Slot &slot, vk::DeviceSize size);
+    void destroySlot(Slot &slot);
+    void workerLoop();
+    void process(const Slot &slot);
+
+    const VulkanDevice &deviceRef;
+    const uint32_t interval;
+    std::vector<Slot> slots; // One per frame in flight
+    uint64_t frameNumber = 0;
+    uint64_t captured = 0;
+    uint64_t dropped = 0;
+
+    Callback callback;
+    std::string outputDirectory;
+    CaptureFileFormat fileFormat = CaptureFileFormat::Png;
+
+    // Worker thread
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable jobReady;
+    std::condition_variable jobDone;
+    std::deque<uint32_t> jobs;
+    uint64_t jobsQueued = 0;
+    uint64_t jobsFinished = 0;
+    bool stopping = false;
+};
@@ -0,0 +1,142 @@
+#include "VulkanFrameRing.h"
+#include "VulkanDevice.h"
+#include "VulkanDebug.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+VulkanFrameRing::VulkanFrameRing(const VulkanDevice &device,
+                                 uint32_t maxFramesInFlight,
+                                 vk::DeviceSize bytesPerFrame)
+    : deviceRef(device), frameCount(maxFramesInFlight), bytesPerFrame(bytesPerFrame)
+{
+    auto limits = deviceRef.getPhysicalDevice().getProperties().limits;
+    uniformAlignment = std::max<vk::DeviceSize>(limits.minUniformBufferOffsetAlignment, 16);
+    storageAlignment = std::max<vk::DeviceSize>(limits.minStorageBufferOffsetAlignment, 16);
+    storageWindow = std::min<vk::DeviceSize>(bytesPerFrame, limits.maxStorageBufferRange);
+
+    createBuffer();
+    createDescriptors();
+}
+
+VulkanFrameRing::~VulkanFrameRing()
+{
+    auto device = deviceRef.getLogicalDevice();
+    if (descriptorPool)
+        device.destroyDescriptorPool(descriptorPool);
+    if (setLayout)
+        device.destroyDescriptorSetLayout(setLayout);
+    if (mapped)
+        device.unmapMemory(memory);
+    if (buffer)
+        device.destroyBuffer(buffer);
+    deviceRef.freeMemory(memory);
+}
+
+void VulkanFrameRing::createBuffer()
+{
+    auto device = deviceRef.getLogicalDevice();
+
+    // Pad the tail by the storage window so a dynamic offset near the end of the
+    // last frame's region still has a full descriptor range behind it
+    vk::DeviceSize size = bytesPerFrame * frameCount + storageWindow;
+
+    vk::BufferCreateInfo bufferInfo({}, size,
+                                    vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer |
+                                        vk::BufferUsageFlagBits::eIndirectBuffer |
+                                        vk::BufferUsageFlagBits::eVertexBuffer,
+                                    vk::SharingMode::eExclusive);
+    buffer = device.createBuffer(bufferInfo);
+    VK_DEBUG_NAME(device, buffer, "frame ring");
+
+    auto memReq = device.getBufferMemoryRequirements(buffer);
+
+    // Prefer device-local host-visible memory (BAR/unified) and fall back to plain host memory
+    const vk::MemoryPropertyFlags hostFlags = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+    uint32_t memoryType = deviceRef.findMemoryType(memReq.memoryTypeBits,
+                                                   {hostFlags | vk::MemoryPropertyFlagBits::eDeviceLocal, hostFlags});
+    if (memoryType == UINT32_MAX)
+        throw std::runtime_error("failed to find host-visible memory for frame ring!");
+
+    vk::MemoryAllocateInfo allocInfo(memReq.size, memoryType);
+    memory = deviceRef.allocateMemory(allocInfo, MemoryCategory::FrameData);
+    device.bindBufferMemory(buffer, memory, 0);
+
+    mapped = static_cast<uint8_t *>(device.mapMemory(memory, 0, VK_WHOLE_SIZE));
+}
+
+void VulkanFrameRing::createDescriptors()
+{
+    auto device = deviceRef.getLogicalDevice();
+
+    std::array<vk::DescriptorSetLayoutBinding, 2> bindings = {
+        vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eUniformBufferDynamic, 1,
+                                       vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment),
+        vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageBufferDynamic, 1,
+                                       vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment)};
+
+    vk::DescriptorSetLayoutCreateInfo layoutInfo({}, static_cast<uint32_t>(bindings.size()), bindings.data());
+    setLayout = device.createDescriptorSetLayout(layoutInfo);
+    VK_DEBUG_NAME(device, setLayout, "frame ring set layout");
+
+    std::array<vk::DescriptorPoolSize, 2> poolSizes = {
+        vk::DescriptorPoolSize(vk::DescriptorType::eUniformBufferDynamic, 1),
+        vk::DescriptorPoolSize(vk::DescriptorType::eStorageBufferDynamic, 1)};
+
+    vk::DescriptorPoolCreateInfo poolInfo({}, 1, static_cast<uint32_t>(poolSizes.size()), poolSizes.data());
+    descriptorPool = device.createDescriptorPool(poolInfo);
+    VK_DEBUG_NAME(device, descriptorPool, "frame ring pool");
+
+    vk::DescriptorSetAllocateInfo allocInfo(descriptorPool, 1, &setLayout);
+    descriptorSet = device.allocateDescriptorSets(allocInfo)[0];
+    VK_DEBUG_NAME(device, descriptorSet, "frame ring set");
+
+    // A single set covers every frame: the dynamic offsets select the region
+    vk::DescriptorBufferInfo cameraInfo(buffer, 0, sizeof(CameraData));
+    vk::DescriptorBufferInfo storageInfo(buffer, 0, storageWindow);
+
+    std::array<vk::WriteDescriptorSet, 2> writes = {
+        vk::WriteDescriptorSet(descriptorSet, 0, 0, 1, vk::DescriptorType::eUniformBufferDynamic, nullptr, &cameraInfo),
+        vk::WriteDescriptorSet(descriptorSet, 1, 0, 1, vk::DescriptorType::eStorageBufferDynamic, nullptr, &storageInfo)};
+
+    device.updateDescriptorSets(writes, nullptr);
+}
+
+void VulkanFrameRing::beginFrame(uint32_t frameIndex)
+{
+    frameBase = bytesPerFrame * (frameIndex % frameCount);
+    cursor = 0;
+}
+
+RingAllocation VulkanFrameRing::allocateUniform(vk::DeviceSize size)
+{
+    return allocate(size, uniformAlignment);
+}
+
+RingAllocation VulkanFrameRing::allocateStorage(vk::DeviceSize size)
+{
+    if (size > storageWindow)
+        throw std::runtime_error("frame ring storage allocation exceeds the descriptor window!");
+    return allocate(size, storageAlignment);
+}
+
+RingAllocation VulkanFrameRing::allocateVertices(vk::DeviceSize size)
+{
+    // Attribute offsets only need their component alignment; 16 covers every format
+    return allocate(size, 16);
+}
+
+RingAllocation VulkanFrameRing::allocate(vk::DeviceSize size, vk::DeviceSize alignment)
+{
+    vk::DeviceSize offset = (cursor + alignment - 1) / alignment * alignment;
+    if (offset + size > bytesPerFrame)
+        throw std::runtime_error("frame ring exhausted for this frame!");
+
+    cursor = offset + size;
+
+    RingAllocation alloc;
+    alloc.offset = static_cast<uint32_t>(frameBase + offset);
+    alloc.data = mapped + frameBase + offset;
+    return alloc;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+#include <glm/glm.hpp>
+
+class VulkanDevice;
+
+// Shader-visible layouts (must match set 0 in shaders/cube.vert)
+struct CameraData
+{
+    glm::mat4 view;
+    glm::mat4 proj;
+    glm::mat4 viewProj;
+};
+
+struct DrawData
+{
+    glm::mat4 model;
+};
+
+struct DrawPushConstants
+{
+    uint32_t drawIndex = 0;
+    uint32_t materialId = 0; // Index into the bindless material table (set 1)
+};
+
+struct RingAllocation
+{
+    void *data = nullptr;
+    uint32_t offset = 0; // Byte offset from the start of the ring buffer (usable as a dynamic offset)
+};
+
+// Persistently mapped, per-frame ring for data written by the CPU once per frame
+// (and small per-frame GPU outputs such as culling results and indirect commands).
+// Each frame in flight owns one region of the buffer; allocations are bumped from
+// the current region and reset when the frame index comes around again.
+class VulkanFrameRing
+{
+public:
+    VulkanFrameRing(const VulkanDevice &device,
+                    uint32_t maxFramesInFlight,
+                    vk::DeviceSize bytesPerFrame = 8 * 1024 * 1024);
+    ~VulkanFrameRing();
+
+    VulkanFrameRing(const VulkanFrameRing &) = delete;
+    VulkanFrameRing &operator=(const VulkanFrameRing &) = delete;
+
+    // Call once the frame's in-flight fence has been waited on
+    void beginFrame(uint32_t frameIndex);
+
+    RingAllocation allocateUniform(vk::DeviceSize size);
+    RingAllocation allocateStorage(vk::DeviceSize size);
+    RingAllocation allocateVertices(vk::DeviceSize size); // Bind getBuffer() at the returned offset
+
+    vk::Buffer getBuffer() const { return buffer; }
+    vk::DescriptorSetLayout getSetLayout() const { return setLayout; }
+    vk::DescriptorSet getDescriptorSet() const { return descriptorSet; }
+    vk::DeviceSize getStorageWindow() const { return storageWindow; }
+
+private:
+    void createBuffer();
+    void createDescriptors();
+    RingAllocation allocate(vk::DeviceSize size, vk::DeviceSize alignment);
+
+    const VulkanDevice &deviceRef;
+
+    vk::Buffer buffer;
+    vk::DeviceMemory memory;
+    uint8_t *mapped = nullptr;
+
+    vk::DescriptorSetLayout setLayout;
+    vk::DescriptorPool descriptorPool;
+    vk::DescriptorSet descriptorSet;
+
+    const uint32_t frameCount;
+    const vk::DeviceSize bytesPerFrame;
+    vk::DeviceSize storageWindow = 0; // Range of the dynamic storage binding
+    vk::DeviceSize uniformAlignment = 256;
+    vk::DeviceSize storageAlignment = 256;
+
+    vk::DeviceSize frameBase = 0;
+    vk::DeviceSize cursor = 0;
+};
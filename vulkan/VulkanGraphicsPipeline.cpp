@@ -1,23 +1,55 @@
 #include "VulkanGraphicsPipeline.h"
 #include "VulkanDevice.h"
-#include "VulkanRenderPass.h"
 #include "VulkanShader.h"
-#include <glm/mat4x4.hpp>
+#include "VulkanFrameRing.h"
+#include "VulkanDebug.h"
+
+#include <array>
+#include <cstddef>
+
+namespace
+{
+    // Specialization data: one VkBool32 per feature bit, then the position scale
+    struct SpecializationData
+    {
+        std::array<vk::Bool32, kShaderFeatureCount> features;
+        float positionScale;
+    };
+
+    constexpr uint32_t kPositionScaleConstantId = kShaderFeatureCount;
+}
 
 VulkanGraphicsPipeline::VulkanGraphicsPipeline(const VulkanDevice &device,
-                                               const VulkanRenderPass &renderPass,
+                                               const RenderTargetFormats &targets,
                                                const VulkanShader &shader,
+                                               const PipelineDesc &desc,
                                                const vk::VertexInputBindingDescription *bindingDesc,
                                                uint32_t attributeCount,
-                                               const vk::VertexInputAttributeDescription *attributeDesc)
+                                               const vk::VertexInputAttributeDescription *attributeDesc,
+                                               uint32_t setLayoutCount,
+                                               const vk::DescriptorSetLayout *setLayouts)
     : deviceRef(device)
 {
-    // Shader stages
+    // Feature flags become specialization constants; the driver drops the dead branches
+    SpecializationData specData;
+    std::array<vk::SpecializationMapEntry, kShaderFeatureCount + 1> specEntries;
+    for (uint32_t i = 0; i < kShaderFeatureCount; ++i)
+    {
+        specData.features[i] = (desc.features & (1u << i)) ? VK_TRUE : VK_FALSE;
+        specEntries[i] = vk::SpecializationMapEntry(i, static_cast<uint32_t>(i * sizeof(vk::Bool32)), sizeof(vk::Bool32));
+    }
+    specData.positionScale = desc.positionScale;
+    specEntries[kShaderFeatureCount] = vk::SpecializationMapEntry(
+        kPositionScaleConstantId, static_cast<uint32_t>(offsetof(SpecializationData, positionScale)), sizeof(float));
+    vk::SpecializationInfo specInfo(static_cast<uint32_t>(specEntries.size()), specEntries.data(),
+                                    sizeof(specData), &specData);
+
+    // Shader stages (constants a stage doesn't declare are ignored)
     vk::PipelineShaderStageCreateInfo vertStageInfo(
-        {}, vk::ShaderStageFlagBits::eVertex, shader.getVertexModule(), "main");
+        {}, vk::ShaderStageFlagBits::eVertex, shader.getVertexModule(), "main", &specInfo);
 
     vk::PipelineShaderStageCreateInfo fragStageInfo(
-        {}, vk::ShaderStageFlagBits::eFragment, shader.getFragmentModule(), "main");
+        {}, vk::ShaderStageFlagBits::eFragment, shader.getFragmentModule(), "main", &specInfo);
 
     vk::PipelineShaderStageCreateInfo shaderStages[] = {vertStageInfo, fragStageInfo};
 
@@ -41,17 +73,15 @@ VulkanGraphicsPipeline::VulkanGraphicsPipeline(const VulkanDevice &device,
     vk::PipelineViewportStateCreateInfo viewportState({}, 1, nullptr, 1, nullptr);
 
     vk::PipelineRasterizationStateCreateInfo rasterizer(
-        {}, false, false, vk::PolygonMode::eFill, vk::CullModeFlagBits::eBack,
-        vk::FrontFace::eCounterClockwise, false, 0.0f, 0.0f, 0.0f, 1.0f);
+        {}, false, false, desc.polygonMode, desc.cullMode, desc.frontFace, false, 0.0f, 0.0f, 0.0f, 1.0f);
 
-    vk::PipelineMultisampleStateCreateInfo multisampling({}, vk::SampleCountFlagBits::e1, false);
+    vk::PipelineMultisampleStateCreateInfo multisampling({}, targets.samples, false);
 
-    // Enable depth testing
     vk::PipelineDepthStencilStateCreateInfo depthStencil(
         {},
-        true,                 // depthTestEnable
-        true,                 // depthWriteEnable
-        vk::CompareOp::eLess, // depthCompareOp
+        desc.depthTest,       // depthTestEnable
+        desc.depthWrite,      // depthWriteEnable
+        desc.depthCompare,    // depthCompareOp
         false,                // depthBoundsTestEnable
         false,                // stencilTestEnable
         {},                   // front
@@ -65,14 +95,28 @@ VulkanGraphicsPipeline::VulkanGraphicsPipeline(const VulkanDevice &device,
                                           vk::ColorComponentFlagBits::eG |
                                           vk::ColorComponentFlagBits::eB |
                                           vk::ColorComponentFlagBits::eA;
-    colorBlendAttachment.blendEnable = false;
+    colorBlendAttachment.blendEnable = desc.alphaBlend;
+    if (desc.alphaBlend)
+    {
+        colorBlendAttachment.srcColorBlendFactor = vk::BlendFactor::eSrcAlpha;
+        colorBlendAttachment.dstColorBlendFactor = desc.additive ? vk::BlendFactor::eOne
+                                                                 : vk::BlendFactor::eOneMinusSrcAlpha;
+        colorBlendAttachment.colorBlendOp = vk::BlendOp::eAdd;
+        colorBlendAttachment.srcAlphaBlendFactor = vk::BlendFactor::eOne;
+        colorBlendAttachment.dstAlphaBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha;
+        colorBlendAttachment.alphaBlendOp = vk::BlendOp::eAdd;
+    }
 
     vk::PipelineColorBlendStateCreateInfo colorBlending({}, false, vk::LogicOp::eCopy, 1, &colorBlendAttachment);
 
-    // Pipeline layout (no descriptor sets yet). Add a push-constant range for a 4x4 matrix (mat4 = 16 floats).
-    vk::PushConstantRange pushRange(vk::ShaderStageFlagBits::eVertex, 0, static_cast<uint32_t>(sizeof(glm::mat4)));
-    vk::PipelineLayoutCreateInfo pipelineLayoutInfo({}, 0, nullptr, 1, &pushRange);
+    // Pipeline layout: caller-provided descriptor sets (set 0 = frame ring, set 1 = bindless) plus the per-draw push constants
+    vk::PushConstantRange pushRange(vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0, static_cast<uint32_t>(sizeof(DrawPushConstants)));
+    vk::PipelineLayoutCreateInfo pipelineLayoutInfo({}, setLayoutCount, setLayouts, 1, &pushRange);
     pipelineLayout = deviceRef.getLogicalDevice().createPipelineLayout(pipelineLayoutInfo);
+    VK_DEBUG_NAME(deviceRef.getLogicalDevice(), pipelineLayout, "graphics pipeline layout");
+
+    // Attachment formats replace the render pass (vkCmdBeginRendering)
+    vk::PipelineRenderingCreateInfo renderingInfo(0, 1, &targets.color, targets.depth, vk::Format::eUndefined);
 
     // Graphics pipeline
     vk::GraphicsPipelineCreateInfo pipelineInfo(
@@ -88,9 +132,10 @@ VulkanGraphicsPipeline::VulkanGraphicsPipeline(const VulkanDevice &device,
         &colorBlending,
         &dynamicStateInfo,
         pipelineLayout,
-        renderPass.get(),
-        0 // subpass
+        nullptr, // render pass
+        0        // subpass
     );
+    pipelineInfo.pNext = &renderingInfo;
 
     auto result = deviceRef.getLogicalDevice().createGraphicsPipeline(nullptr, pipelineInfo);
     if (result.result != vk::Result::eSuccess)
@@ -99,6 +144,7 @@ VulkanGraphicsPipeline::VulkanGraphicsPipeline(const VulkanDevice &device,
     }
 
     graphicsPipeline = result.value;
+    VK_DEBUG_NAME(deviceRef.getLogicalDevice(), graphicsPipeline, "graphics pipeline");
 }
 
 VulkanGraphicsPipeline::~VulkanGraphicsPipeline()
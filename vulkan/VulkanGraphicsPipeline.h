@@ -3,18 +3,91 @@
 #include <vulkan/vulkan.hpp>
 
 class VulkanDevice;
-class VulkanRenderPass;
 class VulkanShader;
 
+// Attachments a pipeline renders into. Pipelines are built for formats (dynamic
+// rendering), so they outlive any particular set of images.
+struct RenderTargetFormats
+{
+    vk::Format color = vk::Format::eUndefined;
+    vk::Format depth = vk::Format::eUndefined;
+    vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1;
+};
+
+// Shader branches, baked in as specialization constants (constant_id = bit index)
+enum ShaderFeature : uint32_t
+{
+    ShaderFeatureVertexColor = 1u << 0,        // Multiply by the per-vertex color
+    ShaderFeatureTexture = 1u << 1,            // Sample the material's bindless texture
+    ShaderFeatureInstancing = 1u << 2,         // Draw index advances with gl_InstanceIndex
+    ShaderFeatureQuantizedPositions = 1u << 3  // Positions arrive as snorm16 scaled by positionScale
+};
+constexpr uint32_t kShaderFeatureCount = 4;
+
+// Everything that makes one pipeline permutation differ from another. All of it is
+// fixed at pipeline creation: the driver compiles each permutation's shaders with
+// the feature branches resolved, so nothing is decided per draw.
+struct PipelineDesc
+{
+    vk::CullModeFlagBits cullMode = vk::CullModeFlagBits::eBack;
+    vk::FrontFace frontFace = vk::FrontFace::eCounterClockwise;
+    vk::PolygonMode polygonMode = vk::PolygonMode::eFill;
+    bool depthTest = true;
+    bool depthWrite = true;
+    vk::CompareOp depthCompare = vk::CompareOp::eLess;
+    bool alphaBlend = false;
+    bool additive = false; // With alphaBlend: src * alpha + dst (particles, glows), order independent
+    uint32_t features = ShaderFeatureVertexColor | ShaderFeatureTexture;
+    float positionScale = 1.0f; // Object-space extent of a snorm16 unit (quantized positions only)
+
+    constexpr bool has(ShaderFeature feature) const { return (features & feature) != 0; }
+
+    constexpr PipelineDesc with(uint32_t added) const
+    {
+        PipelineDesc desc = *this;
+        desc.features |= added;
+        return desc;
+    }
+
+    constexpr PipelineDesc without(uint32_t removed) const
+    {
+        PipelineDesc desc = *this;
+        desc.features &= ~removed;
+        return desc;
+    }
+};
+
+// The permutations the renderer uses
+namespace PipelineDescs
+{
+    constexpr PipelineDesc kTextured{};
+    constexpr PipelineDesc kVertexColor = kTextured.without(ShaderFeatureTexture);
+    constexpr PipelineDesc kInstanced = kVertexColor.with(ShaderFeatureInstancing);
+
+    // Camera-facing quads built in the vertex shader: no culling, test depth but don't write it
+    constexpr PipelineDesc kParticles{vk::CullModeFlagBits::eNone, vk::FrontFace::eCounterClockwise,
+                                      vk::PolygonMode::eFill, true, false, vk::CompareOp::eLess, true, true, 0};
+
+    // Screen-space quads over the finished image (VulkanHud): no culling or depth, blended in order
+    constexpr PipelineDesc kOverlay{vk::CullModeFlagBits::eNone, vk::FrontFace::eCounterClockwise,
+                                    vk::PolygonMode::eFill, false, false, vk::CompareOp::eAlways, true, false, 0};
+
+    static_assert(!kVertexColor.has(ShaderFeatureTexture) && kVertexColor.has(ShaderFeatureVertexColor),
+                  "vertex color permutation must not sample textures");
+}
+
 class VulkanGraphicsPipeline
 {
 public:
     VulkanGraphicsPipeline(const VulkanDevice &device,
-                           const VulkanRenderPass &renderPass,
+                           const RenderTargetFormats &targets,
                            const VulkanShader &shader,
+                           const PipelineDesc &desc = PipelineDesc(),
                            const vk::VertexInputBindingDescription *bindingDesc = nullptr,
                            uint32_t attributeCount = 0,
-                           const vk::VertexInputAttributeDescription *attributeDesc = nullptr);
+                           const vk::VertexInputAttributeDescription *attributeDesc = nullptr,
+                           uint32_t setLayoutCount = 0,
+                           const vk::DescriptorSetLayout *setLayouts = nullptr);
 
     ~VulkanGraphicsPipeline();
 
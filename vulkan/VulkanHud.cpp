@@ -0,0 +1,118 @@
+#include "VulkanHud.h"
+#include "VulkanDevice.h"
+#include "VulkanFrameRing.h"
+#include "VulkanBindless.h"
+#include "VulkanShader.h"
+#include "VulkanTexture.h"
+#include "VulkanGraphicsPipeline.h"
+#include "src/RenderQueue.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+VulkanHud::VulkanHud(const VulkanDevice &device, VulkanFrameRing &frameRing, VulkanBindless &bindless,
+                     const RenderTargetFormats &targets, uint32_t scale)
+    : deviceRef(device), frameRingRef(frameRing), bindlessRef(bindless), overlay(scale)
+{
+    const std::vector<uint32_t> texels = HudOverlay::buildAtlas();
+    atlas = std::make_unique<VulkanTexture>(deviceRef, HudOverlay::kAtlasWidth, HudOverlay::kAtlasHeight,
+                                            texels.data());
+    MaterialParams params;
+    params.textureIndex = bindless.registerTexture(atlas->getView());
+    materialId = bindless.registerMaterial(params);
+
+    // One HudQuad per instance; the vertex shader expands it to two triangles
+    shader = std::make_unique<VulkanShader>(deviceRef, "shaders/hud.vert.spv", "shaders/hud.frag.spv");
+    vk::VertexInputBindingDescription binding(0, sizeof(HudQuad), vk::VertexInputRate::eInstance);
+    std::array<vk::VertexInputAttributeDescription, 3> attributes = {
+        vk::VertexInputAttributeDescription(0, 0, vk::Format::eR32G32B32A32Sfloat, offsetof(HudQuad, rect)),
+        vk::VertexInputAttributeDescription(1, 0, vk::Format::eR16G16B16A16Uint, offsetof(HudQuad, texels)),
+        vk::VertexInputAttributeDescription(2, 0, vk::Format::eR8G8B8A8Unorm, offsetof(HudQuad, color))};
+
+    // Projection from the frame ring (set 0), atlas through the bindless tables (set 1)
+    std::array<vk::DescriptorSetLayout, 2> setLayouts = {frameRingRef.getSetLayout(), bindless.getSetLayout()};
+    pipeline = std::make_unique<VulkanGraphicsPipeline>(deviceRef, targets, *shader, PipelineDescs::kOverlay,
+                                                        &binding, static_cast<uint32_t>(attributes.size()),
+                                                        attributes.data(), static_cast<uint32_t>(setLayouts.size()),
+                                                        setLayouts.data());
+
+    lastPrepare = std::chrono::steady_clock::now();
+}
+
+VulkanHud::~VulkanHud() = default;
+
+void VulkanHud::prepare(const FrameStats &stats, uint32_t objectCount, std::optional<uint32_t> frustumCulled,
+                        vk::Extent2D extent)
+{
+    const auto start = std::chrono::steady_clock::now();
+    overlay.addFrameTime(std::chrono::duration<float, std::milli>(start - lastPrepare).count());
+    lastPrepare = start;
+
+    hudStats.objects = objectCount;
+    hudStats.drawCalls = stats.drawCalls;
+    hudStats.frustumCulled = frustumCulled;
+    hudStats.occlusionCulled = stats.occlusionCulled;
+    hudStats.pipelineBinds = stats.pipelineBinds;
+    hudStats.materialChanges = stats.materialChanges;
+    hudStats.memoryUsed = 0;
+    hudStats.memoryBudget = 0;
+    for (const MemoryHeapStatus &heap : deviceRef.getMemoryTracker().getHeapStatus())
+    {
+        if (!heap.deviceLocal)
+            continue;
+        hudStats.memoryUsed += heap.usage;
+        hudStats.memoryBudget += heap.budget;
+    }
+    overlay.build(hudStats);
+
+    // Pixels to clip space, y down like the framebuffer
+    CameraData camera{};
+    camera.proj = glm::ortho(0.0f, static_cast<float>(extent.width), 0.0f, static_cast<float>(extent.height));
+    RingAllocation cameraAlloc = frameRingRef.allocateUniform(sizeof(CameraData));
+    std::memcpy(cameraAlloc.data, &camera, sizeof(CameraData));
+    cameraOffset = cameraAlloc.offset;
+
+    // The same size every frame, however many glyphs the numbers take: the scene's ring
+    // allocations after this one keep their offsets, and with them its cached commands.
+    // One sequential copy into the (possibly write-combined) ring.
+    const std::vector<HudQuad> &quads = overlay.getQuads();
+    quadCount = static_cast<uint32_t>(std::min<size_t>(quads.size(), kMaxQuads));
+    RingAllocation quadAlloc = frameRingRef.allocateVertices(sizeof(HudQuad) * kMaxQuads);
+    std::memcpy(quadAlloc.data, quads.data(), sizeof(HudQuad) * quadCount);
+    quadOffset = quadAlloc.offset;
+    frameExtent = extent;
+
+    // Shown next frame
+    hudStats.buildMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void VulkanHud::draw(vk::CommandBuffer cmd) const
+{
+    if (quadCount == 0)
+        return;
+
+    const vk::Viewport viewport(0.0f, 0.0f, static_cast<float>(frameExtent.width),
+                                static_cast<float>(frameExtent.height), 0.0f, 1.0f);
+    const vk::Rect2D scissor(vk::Offset2D(0, 0), frameExtent);
+    cmd.setViewport(0, 1, &viewport);
+    cmd.setScissor(0, 1, &scissor);
+
+    const std::array<vk::DescriptorSet, 2> sets = {frameRingRef.getDescriptorSet(), bindlessRef.getDescriptorSet()};
+    const uint32_t dynamicOffsets[] = {cameraOffset, 0};
+    cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline->get());
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline->getLayout(), 0,
+                           static_cast<uint32_t>(sets.size()), sets.data(), 2, dynamicOffsets);
+
+    DrawPushConstants push;
+    push.materialId = materialId;
+    cmd.pushConstants(pipeline->getLayout(), vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment,
+                      0, sizeof(DrawPushConstants), &push);
+
+    const vk::Buffer ringBuffer = frameRingRef.getBuffer();
+    const vk::DeviceSize offset = quadOffset;
+    cmd.bindVertexBuffers(0, 1, &ringBuffer, &offset);
+    cmd.draw(6, quadCount, 0, 0);
+}
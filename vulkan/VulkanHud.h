@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include "src/HudOverlay.h"
+
+class VulkanDevice;
+class VulkanFrameRing;
+class VulkanBindless;
+class VulkanShader;
+class VulkanTexture;
+class VulkanGraphicsPipeline;
+struct RenderTargetFormats;
+struct FrameStats;
+
+// On-screen performance overlay: frame time graph, draw and cull counts, state changes
+// and GPU memory. Each frame prepare() lays out the panel (HudOverlay) and copies its
+// quads into the frame ring, which doubles as the vertex buffer; draw() issues a single
+// instanced draw over the final image. The font atlas is a bindless texture.
+class VulkanHud
+{
+public:
+    // Targets are the swapchain's (single-sampled, no depth): the overlay is drawn after
+    // the scene has been resolved
+    VulkanHud(const VulkanDevice &device, VulkanFrameRing &frameRing, VulkanBindless &bindless,
+              const RenderTargetFormats &targets, uint32_t scale = 2);
+    ~VulkanHud();
+
+    VulkanHud(const VulkanHud &) = delete;
+    VulkanHud &operator=(const VulkanHud &) = delete;
+
+    // Once per frame, after the frame ring's beginFrame(). `stats` are last frame's;
+    // the frame time is the time since the previous call. frustumCulled comes from this
+    // frame's visibility pass (none with occlusion culling, which culls on the GPU).
+    void prepare(const FrameStats &stats, uint32_t objectCount, std::optional<uint32_t> frustumCulled,
+                 vk::Extent2D extent);
+
+    // Inside a pass rendering to the swapchain image
+    void draw(vk::CommandBuffer cmd) const;
+
+private:
+    // Ring space reserved for quads each frame (the panel needs a few hundred); any
+    // beyond this are dropped
+    static constexpr uint32_t kMaxQuads = 1024;
+
+    const VulkanDevice &deviceRef;
+    VulkanFrameRing &frameRingRef;
+    const VulkanBindless &bindlessRef;
+
+    std::unique_ptr<VulkanTexture> atlas;
+    uint32_t materialId = 0;
+    std::unique_ptr<VulkanShader> shader;
+    std::unique_ptr<VulkanGraphicsPipeline> pipeline;
+
+    HudOverlay overlay;
+    HudStats hudStats;
+
+    // This frame's inputs, set by prepare()
+    vk::Extent2D frameExtent;
+    uint32_t cameraOffset = 0;
+    uint32_t quadOffset = 0;
+    uint32_t quadCount = 0;
+    std::chrono::steady_clock::time_point lastPrepare;
+};
@@ -6,7 +6,9 @@
 VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
 
 #include "VulkanInstance.h"
+#include "VulkanDebug.h"
 
+#include <cstring>
 #include <iostream>
 
 // Static initialization of the default dispatcher (core functions)
@@ -22,11 +24,25 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
     return VK_FALSE;
 }
 
-VulkanInstance::VulkanInstance(bool enableValidationLayers)
-    : enableValidationLayers(enableValidationLayers)
+VulkanInstance::VulkanInstance(bool enableValidationLayers, bool headless, bool debugLabels)
+    : enableValidationLayers(enableValidationLayers), headless(headless), debugLabels(debugLabels)
 {
+#if !VULKAN_CUBE_DEBUG_UTILS
+    // Release builds carry no instrumentation: the layer and extension are never requested
+    this->enableValidationLayers = false;
+    this->debugLabels = false;
+#endif
+
+    if (this->enableValidationLayers && !validationLayersAvailable())
+    {
+        std::cerr << "Validation layers requested but not installed; continuing without them" << std::endl;
+        this->enableValidationLayers = false;
+    }
+
     createInstance();
-    if (enableValidationLayers)
+    if (this->debugLabels)
+        VulkanDebug::init(instance);
+    if (this->enableValidationLayers)
     {
         setupDebugMessenger();
     }
@@ -48,11 +64,14 @@ void VulkanInstance::createInstance()
 {
     vk::ApplicationInfo appInfo("Vulkan Cube", VK_MAKE_VERSION(1, 0, 0), "No Engine", VK_MAKE_VERSION(1, 0, 0), VK_API_VERSION_1_3);
 
-    uint32_t glfwExtensionCount = 0;
-    const char **glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-    std::vector<const char *> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
-    if (enableValidationLayers)
+    std::vector<const char *> extensions;
+    if (!headless)
+    {
+        uint32_t glfwExtensionCount = 0;
+        const char **glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    }
+    if (enableValidationLayers || debugLabels)
     {
         extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
     }
@@ -80,4 +99,21 @@ void VulkanInstance::setupDebugMessenger()
         debugCallback);
 
     debugMessenger = instance.createDebugUtilsMessengerEXT(createInfo, nullptr, VULKAN_HPP_DEFAULT_DISPATCHER);
-}
\ No newline at end of file
+}
+
+bool VulkanInstance::validationLayersAvailable() const
+{
+    auto available = vk::enumerateInstanceLayerProperties();
+    for (const char *layer : validationLayers)
+    {
+        bool found = false;
+        for (const auto &props : available)
+        {
+            if (std::strcmp(props.layerName.data(), layer) == 0)
+                found = true;
+        }
+        if (!found)
+            return false;
+    }
+    return true;
+}
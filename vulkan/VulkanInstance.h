@@ -7,7 +7,10 @@
 class VulkanInstance
 {
 public:
-    VulkanInstance(bool enableValidationLayers = true);
+    // Headless instances skip the GLFW surface extensions (offscreen tools and benchmarks).
+    // debugLabels enables VK_EXT_debug_utils for object names and command labels. Both
+    // validation and labels are ignored in builds without VULKAN_CUBE_DEBUG_UTILS.
+    VulkanInstance(bool enableValidationLayers = true, bool headless = false, bool debugLabels = false);
     ~VulkanInstance();
 
     vk::Instance get() const { return instance; }
@@ -15,11 +18,14 @@ public:
 private:
     void createInstance();
     void setupDebugMessenger();
+    bool validationLayersAvailable() const;
 
     vk::Instance instance;
     vk::DebugUtilsMessengerEXT debugMessenger;
 
     bool enableValidationLayers;
+    bool headless;
+    bool debugLabels;
     const std::vector<const char *> validationLayers = {
         "VK_LAYER_KHRONOS_validation"};
 };
\ No newline at end of file
@@ -0,0 +1,315 @@
+#include "VulkanInstanceAnimator.h"
+#include "VulkanDevice.h"
+#include "VulkanFrameRing.h"
+#include "VulkanShader.h"
+#include "VulkanDebug.h"
+#include "src/Mesh.h"
+#include "src/Material.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    constexpr uint32_t kAnimateGroupSize = 64; // shaders/animate.comp local_size_x
+}
+
+VulkanInstanceAnimator::VulkanInstanceAnimator(const VulkanDevice &device, const VulkanFrameRing &frameRing)
+    : deviceRef(device), frameRingRef(frameRing), startTime(std::chrono::steady_clock::now())
+{
+    createPipeline();
+    createDescriptors();
+}
+
+VulkanInstanceAnimator::~VulkanInstanceAnimator()
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    destroyBuffers();
+    if (descriptorPool)
+        dev.destroyDescriptorPool(descriptorPool);
+    if (computePipeline)
+        dev.destroyPipeline(computePipeline);
+    if (computeLayout)
+        dev.destroyPipelineLayout(computeLayout);
+    if (computeSetLayout)
+        dev.destroyDescriptorSetLayout(computeSetLayout);
+}
+
+void VulkanInstanceAnimator::createPipeline()
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    shader = std::make_unique<VulkanShader>(deviceRef, "shaders/animate.comp.spv");
+
+    // Parameters and paths in, model matrices out
+    std::array<vk::DescriptorSetLayoutBinding, 3> bindings = {
+        vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute),
+        vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute),
+        vk::DescriptorSetLayoutBinding(2, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute)};
+    computeSetLayout = dev.createDescriptorSetLayout(
+        vk::DescriptorSetLayoutCreateInfo({}, static_cast<uint32_t>(bindings.size()), bindings.data()));
+    VK_DEBUG_NAME(dev, computeSetLayout, "animate set layout");
+
+    vk::PushConstantRange push(vk::ShaderStageFlagBits::eCompute, 0, sizeof(AnimatePushConstants));
+    computeLayout = dev.createPipelineLayout(vk::PipelineLayoutCreateInfo({}, 1, &computeSetLayout, 1, &push));
+    VK_DEBUG_NAME(dev, computeLayout, "animate layout");
+
+    vk::ComputePipelineCreateInfo info;
+    info.stage = vk::PipelineShaderStageCreateInfo({}, vk::ShaderStageFlagBits::eCompute, shader->getComputeModule(),
+                                                   "main");
+    info.layout = computeLayout;
+    auto result = dev.createComputePipeline(nullptr, info);
+    if (result.result != vk::Result::eSuccess)
+        throw std::runtime_error("failed to create animation pipeline!");
+    computePipeline = result.value;
+    VK_DEBUG_NAME(dev, computePipeline, "animate");
+}
+
+void VulkanInstanceAnimator::createDescriptors()
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    std::array<vk::DescriptorPoolSize, 3> poolSizes = {
+        vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, 3),
+        vk::DescriptorPoolSize(vk::DescriptorType::eUniformBufferDynamic, 1),
+        vk::DescriptorPoolSize(vk::DescriptorType::eStorageBufferDynamic, 1)};
+    descriptorPool = dev.createDescriptorPool(
+        vk::DescriptorPoolCreateInfo({}, 2, static_cast<uint32_t>(poolSizes.size()), poolSizes.data()));
+    VK_DEBUG_NAME(dev, descriptorPool, "animate pool");
+
+    std::array<vk::DescriptorSetLayout, 2> layouts = {computeSetLayout, frameRingRef.getSetLayout()};
+    auto sets = dev.allocateDescriptorSets(
+        vk::DescriptorSetAllocateInfo(descriptorPool, static_cast<uint32_t>(layouts.size()), layouts.data()));
+    computeSet = sets[0];
+    drawSet = sets[1];
+    VK_DEBUG_NAME(dev, computeSet, "animate set");
+    VK_DEBUG_NAME(dev, drawSet, "animated draw set");
+
+    // Camera data still comes from the ring (same dynamic offset as the other draws)
+    vk::DescriptorBufferInfo cameraInfo(frameRingRef.getBuffer(), 0, sizeof(CameraData));
+    vk::WriteDescriptorSet write(drawSet, 0, 0, 1, vk::DescriptorType::eUniformBufferDynamic, nullptr, &cameraInfo);
+    dev.updateDescriptorSets(write, nullptr);
+}
+
+uint32_t VulkanInstanceAnimator::addGroup(const Mesh *mesh, const Material *material,
+                                          const std::vector<AnimationParams> &instances)
+{
+    Group group;
+    group.mesh = mesh;
+    group.material = material;
+    group.firstInstance = static_cast<uint32_t>(params.size());
+    group.count = static_cast<uint32_t>(instances.size());
+    groups.push_back(group);
+
+    params.insert(params.end(), instances.begin(), instances.end());
+    return group.firstInstance;
+}
+
+uint32_t VulkanInstanceAnimator::addPath(const std::vector<glm::vec3> &points)
+{
+    uint32_t first = static_cast<uint32_t>(pathPoints.size());
+    for (const glm::vec3 &point : points)
+        pathPoints.emplace_back(point, 0.0f);
+    return first;
+}
+
+void VulkanInstanceAnimator::upload()
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    // Instances may be added between uploads; the old buffers may still be in use
+    if (instanceBuffer)
+    {
+        dev.waitIdle();
+        destroyBuffers();
+    }
+
+    instanceCount = static_cast<uint32_t>(params.size());
+    if (instanceCount == 0)
+        return;
+
+    const vk::DeviceSize instanceBytes = sizeof(DrawData) * instanceCount;
+    if (instanceBytes > deviceRef.getPhysicalDevice().getProperties().limits.maxStorageBufferRange)
+        throw std::runtime_error("too many animated instances for one storage buffer!");
+
+    // Shaders can't bind empty buffers; an unused path buffer holds one dummy point
+    if (pathPoints.empty())
+        pathPoints.emplace_back(0.0f);
+
+    const vk::DeviceSize paramsBytes = sizeof(AnimationParams) * params.size();
+    const vk::DeviceSize pathBytes = sizeof(glm::vec4) * pathPoints.size();
+    createBuffer(paramsBytes, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+                 MemoryCategory::Geometry, paramsBuffer, paramsMemory, "animation params");
+    createBuffer(pathBytes, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+                 MemoryCategory::Geometry, pathBuffer, pathMemory, "animation paths");
+    createBuffer(instanceBytes, vk::BufferUsageFlagBits::eStorageBuffer, MemoryCategory::FrameData, instanceBuffer,
+                 instanceMemory, "animated instances");
+
+    uploadBuffer(paramsBuffer, params.data(), paramsBytes);
+    uploadBuffer(pathBuffer, pathPoints.data(), pathBytes);
+
+    vk::DescriptorBufferInfo paramsInfo(paramsBuffer, 0, VK_WHOLE_SIZE);
+    vk::DescriptorBufferInfo pathInfo(pathBuffer, 0, VK_WHOLE_SIZE);
+    vk::DescriptorBufferInfo instanceInfo(instanceBuffer, 0, VK_WHOLE_SIZE);
+    vk::DescriptorBufferInfo drawInfo(instanceBuffer, 0, instanceBytes);
+    std::array<vk::WriteDescriptorSet, 4> writes = {
+        vk::WriteDescriptorSet(computeSet, 0, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &paramsInfo),
+        vk::WriteDescriptorSet(computeSet, 1, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &pathInfo),
+        vk::WriteDescriptorSet(computeSet, 2, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &instanceInfo),
+        vk::WriteDescriptorSet(drawSet, 1, 0, 1, vk::DescriptorType::eStorageBufferDynamic, nullptr, &drawInfo)};
+    dev.updateDescriptorSets(writes, nullptr);
+
+    // The recorded commands never change, so neither do their counts
+    stats = FrameStats();
+    vk::Pipeline lastPipeline;
+    uint32_t lastMaterial = UINT32_MAX;
+    const Mesh *lastMesh = nullptr;
+    for (const Group &group : groups)
+    {
+        if (group.count == 0)
+            continue;
+        if (group.material->getPipeline() != lastPipeline)
+        {
+            lastPipeline = group.material->getPipeline();
+            ++stats.pipelineBinds;
+        }
+        if (group.material->getMaterialId() != lastMaterial)
+        {
+            lastMaterial = group.material->getMaterialId();
+            ++stats.materialChanges;
+        }
+        if (group.mesh != lastMesh)
+        {
+            lastMesh = group.mesh;
+            ++stats.meshBinds;
+        }
+        ++stats.drawCalls;
+        stats.trianglesSubmitted += static_cast<uint64_t>(group.mesh->getTriangleCount(0)) * group.count;
+    }
+    stats.trianglesFullDetail = stats.trianglesSubmitted;
+}
+
+void VulkanInstanceAnimator::animate(vk::CommandBuffer cmd)
+{
+    if (instanceCount == 0)
+        return;
+
+    AnimatePushConstants push;
+    push.time = std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+    push.instanceCount = instanceCount;
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, computePipeline);
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, computeLayout, 0, computeSet, nullptr);
+    cmd.pushConstants(computeLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(push), &push);
+    cmd.dispatch((instanceCount + kAnimateGroupSize - 1) / kAnimateGroupSize, 1, 1);
+}
+
+void VulkanInstanceAnimator::draw(vk::CommandBuffer cmd, uint32_t cameraOffset, vk::DescriptorSet bindlessSet) const
+{
+    if (instanceCount == 0)
+        return;
+
+    const vk::ShaderStageFlags pushStages = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+    const std::array<vk::DescriptorSet, 2> sets = {drawSet, bindlessSet};
+    const uint32_t dynamicOffsets[] = {cameraOffset, 0};
+
+    vk::Pipeline boundPipeline;
+    const Mesh *boundMesh = nullptr;
+    for (const Group &group : groups)
+    {
+        if (group.count == 0)
+            continue;
+
+        vk::PipelineLayout layout = group.material->getLayout();
+        if (group.material->getPipeline() != boundPipeline)
+        {
+            boundPipeline = group.material->getPipeline();
+            cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, boundPipeline);
+            cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout, 0, static_cast<uint32_t>(sets.size()),
+                                   sets.data(), 2, dynamicOffsets);
+        }
+        if (group.mesh != boundMesh)
+        {
+            group.mesh->bind(cmd);
+            boundMesh = group.mesh;
+        }
+
+        // The vertex shader reads draws[drawIndex + gl_InstanceIndex]
+        DrawPushConstants push;
+        push.drawIndex = group.firstInstance;
+        push.materialId = group.material->getMaterialId();
+        cmd.pushConstants(layout, pushStages, 0, sizeof(DrawPushConstants), &push);
+
+        const MeshLod &lod = group.mesh->getLod(0);
+        cmd.draw(lod.vertexCount, group.count, lod.firstVertex, 0);
+    }
+}
+
+void VulkanInstanceAnimator::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, MemoryCategory category,
+                                          vk::Buffer &buffer, vk::DeviceMemory &memory, const char *name) const
+{
+    auto dev = deviceRef.getLogicalDevice();
+    buffer = dev.createBuffer(vk::BufferCreateInfo({}, size, usage, vk::SharingMode::eExclusive));
+    VK_DEBUG_NAME(dev, buffer, name);
+
+    auto memReq = dev.getBufferMemoryRequirements(buffer);
+    vk::MemoryAllocateInfo allocInfo(memReq.size,
+                                     deviceRef.findMemoryType(memReq.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal));
+    memory = deviceRef.allocateMemory(allocInfo, category);
+    dev.bindBufferMemory(buffer, memory, 0);
+}
+
+void VulkanInstanceAnimator::uploadBuffer(vk::Buffer dst, const void *data, vk::DeviceSize size) const
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    vk::Buffer stagingBuffer = dev.createBuffer(
+        vk::BufferCreateInfo({}, size, vk::BufferUsageFlagBits::eTransferSrc, vk::SharingMode::eExclusive));
+    auto memReq = dev.getBufferMemoryRequirements(stagingBuffer);
+    vk::MemoryAllocateInfo allocInfo(memReq.size,
+                                     deviceRef.findMemoryType(memReq.memoryTypeBits,
+                                                              vk::MemoryPropertyFlagBits::eHostVisible |
+                                                                  vk::MemoryPropertyFlagBits::eHostCoherent));
+    vk::DeviceMemory stagingMemory = deviceRef.allocateMemory(allocInfo, MemoryCategory::Staging);
+    dev.bindBufferMemory(stagingBuffer, stagingMemory, 0);
+
+    void *mapped = dev.mapMemory(stagingMemory, 0, size);
+    std::memcpy(mapped, data, static_cast<size_t>(size));
+    dev.unmapMemory(stagingMemory);
+
+    vk::CommandPool cmdPool = dev.createCommandPool(vk::CommandPoolCreateInfo({}, deviceRef.getGraphicsQueueFamily()));
+    vk::CommandBuffer cmd =
+        dev.allocateCommandBuffers(vk::CommandBufferAllocateInfo(cmdPool, vk::CommandBufferLevel::ePrimary, 1))[0];
+
+    cmd.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    cmd.copyBuffer(stagingBuffer, dst, vk::BufferCopy(0, 0, size));
+    cmd.end();
+
+    vk::SubmitInfo submitInfo(0, nullptr, nullptr, 1, &cmd);
+    deviceRef.getGraphicsQueue().submit(submitInfo, {});
+    deviceRef.getGraphicsQueue().waitIdle();
+
+    dev.freeCommandBuffers(cmdPool, cmd);
+    dev.destroyCommandPool(cmdPool);
+    dev.destroyBuffer(stagingBuffer);
+    deviceRef.freeMemory(stagingMemory);
+}
+
+void VulkanInstanceAnimator::destroyBuffers()
+{
+    auto dev = deviceRef.getLogicalDevice();
+    for (vk::Buffer *buffer : {&paramsBuffer, &pathBuffer, &instanceBuffer})
+    {
+        if (*buffer)
+            dev.destroyBuffer(*buffer);
+        *buffer = vk::Buffer();
+    }
+    for (vk::DeviceMemory *memory : {&paramsMemory, &pathMemory, &instanceMemory})
+    {
+        deviceRef.freeMemory(*memory);
+        *memory = vk::DeviceMemory();
+    }
+}
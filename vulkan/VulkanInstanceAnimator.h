@@ -0,0 +1,127 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+#include <glm/glm.hpp>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "VulkanMemoryTracker.h"
+#include "src/RenderQueue.h"
+
+class VulkanDevice;
+class VulkanFrameRing;
+class VulkanShader;
+class Mesh;
+class Material;
+
+// Animation programs an instance runs; any combination (must match shaders/animate.comp)
+enum AnimationProgram : uint32_t
+{
+    AnimateRotate = 1,     // Spin around `rotation.xyz` at `rotation.w` radians per second
+    AnimateOscillate = 2,  // Offset by `oscillation.xyz * sin(2 pi oscillation.w t)`
+    AnimateFollowPath = 4, // Loop through a closed Catmull-Rom path at `pathSpeed` points per second
+};
+
+// Per-instance animation parameters (std430, must match shaders/animate.comp)
+struct AnimationParams
+{
+    glm::vec4 origin = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f); // Position (relative to the path with
+                                                          // AnimateFollowPath), w: uniform scale
+    glm::vec4 rotation = glm::vec4(0.0f, 1.0f, 0.0f, 0.0f);
+    glm::vec4 oscillation = glm::vec4(0.0f);
+    uint32_t programs = 0;
+    uint32_t pathFirst = 0; // From addPath()
+    uint32_t pathCount = 0;
+    float pathSpeed = 0.0f;
+    float phase = 0.0f; // Seconds added to the clock, so copies don't move in lockstep
+    float padding[3] = {};
+};
+
+// Procedural animation evaluated entirely on the GPU. A compute pass runs every
+// instance's animation program and writes its model matrix straight into an instance
+// buffer laid out like the frame ring's DrawData, which the vertex shader then reads
+// (INSTANCED permutation, drawIndex + gl_InstanceIndex). Each group is one instanced
+// draw, so the CPU cost per frame is one dispatch and one draw per group regardless of
+// how many instances move.
+class VulkanInstanceAnimator
+{
+public:
+    VulkanInstanceAnimator(const VulkanDevice &device, const VulkanFrameRing &frameRing);
+    ~VulkanInstanceAnimator();
+
+    VulkanInstanceAnimator(const VulkanInstanceAnimator &) = delete;
+    VulkanInstanceAnimator &operator=(const VulkanInstanceAnimator &) = delete;
+
+    // Instances drawn with one instanced draw of the mesh's first LOD. The material must
+    // use an instanced pipeline (PipelineDescs::kInstanced). Returns the first instance index.
+    uint32_t addGroup(const Mesh *mesh, const Material *material, const std::vector<AnimationParams> &instances);
+
+    // Control points of a closed path; returns the index for AnimationParams::pathFirst
+    uint32_t addPath(const std::vector<glm::vec3> &points);
+
+    // Uploads parameters and paths and sizes the instance buffer. Call once the groups are
+    // added, outside of a frame (it waits for the device).
+    void upload();
+
+    // Compute pass writing every instance's model matrix for the current time.
+    // The render graph orders it against the draws (see getInstanceBuffer()).
+    void animate(vk::CommandBuffer cmd);
+
+    // Inside the scene pass: one instanced draw per group
+    void draw(vk::CommandBuffer cmd, uint32_t cameraOffset, vk::DescriptorSet bindlessSet) const;
+
+    // Written by animate() (compute), read by draw() (vertex shader)
+    vk::Buffer getInstanceBuffer() const { return instanceBuffer; }
+    uint32_t getInstanceCount() const { return instanceCount; }
+
+    // What draw() records per frame
+    const FrameStats &getStats() const { return stats; }
+
+private:
+    struct Group
+    {
+        const Mesh *mesh;
+        const Material *material;
+        uint32_t firstInstance;
+        uint32_t count;
+    };
+
+    struct AnimatePushConstants
+    {
+        float time;
+        uint32_t instanceCount;
+    };
+
+    void createPipeline();
+    void createDescriptors();
+    void destroyBuffers();
+    void createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, MemoryCategory category,
+                      vk::Buffer &buffer, vk::DeviceMemory &memory, const char *name) const;
+    void uploadBuffer(vk::Buffer dst, const void *data, vk::DeviceSize size) const;
+
+    const VulkanDevice &deviceRef;
+    const VulkanFrameRing &frameRingRef;
+
+    std::unique_ptr<VulkanShader> shader;
+    vk::DescriptorSetLayout computeSetLayout;
+    vk::PipelineLayout computeLayout;
+    vk::Pipeline computePipeline;
+    vk::DescriptorPool descriptorPool;
+    vk::DescriptorSet computeSet;
+    vk::DescriptorSet drawSet; // Frame ring layout: camera from the ring, draws from the instance buffer
+
+    std::vector<Group> groups;
+    std::vector<AnimationParams> params;
+    std::vector<glm::vec4> pathPoints;
+    uint32_t instanceCount = 0;
+
+    vk::Buffer paramsBuffer;
+    vk::DeviceMemory paramsMemory;
+    vk::Buffer pathBuffer;
+    vk::DeviceMemory pathMemory;
+    vk::Buffer instanceBuffer;
+    vk::DeviceMemory instanceMemory;
+
+    std::chrono::steady_clock::time_point startTime;
+    FrameStats stats;
+};
@@ -0,0 +1,242 @@
+#include "VulkanMemoryTracker.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <utility>
+
+namespace
+{
+    // Without VK_EXT_memory_budget, assume we can safely use this share of a heap
+    constexpr double kDefaultBudgetShare = 0.8;
+
+    double toMB(vk::DeviceSize bytes)
+    {
+        return static_cast<double>(bytes) / (1024.0 * 1024.0);
+    }
+}
+
+const char *memoryCategoryName(MemoryCategory category)
+{
+    switch (category)
+    {
+    case MemoryCategory::Geometry:
+        return "geometry";
+    case MemoryCategory::Attachments:
+        return "attachments";
+    case MemoryCategory::Textures:
+        return "textures";
+    case MemoryCategory::Staging:
+        return "staging";
+    case MemoryCategory::FrameData:
+        return "frame data";
+    default:
+        return "unknown";
+    }
+}
+
+VulkanMemoryTracker::VulkanMemoryTracker(vk::PhysicalDevice physicalDevice, bool budgetExtension)
+    : physicalDevice(physicalDevice), budgetExtension(budgetExtension)
+{
+    auto memProps = physicalDevice.getMemoryProperties();
+    for (uint32_t i = 0; i < memProps.memoryTypeCount; ++i)
+        typeToHeap.push_back(memProps.memoryTypes[i].heapIndex);
+
+    heaps.resize(memProps.memoryHeapCount);
+    for (uint32_t i = 0; i < memProps.memoryHeapCount; ++i)
+    {
+        heaps[i].status.size = memProps.memoryHeaps[i].size;
+        heaps[i].status.deviceLocal = static_cast<bool>(memProps.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    queryBudgetLocked();
+}
+
+void VulkanMemoryTracker::recordAllocation(vk::DeviceMemory memory, vk::DeviceSize size, uint32_t memoryType,
+                                           MemoryCategory category)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    uint32_t heap = typeToHeap[memoryType];
+    allocations[static_cast<VkDeviceMemory>(memory)] = {size, heap, category};
+
+    HeapState &state = heaps[heap];
+    state.status.tracked += size;
+    state.peak = std::max(state.peak, state.status.tracked);
+
+    CategoryStats &stats = categories[static_cast<size_t>(category)];
+    stats.bytes += size;
+    stats.peak = std::max(stats.peak, stats.bytes);
+    ++stats.live;
+    ++stats.total;
+
+    // Callbacks wait for update(): this may be any thread that allocates
+    detectPressureLocked();
+}
+
+void VulkanMemoryTracker::recordFree(vk::DeviceMemory memory)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = allocations.find(static_cast<VkDeviceMemory>(memory));
+    if (it == allocations.end())
+        return;
+
+    heaps[it->second.heap].status.tracked -= it->second.size;
+    CategoryStats &stats = categories[static_cast<size_t>(it->second.category)];
+    stats.bytes -= it->second.size;
+    --stats.live;
+    allocations.erase(it);
+}
+
+void VulkanMemoryTracker::addPressureCallback(PressureCallback callback)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    callbacks.push_back(std::move(callback));
+}
+
+void VulkanMemoryTracker::update()
+{
+    std::vector<std::pair<uint32_t, MemoryHeapStatus>> crossed;
+    std::vector<PressureCallback> toCall;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queryBudgetLocked();
+        detectPressureLocked();
+        crossed.swap(pendingCrossings);
+        if (!crossed.empty())
+            toCall = callbacks;
+    }
+
+    // Outside the lock: callbacks typically free memory, which re-enters the tracker
+    for (const auto &[heap, status] : crossed)
+    {
+        for (const auto &callback : toCall)
+            callback(heap, status);
+    }
+}
+
+void VulkanMemoryTracker::queryBudgetLocked()
+{
+    if (!budgetExtension)
+    {
+        for (auto &heap : heaps)
+        {
+            heap.status.budget = static_cast<vk::DeviceSize>(static_cast<double>(heap.status.size) * kDefaultBudgetShare);
+            heap.status.usage = heap.status.tracked;
+            heap.trackedAtQuery = heap.status.tracked;
+        }
+        return;
+    }
+
+    vk::PhysicalDeviceMemoryBudgetPropertiesEXT budgetProps;
+    vk::PhysicalDeviceMemoryProperties2 memProps2;
+    memProps2.pNext = &budgetProps;
+    physicalDevice.getMemoryProperties2(&memProps2);
+
+    for (size_t i = 0; i < heaps.size(); ++i)
+    {
+        heaps[i].status.budget = budgetProps.heapBudget[i];
+        heaps[i].status.usage = budgetProps.heapUsage[i];
+        heaps[i].trackedAtQuery = heaps[i].status.tracked;
+    }
+}
+
+vk::DeviceSize VulkanMemoryTracker::estimatedUsageLocked(const HeapState &heap) const
+{
+    // Driver usage from the last query plus whatever we allocated or freed since
+    const vk::DeviceSize tracked = heap.status.tracked;
+    if (tracked >= heap.trackedAtQuery)
+        return heap.status.usage + (tracked - heap.trackedAtQuery);
+    vk::DeviceSize freed = heap.trackedAtQuery - tracked;
+    return heap.status.usage > freed ? heap.status.usage - freed : 0;
+}
+
+void VulkanMemoryTracker::detectPressureLocked()
+{
+    for (uint32_t i = 0; i < heaps.size(); ++i)
+    {
+        HeapState &heap = heaps[i];
+        MemoryHeapStatus status = heap.status;
+        status.usage = estimatedUsageLocked(heap);
+
+        bool over = status.pressure() >= pressureThreshold;
+        if (over && !heap.underPressure)
+            pendingCrossings.emplace_back(i, status);
+        heap.underPressure = over;
+    }
+}
+
+std::vector<MemoryHeapStatus> VulkanMemoryTracker::getHeapStatus() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<MemoryHeapStatus> result;
+    result.reserve(heaps.size());
+    for (const auto &heap : heaps)
+    {
+        MemoryHeapStatus status = heap.status;
+        status.usage = estimatedUsageLocked(heap);
+        result.push_back(status);
+    }
+    return result;
+}
+
+vk::DeviceSize VulkanMemoryTracker::getCategoryBytes(MemoryCategory category) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return categories[static_cast<size_t>(category)].bytes;
+}
+
+void VulkanMemoryTracker::report(std::ostream &out) const
+{
+    std::vector<MemoryHeapStatus> status = getHeapStatus();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+    out << "GPU memory (" << (budgetExtension ? "VK_EXT_memory_budget" : "estimated budget") << "):" << std::endl;
+    for (size_t i = 0; i < status.size(); ++i)
+    {
+        const MemoryHeapStatus &heap = status[i];
+        if (heap.tracked == 0 && heap.usage == 0)
+            continue;
+        out << "  heap " << i << (heap.deviceLocal ? " (device local)" : " (host)") << ": " << toMB(heap.usage)
+            << " / " << toMB(heap.budget) << " MB budget (" << heap.pressure() * 100.0 << "%), ours "
+            << toMB(heap.tracked) << " MB, heap " << toMB(heap.size) << " MB" << std::endl;
+    }
+    for (size_t c = 0; c < categories.size(); ++c)
+    {
+        const CategoryStats &stats = categories[c];
+        if (stats.total == 0)
+            continue;
+        out << "  " << std::left << std::setw(12) << memoryCategoryName(static_cast<MemoryCategory>(c)) << std::right
+            << toMB(stats.bytes) << " MB in " << stats.live << " allocations" << std::endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void VulkanMemoryTracker::summary(std::ostream &out) const
+{
+    report(out);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+    out << "GPU memory peaks:" << std::endl;
+    for (size_t i = 0; i < heaps.size(); ++i)
+    {
+        if (heaps[i].peak > 0)
+            out << "  heap " << i << ": " << toMB(heaps[i].peak) << " MB" << std::endl;
+    }
+    for (size_t c = 0; c < categories.size(); ++c)
+    {
+        const CategoryStats &stats = categories[c];
+        if (stats.total == 0)
+            continue;
+        out << "  " << std::left << std::setw(12) << memoryCategoryName(static_cast<MemoryCategory>(c)) << std::right
+            << toMB(stats.peak) << " MB peak, " << stats.total << " allocations total" << std::endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+#include <array>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// What an allocation is for; reported separately so budget pressure can be attributed
+enum class MemoryCategory : uint32_t
+{
+    Geometry,    // Vertex/index buffers
+    Attachments, // Depth, MSAA color, transient render graph images
+    Textures,
+    Staging,     // Short-lived upload buffers
+    FrameData,   // Per-frame rings, material tables, culling and readback buffers
+    Count
+};
+
+const char *memoryCategoryName(MemoryCategory category);
+
+struct MemoryHeapStatus
+{
+    vk::DeviceSize size = 0;
+    vk::DeviceSize budget = 0;  // VK_EXT_memory_budget, or a fixed share of the heap without it
+    vk::DeviceSize usage = 0;   // Driver-reported process usage, or our own total without the extension
+    vk::DeviceSize tracked = 0; // Bytes allocated through VulkanDevice
+    bool deviceLocal = false;
+
+    double pressure() const { return budget > 0 ? static_cast<double>(usage) / static_cast<double>(budget) : 0.0; }
+};
+
+// Per-heap and per-category accounting of every vkAllocateMemory made through
+// VulkanDevice. Budgets come from VK_EXT_memory_budget when the device has it.
+// Pressure callbacks fire when a heap crosses the threshold (again only after it
+// has dropped back below), so streaming code can evict before allocations fail.
+//
+// Allocations may come from any thread; a crossing they cause is only recorded and
+// the callbacks run from the next update(), on the thread that polls it.
+class VulkanMemoryTracker
+{
+public:
+    using PressureCallback = std::function<void(uint32_t heapIndex, const MemoryHeapStatus &status)>;
+
+    VulkanMemoryTracker(vk::PhysicalDevice physicalDevice, bool budgetExtension);
+
+    bool hasBudgetExtension() const { return budgetExtension; }
+
+    void recordAllocation(vk::DeviceMemory memory, vk::DeviceSize size, uint32_t memoryType, MemoryCategory category);
+    void recordFree(vk::DeviceMemory memory);
+
+    // Callbacks run inside update(), never from recordAllocation()
+    void addPressureCallback(PressureCallback callback);
+    void setPressureThreshold(double fraction) { pressureThreshold = fraction; }
+
+    // Re-queries the driver's budget and raises pressure callbacks for every threshold
+    // crossing since the last call (call periodically, from one thread)
+    void update();
+
+    std::vector<MemoryHeapStatus> getHeapStatus() const;
+    vk::DeviceSize getCategoryBytes(MemoryCategory category) const;
+
+    // Current heaps and categories; the summary adds peaks and allocation counts
+    void report(std::ostream &out) const;
+    void summary(std::ostream &out) const;
+
+private:
+    struct Allocation
+    {
+        vk::DeviceSize size;
+        uint32_t heap;
+        MemoryCategory category;
+    };
+
+    struct CategoryStats
+    {
+        vk::DeviceSize bytes = 0;
+        vk::DeviceSize peak = 0;
+        uint64_t live = 0;
+        uint64_t total = 0;
+    };
+
+    struct HeapState
+    {
+        MemoryHeapStatus status;
+        vk::DeviceSize peak = 0;
+        vk::DeviceSize trackedAtQuery = 0; // Tracked bytes when usage was last read from the driver
+        bool underPressure = false;
+    };
+
+    void queryBudgetLocked();
+    vk::DeviceSize estimatedUsageLocked(const HeapState &heap) const;
+    void detectPressureLocked();
+
+    const vk::PhysicalDevice physicalDevice;
+    const bool budgetExtension;
+    std::vector<uint32_t> typeToHeap;
+    double pressureThreshold = 0.9;
+
+    mutable std::mutex mutex;
+    std::vector<HeapState> heaps;
+    std::array<CategoryStats, static_cast<size_t>(MemoryCategory::Count)> categories;
+    std::unordered_map<VkDeviceMemory, Allocation> allocations;
+    std::vector<PressureCallback> callbacks;
+    std::vector<std::pair<uint32_t, MemoryHeapStatus>> pendingCrossings; // Raised by the next update()
+};
@@ -0,0 +1,447 @@
+#include "VulkanOcclusionCuller.h"
+#include "VulkanDevice.h"
+#include "VulkanSwapchain.h"
+#include "VulkanFrameRing.h"
+#include "VulkanShader.h"
+#include "src/RenderQueue.h"
+#include "VulkanDebug.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    constexpr uint32_t kCullGroupSize = 64;    // shaders/occlusion_cull.comp local_size_x
+    constexpr uint32_t kPyramidGroupSize = 8;  // shaders/hiz_build.comp local_size_x/y
+
+    uint32_t previousPow2(uint32_t v)
+    {
+        uint32_t result = 1;
+        while (result * 2 <= v)
+            result *= 2;
+        return result;
+    }
+
+    struct PyramidPushConstants
+    {
+        int32_t srcWidth;
+        int32_t srcHeight;
+        int32_t dstWidth;
+        int32_t dstHeight;
+    };
+
+    void computeBarrier(vk::CommandBuffer cmd, vk::PipelineStageFlags2 srcStage, vk::AccessFlags2 srcAccess,
+                        vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess)
+    {
+        vk::MemoryBarrier2 barrier(srcStage, srcAccess, dstStage, dstAccess);
+        cmd.pipelineBarrier2(vk::DependencyInfo({}, barrier, nullptr, nullptr));
+    }
+}
+
+bool VulkanOcclusionCuller::isSupported(const VulkanDevice &device)
+{
+    return device.getEnabledFeatures12().drawIndirectCount && device.getEnabledFeatures().drawIndirectFirstInstance;
+}
+
+VulkanOcclusionCuller::VulkanOcclusionCuller(const VulkanDevice &device,
+                                             const VulkanSwapchain &swapchain,
+                                             VulkanFrameRing &frameRing,
+                                             uint32_t maxFramesInFlight)
+    : deviceRef(device), swapchainRef(swapchain), frameRingRef(frameRing),
+      frameCounters(maxFramesInFlight, nullptr), frameDrawCounts(maxFramesInFlight, 0)
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    vk::SamplerCreateInfo samplerInfo;
+    samplerInfo.magFilter = vk::Filter::eNearest;
+    samplerInfo.minFilter = vk::Filter::eNearest;
+    samplerInfo.mipmapMode = vk::SamplerMipmapMode::eNearest;
+    samplerInfo.addressModeU = vk::SamplerAddressMode::eClampToEdge;
+    samplerInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
+    samplerInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+    sampler = dev.createSampler(samplerInfo);
+    VK_DEBUG_NAME(dev, sampler, "hiz sampler");
+
+    createPipelines();
+    createPyramid();
+}
+
+VulkanOcclusionCuller::~VulkanOcclusionCuller()
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    destroyPyramid();
+
+    if (visibilityBuffer)
+        dev.destroyBuffer(visibilityBuffer);
+    deviceRef.freeMemory(visibilityMemory);
+
+    if (descriptorPool)
+        dev.destroyDescriptorPool(descriptorPool);
+    if (cullPipeline)
+        dev.destroyPipeline(cullPipeline);
+    if (pyramidPipeline)
+        dev.destroyPipeline(pyramidPipeline);
+    if (cullLayout)
+        dev.destroyPipelineLayout(cullLayout);
+    if (pyramidLayout)
+        dev.destroyPipelineLayout(pyramidLayout);
+    if (cullSetLayout)
+        dev.destroyDescriptorSetLayout(cullSetLayout);
+    if (pyramidSetLayout)
+        dev.destroyDescriptorSetLayout(pyramidSetLayout);
+    if (sampler)
+        dev.destroySampler(sampler);
+}
+
+void VulkanOcclusionCuller::createPipelines()
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    pyramidShader = std::make_unique<VulkanShader>(deviceRef, "shaders/hiz_build.comp.spv");
+    cullShader = std::make_unique<VulkanShader>(deviceRef, "shaders/occlusion_cull.comp.spv");
+
+    // Pyramid reduction: source mip (or depth) -> destination mip
+    std::array<vk::DescriptorSetLayoutBinding, 2> pyramidBindings = {
+        vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute),
+        vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageImage, 1, vk::ShaderStageFlagBits::eCompute)};
+    pyramidSetLayout = dev.createDescriptorSetLayout(
+        vk::DescriptorSetLayoutCreateInfo({}, static_cast<uint32_t>(pyramidBindings.size()), pyramidBindings.data()));
+    VK_DEBUG_NAME(dev, pyramidSetLayout, "hiz build set layout");
+
+    // Culling: per-frame data lives in the frame ring (dynamic offsets), visibility persists
+    std::array<vk::DescriptorSetLayoutBinding, 5> cullBindings = {
+        vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eStorageBufferDynamic, 1, vk::ShaderStageFlagBits::eCompute),
+        vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageBufferDynamic, 1, vk::ShaderStageFlagBits::eCompute),
+        vk::DescriptorSetLayoutBinding(2, vk::DescriptorType::eStorageBufferDynamic, 1, vk::ShaderStageFlagBits::eCompute),
+        vk::DescriptorSetLayoutBinding(3, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute),
+        vk::DescriptorSetLayoutBinding(4, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute)};
+    cullSetLayout = dev.createDescriptorSetLayout(
+        vk::DescriptorSetLayoutCreateInfo({}, static_cast<uint32_t>(cullBindings.size()), cullBindings.data()));
+    VK_DEBUG_NAME(dev, cullSetLayout, "occlusion cull set layout");
+
+    vk::PushConstantRange pyramidPush(vk::ShaderStageFlagBits::eCompute, 0, sizeof(PyramidPushConstants));
+    pyramidLayout = dev.createPipelineLayout(vk::PipelineLayoutCreateInfo({}, 1, &pyramidSetLayout, 1, &pyramidPush));
+    VK_DEBUG_NAME(dev, pyramidLayout, "hiz build layout");
+
+    vk::PushConstantRange cullPush(vk::ShaderStageFlagBits::eCompute, 0, sizeof(CullPushConstants));
+    cullLayout = dev.createPipelineLayout(vk::PipelineLayoutCreateInfo({}, 1, &cullSetLayout, 1, &cullPush));
+    VK_DEBUG_NAME(dev, cullLayout, "occlusion cull layout");
+
+    auto createCompute = [&](vk::ShaderModule module, vk::PipelineLayout layout)
+    {
+        vk::ComputePipelineCreateInfo info;
+        info.stage = vk::PipelineShaderStageCreateInfo({}, vk::ShaderStageFlagBits::eCompute, module, "main");
+        info.layout = layout;
+        auto result = dev.createComputePipeline(nullptr, info);
+        if (result.result != vk::Result::eSuccess)
+            throw std::runtime_error("failed to create occlusion culling pipeline!");
+        return result.value;
+    };
+    pyramidPipeline = createCompute(pyramidShader->getComputeModule(), pyramidLayout);
+    VK_DEBUG_NAME(dev, pyramidPipeline, "hiz build");
+    cullPipeline = createCompute(cullShader->getComputeModule(), cullLayout);
+    VK_DEBUG_NAME(dev, cullPipeline, "occlusion cull");
+
+    std::array<vk::DescriptorPoolSize, 3> poolSizes = {
+        vk::DescriptorPoolSize(vk::DescriptorType::eStorageBufferDynamic, 3),
+        vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, 1),
+        vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, 1)};
+    descriptorPool = dev.createDescriptorPool(
+        vk::DescriptorPoolCreateInfo({}, 1, static_cast<uint32_t>(poolSizes.size()), poolSizes.data()));
+    VK_DEBUG_NAME(dev, descriptorPool, "occlusion cull pool");
+    cullSet = dev.allocateDescriptorSets(vk::DescriptorSetAllocateInfo(descriptorPool, 1, &cullSetLayout))[0];
+    VK_DEBUG_NAME(dev, cullSet, "occlusion cull set");
+
+    // Ring bindings never change: the dynamic offsets select this frame's data
+    vk::DescriptorBufferInfo ringInfo(frameRingRef.getBuffer(), 0, frameRingRef.getStorageWindow());
+    std::array<vk::WriteDescriptorSet, 3> writes = {
+        vk::WriteDescriptorSet(cullSet, 0, 0, 1, vk::DescriptorType::eStorageBufferDynamic, nullptr, &ringInfo),
+        vk::WriteDescriptorSet(cullSet, 1, 0, 1, vk::DescriptorType::eStorageBufferDynamic, nullptr, &ringInfo),
+        vk::WriteDescriptorSet(cullSet, 2, 0, 1, vk::DescriptorType::eStorageBufferDynamic, nullptr, &ringInfo)};
+    dev.updateDescriptorSets(writes, nullptr);
+
+    ensureVisibilityCapacity(1024);
+}
+
+void VulkanOcclusionCuller::createPyramid()
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    depthExtent = swapchainRef.getExtent();
+    pyramidExtent = vk::Extent2D(previousPow2(depthExtent.width), previousPow2(depthExtent.height));
+    uint32_t mipCount = 1;
+    while ((std::max(pyramidExtent.width, pyramidExtent.height) >> mipCount) > 0)
+        ++mipCount;
+
+    vk::ImageCreateInfo imageInfo({}, vk::ImageType::e2D, vk::Format::eR32Sfloat,
+                                  vk::Extent3D(pyramidExtent.width, pyramidExtent.height, 1), mipCount, 1,
+                                  vk::SampleCountFlagBits::e1, vk::ImageTiling::eOptimal,
+                                  vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled,
+                                  vk::SharingMode::eExclusive);
+    pyramidImage = dev.createImage(imageInfo);
+    VK_DEBUG_NAME(dev, pyramidImage, "depth pyramid");
+
+    auto memReq = dev.getImageMemoryRequirements(pyramidImage);
+    vk::MemoryAllocateInfo allocInfo(memReq.size,
+                                     deviceRef.findMemoryType(memReq.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal));
+    pyramidMemory = deviceRef.allocateMemory(allocInfo, MemoryCategory::Attachments);
+    dev.bindImageMemory(pyramidImage, pyramidMemory, 0);
+
+    pyramidView = dev.createImageView(vk::ImageViewCreateInfo(
+        {}, pyramidImage, vk::ImageViewType::e2D, vk::Format::eR32Sfloat, vk::ComponentMapping(),
+        vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, mipCount, 0, 1)));
+    VK_DEBUG_NAME(dev, pyramidView, "depth pyramid view");
+
+    pyramidMipViews.resize(mipCount);
+    for (uint32_t mip = 0; mip < mipCount; ++mip)
+    {
+        pyramidMipViews[mip] = dev.createImageView(vk::ImageViewCreateInfo(
+            {}, pyramidImage, vk::ImageViewType::e2D, vk::Format::eR32Sfloat, vk::ComponentMapping(),
+            vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, mip, 1, 0, 1)));
+        VK_DEBUG_NAME(dev, pyramidMipViews[mip], "depth pyramid mip", mip);
+    }
+
+    std::array<vk::DescriptorPoolSize, 2> poolSizes = {
+        vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, mipCount),
+        vk::DescriptorPoolSize(vk::DescriptorType::eStorageImage, mipCount)};
+    pyramidPool = dev.createDescriptorPool(
+        vk::DescriptorPoolCreateInfo({}, mipCount, static_cast<uint32_t>(poolSizes.size()), poolSizes.data()));
+    VK_DEBUG_NAME(dev, pyramidPool, "hiz build pool");
+
+    std::vector<vk::DescriptorSetLayout> layouts(mipCount, pyramidSetLayout);
+    pyramidSets = dev.allocateDescriptorSets(vk::DescriptorSetAllocateInfo(pyramidPool, mipCount, layouts.data()));
+
+    // Mip 0 reduces the depth buffer (in eShaderReadOnlyOptimal after the early scene pass);
+    // every other mip reduces the one above it. The pyramid itself stays in eGeneral.
+    for (uint32_t mip = 0; mip < mipCount; ++mip)
+    {
+        vk::DescriptorImageInfo srcInfo = mip == 0
+                                              ? vk::DescriptorImageInfo(sampler, swapchainRef.getDepthImageView(),
+                                                                        vk::ImageLayout::eShaderReadOnlyOptimal)
+                                              : vk::DescriptorImageInfo(sampler, pyramidMipViews[mip - 1],
+                                                                        vk::ImageLayout::eGeneral);
+        vk::DescriptorImageInfo dstInfo(nullptr, pyramidMipViews[mip], vk::ImageLayout::eGeneral);
+
+        std::array<vk::WriteDescriptorSet, 2> writes = {
+            vk::WriteDescriptorSet(pyramidSets[mip], 0, 0, 1, vk::DescriptorType::eCombinedImageSampler, &srcInfo),
+            vk::WriteDescriptorSet(pyramidSets[mip], 1, 0, 1, vk::DescriptorType::eStorageImage, &dstInfo)};
+        dev.updateDescriptorSets(writes, nullptr);
+    }
+
+    vk::DescriptorImageInfo pyramidInfo(sampler, pyramidView, vk::ImageLayout::eGeneral);
+    vk::WriteDescriptorSet write(cullSet, 4, 0, 1, vk::DescriptorType::eCombinedImageSampler, &pyramidInfo);
+    dev.updateDescriptorSets(write, nullptr);
+}
+
+void VulkanOcclusionCuller::destroyPyramid()
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    if (pyramidPool)
+    {
+        dev.destroyDescriptorPool(pyramidPool);
+        pyramidPool = vk::DescriptorPool();
+    }
+    pyramidSets.clear();
+
+    for (auto view : pyramidMipViews)
+        dev.destroyImageView(view);
+    pyramidMipViews.clear();
+
+    if (pyramidView)
+    {
+        dev.destroyImageView(pyramidView);
+        pyramidView = vk::ImageView();
+    }
+    if (pyramidImage)
+    {
+        dev.destroyImage(pyramidImage);
+        pyramidImage = vk::Image();
+    }
+    if (pyramidMemory)
+    {
+        deviceRef.freeMemory(pyramidMemory);
+        pyramidMemory = vk::DeviceMemory();
+    }
+}
+
+void VulkanOcclusionCuller::recreate()
+{
+    deviceRef.getLogicalDevice().waitIdle();
+    destroyPyramid();
+    createPyramid();
+
+    // Last frame's visibility was judged at the old resolution; start over
+    visibilityNeedsClear = true;
+}
+
+void VulkanOcclusionCuller::ensureVisibilityCapacity(uint32_t objectCount)
+{
+    if (objectCount <= visibilityCapacity)
+        return;
+
+    auto dev = deviceRef.getLogicalDevice();
+
+    // Rare (scene growth): in-flight frames may still reference the old buffer
+    if (visibilityBuffer)
+    {
+        dev.waitIdle();
+        dev.destroyBuffer(visibilityBuffer);
+        deviceRef.freeMemory(visibilityMemory);
+    }
+
+    visibilityCapacity = std::max(objectCount, visibilityCapacity * 2);
+
+    vk::BufferCreateInfo bufferInfo({}, sizeof(uint32_t) * visibilityCapacity,
+                                    vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+                                    vk::SharingMode::eExclusive);
+    visibilityBuffer = dev.createBuffer(bufferInfo);
+    VK_DEBUG_NAME(dev, visibilityBuffer, "visibility");
+
+    auto memReq = dev.getBufferMemoryRequirements(visibilityBuffer);
+    vk::MemoryAllocateInfo allocInfo(memReq.size,
+                                     deviceRef.findMemoryType(memReq.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal));
+    visibilityMemory = deviceRef.allocateMemory(allocInfo, MemoryCategory::FrameData);
+    dev.bindBufferMemory(visibilityBuffer, visibilityMemory, 0);
+
+    vk::DescriptorBufferInfo visibilityInfo(visibilityBuffer, 0, VK_WHOLE_SIZE);
+    vk::WriteDescriptorSet write(cullSet, 3, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &visibilityInfo);
+    dev.updateDescriptorSets(write, nullptr);
+
+    visibilityNeedsClear = true;
+}
+
+void VulkanOcclusionCuller::beginFrame(uint32_t frameIndex)
+{
+    currentFrame = frameIndex;
+
+    // The frame's fence has been waited on, so its counters in the ring are final
+    if (const uint32_t *counters = frameCounters[frameIndex])
+    {
+        uint32_t drawn = counters[0] + counters[1];
+        culledCount = frameDrawCounts[frameIndex] - std::min(drawn, frameDrawCounts[frameIndex]);
+    }
+    frameCounters[frameIndex] = nullptr;
+}
+
+void VulkanOcclusionCuller::prepare(const RenderQueue &queue, uint32_t objectCount)
+{
+    drawCount = static_cast<uint32_t>(queue.getDrawCount());
+    if (drawCount == 0)
+        return;
+
+    ensureVisibilityCapacity(objectCount);
+
+    RingAllocation cullAlloc = frameRingRef.allocateStorage(sizeof(CullData) * drawCount);
+    queue.writeCullData(static_cast<CullData *>(cullAlloc.data));
+    cullDataOffset = cullAlloc.offset;
+
+    earlyCommandsOffset = frameRingRef.allocateStorage(sizeof(vk::DrawIndirectCommand) * drawCount).offset;
+    lateCommandsOffset = frameRingRef.allocateStorage(sizeof(vk::DrawIndirectCommand) * drawCount).offset;
+
+    // Counts start at zero; the shader finds each group's commands from its first item
+    const std::vector<IndirectGroup> &groups = queue.getIndirectGroups();
+    groupCount = static_cast<uint32_t>(groups.size());
+    const size_t counterBytes = kCountersHeader + sizeof(uint32_t) * 3 * groupCount;
+    RingAllocation counterAlloc = frameRingRef.allocateStorage(counterBytes);
+    std::memset(counterAlloc.data, 0, counterBytes);
+    uint32_t *groupFirst = reinterpret_cast<uint32_t *>(static_cast<char *>(counterAlloc.data) + kCountersHeader);
+    for (uint32_t g = 0; g < groupCount; ++g)
+        groupFirst[g] = groups[g].firstItem;
+    countersOffset = counterAlloc.offset;
+
+    frameCounters[currentFrame] = static_cast<const uint32_t *>(counterAlloc.data);
+    frameDrawCounts[currentFrame] = drawCount;
+}
+
+void VulkanOcclusionCuller::cullEarly(vk::CommandBuffer cmd, const CameraData &camera, const vk::Rect2D &viewport)
+{
+    if (drawCount == 0)
+        return;
+
+    if (visibilityNeedsClear)
+    {
+        // Everything starts hidden: the first frame draws all of it in the late phase
+        cmd.fillBuffer(visibilityBuffer, 0, VK_WHOLE_SIZE, 0);
+        computeBarrier(cmd, vk::PipelineStageFlagBits2::eClear, vk::AccessFlagBits2::eTransferWrite,
+                       vk::PipelineStageFlagBits2::eComputeShader,
+                       vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite);
+        visibilityNeedsClear = false;
+    }
+
+    dispatchCull(cmd, camera, viewport, 0, earlyCommandsOffset);
+}
+
+void VulkanOcclusionCuller::buildPyramid(vk::CommandBuffer cmd)
+{
+    if (drawCount == 0)
+        return;
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, pyramidPipeline);
+
+    vk::Extent2D src = depthExtent;
+    vk::Extent2D dst = pyramidExtent;
+    for (size_t mip = 0; mip < pyramidSets.size(); ++mip)
+    {
+        cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pyramidLayout, 0, pyramidSets[mip], nullptr);
+
+        PyramidPushConstants push = {static_cast<int32_t>(src.width), static_cast<int32_t>(src.height),
+                                     static_cast<int32_t>(dst.width), static_cast<int32_t>(dst.height)};
+        cmd.pushConstants(pyramidLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(push), &push);
+        cmd.dispatch((dst.width + kPyramidGroupSize - 1) / kPyramidGroupSize,
+                     (dst.height + kPyramidGroupSize - 1) / kPyramidGroupSize, 1);
+
+        // Each mip reads the one before it; the last one is the render graph's to synchronize
+        if (mip + 1 < pyramidSets.size())
+        {
+            computeBarrier(cmd, vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite,
+                           vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderRead);
+        }
+
+        src = dst;
+        dst = vk::Extent2D(std::max(dst.width / 2, 1u), std::max(dst.height / 2, 1u));
+    }
+}
+
+void VulkanOcclusionCuller::cullLate(vk::CommandBuffer cmd, const CameraData &camera, const vk::Rect2D &viewport)
+{
+    if (drawCount == 0)
+        return;
+
+    dispatchCull(cmd, camera, viewport, 1, lateCommandsOffset);
+}
+
+void VulkanOcclusionCuller::dispatchCull(vk::CommandBuffer cmd, const CameraData &camera, const vk::Rect2D &viewport,
+                                         uint32_t phase, uint32_t commandsOffset)
+{
+    CullPushConstants push;
+    push.viewProj = camera.viewProj;
+    push.viewportRect = glm::vec4(static_cast<float>(viewport.offset.x) / depthExtent.width,
+                                  static_cast<float>(viewport.offset.y) / depthExtent.height,
+                                  static_cast<float>(viewport.extent.width) / depthExtent.width,
+                                  static_cast<float>(viewport.extent.height) / depthExtent.height);
+    push.pyramidSize = glm::vec2(pyramidExtent.width, pyramidExtent.height);
+    push.drawCount = drawCount;
+    push.phase = phase;
+    push.groupCount = groupCount;
+
+    uint32_t dynamicOffsets[] = {cullDataOffset, commandsOffset, countersOffset};
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, cullPipeline);
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, cullLayout, 0, 1, &cullSet, 3, dynamicOffsets);
+    cmd.pushConstants(cullLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(push), &push);
+    cmd.dispatch((drawCount + kCullGroupSize - 1) / kCullGroupSize, 1, 1);
+
+    // The render graph orders commands and visibility for the GPU; counters are read by the host
+    computeBarrier(cmd, vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite,
+                   vk::PipelineStageFlagBits2::eHost, vk::AccessFlagBits2::eHostRead);
+}
+
+vk::Buffer VulkanOcclusionCuller::getIndirectBuffer() const
+{
+    return frameRingRef.getBuffer();
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+class VulkanDevice;
+class VulkanSwapchain;
+class VulkanFrameRing;
+class VulkanShader;
+class RenderQueue;
+struct CameraData;
+
+// Per-draw culling input (must match shaders/occlusion_cull.comp)
+struct CullData
+{
+    glm::vec4 sphere; // World-space center, radius
+    uint32_t objectIndex = 0;
+    uint32_t vertexCount = 0;
+    uint32_t firstVertex = 0;
+    uint32_t group = 0; // IndirectGroup the draw belongs to
+};
+
+// GPU two-phase occlusion culling against a hierarchical depth (HiZ) pyramid.
+//
+// Per frame: cullEarly() emits indirect draws for objects that were visible last
+// frame; after those are drawn, buildPyramid() reduces the depth buffer into a
+// max-depth mip chain and cullLate() tests every draw against it, emitting draws
+// for objects that became visible and updating the persistent visibility buffer.
+//
+// Each phase compacts its surviving draws to the front of their IndirectGroup's range
+// of commands and counts them per group, so the scene records one vkCmdDrawIndirectCount
+// per group (see RenderQueue::setGpuCulling) and a hidden object costs nothing past its
+// test. Within a group the surviving draws come in no particular order.
+//
+// Requires single-sampled depth (the swapchain depth image, sampled usage).
+class VulkanOcclusionCuller
+{
+public:
+    VulkanOcclusionCuller(const VulkanDevice &device,
+                          const VulkanSwapchain &swapchain,
+                          VulkanFrameRing &frameRing,
+                          uint32_t maxFramesInFlight);
+    ~VulkanOcclusionCuller();
+
+    VulkanOcclusionCuller(const VulkanOcclusionCuller &) = delete;
+    VulkanOcclusionCuller &operator=(const VulkanOcclusionCuller &) = delete;
+
+    // Compacted draws need drawIndirectCount and drawIndirectFirstInstance enabled
+    static bool isSupported(const VulkanDevice &device);
+
+    // Rebuild the pyramid for the current swapchain depth image (after recreation)
+    void recreate();
+
+    // Call after the frame's fence wait; collects that frame's GPU counters
+    void beginFrame(uint32_t frameIndex);
+
+    // Allocate this frame's cull data, indirect commands and counts from the ring.
+    // objectCount bounds the objectIndex of every queued draw; the queue must be GPU-culled.
+    void prepare(const RenderQueue &queue, uint32_t objectCount);
+
+    // Outside a render pass. viewport is the rendered area inside the depth image.
+    // Barriers between the phases and the scene passes are the caller's (see the accessors below).
+    void cullEarly(vk::CommandBuffer cmd, const CameraData &camera, const vk::Rect2D &viewport);
+    void buildPyramid(vk::CommandBuffer cmd);
+    void cullLate(vk::CommandBuffer cmd, const CameraData &camera, const vk::Rect2D &viewport);
+
+    // Indirect commands (room for one vk::DrawIndirectCommand per queued draw) and the
+    // per-group draw counts (one uint32 per IndirectGroup) of each phase, in the ring buffer
+    vk::Buffer getIndirectBuffer() const;
+    vk::DeviceSize getEarlyCommandsOffset() const { return earlyCommandsOffset; }
+    vk::DeviceSize getLateCommandsOffset() const { return lateCommandsOffset; }
+    vk::DeviceSize getEarlyCountsOffset() const { return countsOffset(0); }
+    vk::DeviceSize getLateCountsOffset() const { return countsOffset(1); }
+
+    // Resources the phases share with each other and with the scene passes: the cull phases
+    // read and write visibility, the pyramid build writes the pyramid (eGeneral) from the
+    // depth image (eShaderReadOnlyOptimal) and the late cull samples it
+    vk::Buffer getVisibilityBuffer() const { return visibilityBuffer; }
+    vk::Image getPyramidImage() const { return pyramidImage; }
+    vk::ImageView getPyramidView() const { return pyramidView; }
+    vk::Extent2D getPyramidExtent() const { return pyramidExtent; }
+
+    // Draws skipped by the GPU, from the most recently completed frame
+    uint32_t getCulledCount() const { return culledCount; }
+
+private:
+    struct CullPushConstants
+    {
+        glm::mat4 viewProj;
+        glm::vec4 viewportRect;
+        glm::vec2 pyramidSize;
+        uint32_t drawCount;
+        uint32_t phase;
+        uint32_t groupCount;
+    };
+
+    // Counter block: total draws per phase (read back by the host) and 8 bytes of padding,
+    // each group's first item, then the early and the late per-group counts
+    static constexpr uint32_t kCountersHeader = 16;
+    vk::DeviceSize countsOffset(uint32_t phase) const
+    {
+        return countersOffset + kCountersHeader + sizeof(uint32_t) * groupCount * (1 + phase);
+    }
+
+    void createPipelines();
+    void createPyramid();
+    void destroyPyramid();
+    void ensureVisibilityCapacity(uint32_t objectCount);
+    void dispatchCull(vk::CommandBuffer cmd, const CameraData &camera, const vk::Rect2D &viewport,
+                      uint32_t phase, uint32_t commandsOffset);
+
+    const VulkanDevice &deviceRef;
+    const VulkanSwapchain &swapchainRef;
+    VulkanFrameRing &frameRingRef;
+
+    // Pipelines
+    std::unique_ptr<VulkanShader> pyramidShader;
+    std::unique_ptr<VulkanShader> cullShader;
+    vk::DescriptorSetLayout pyramidSetLayout;
+    vk::DescriptorSetLayout cullSetLayout;
+    vk::PipelineLayout pyramidLayout;
+    vk::PipelineLayout cullLayout;
+    vk::Pipeline pyramidPipeline;
+    vk::Pipeline cullPipeline;
+    vk::DescriptorPool descriptorPool; // Cull set (persistent)
+    vk::DescriptorSet cullSet;
+    vk::Sampler sampler;
+
+    // Depth pyramid (power of two, rounded down from the depth image)
+    vk::Image pyramidImage;
+    vk::DeviceMemory pyramidMemory;
+    vk::ImageView pyramidView; // All mips, sampled by the cull shader
+    std::vector<vk::ImageView> pyramidMipViews;
+    vk::DescriptorPool pyramidPool; // One set per mip, rebuilt with the pyramid
+    std::vector<vk::DescriptorSet> pyramidSets;
+    vk::Extent2D pyramidExtent;
+    vk::Extent2D depthExtent;
+
+    // Persistent per-object visibility (written by the late pass)
+    vk::Buffer visibilityBuffer;
+    vk::DeviceMemory visibilityMemory;
+    uint32_t visibilityCapacity = 0;
+    bool visibilityNeedsClear = false;
+
+    // This frame's ring allocations
+    uint32_t drawCount = 0;
+    uint32_t groupCount = 0;
+    uint32_t cullDataOffset = 0;
+    uint32_t earlyCommandsOffset = 0;
+    uint32_t lateCommandsOffset = 0;
+    uint32_t countersOffset = 0;
+
+    // GPU counters per frame in flight, read back after the fence
+    std::vector<const uint32_t *> frameCounters;
+    std::vector<uint32_t> frameDrawCounts;
+    uint32_t currentFrame = 0;
+    uint32_t culledCount = 0;
+};
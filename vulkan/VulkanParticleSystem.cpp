@@ -0,0 +1,329 @@
+#include "VulkanParticleSystem.h"
+#include "VulkanDevice.h"
+#include "VulkanFrameRing.h"
+#include "VulkanShader.h"
+#include "VulkanGraphicsPipeline.h"
+#include "VulkanDebug.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+namespace
+{
+    constexpr uint32_t kParticleGroupSize = 64;    // shaders/particle.comp local_size_x
+    constexpr uint32_t kMaxEmitters = 64;          // Range of the emitter binding
+    constexpr uint32_t kMaxDispatchGroups = 65535; // Guaranteed maxComputeWorkGroupCount[0]
+    constexpr vk::DeviceSize kSectionAlignment = 256;
+    constexpr float kMaxTimeStep = 0.1f; // Don't let a stall emit (and integrate) a burst
+
+    // 64 bytes, must match Particle in shaders/particle.comp and particle.vert
+    constexpr vk::DeviceSize kParticleSize = 4 * sizeof(glm::vec4);
+
+    vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // Everything a later stage reads from an earlier one: indirect arguments and storage
+    void computeBarrier(vk::CommandBuffer cmd)
+    {
+        vk::MemoryBarrier2 barrier(vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite,
+                                   vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eDrawIndirect,
+                                   vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite |
+                                       vk::AccessFlagBits2::eIndirectCommandRead);
+        cmd.pipelineBarrier2(vk::DependencyInfo({}, barrier, nullptr, nullptr));
+    }
+}
+
+VulkanParticleSystem::VulkanParticleSystem(const VulkanDevice &device, VulkanFrameRing &frameRing,
+                                           const RenderTargetFormats &targets, uint32_t requestedCapacity)
+    : deviceRef(device), frameRingRef(frameRing),
+      capacity(std::clamp(requestedCapacity, kParticleGroupSize, kMaxDispatchGroups * kParticleGroupSize)),
+      lastPrepare(std::chrono::steady_clock::now())
+{
+    createBuffer();
+    createPipelines(targets);
+    createDescriptors();
+    uploadInitialState();
+}
+
+VulkanParticleSystem::~VulkanParticleSystem()
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    drawPipeline.reset();
+    if (descriptorPool)
+        dev.destroyDescriptorPool(descriptorPool);
+    for (vk::Pipeline pipeline : computePipelines)
+        if (pipeline)
+            dev.destroyPipeline(pipeline);
+    if (computeLayout)
+        dev.destroyPipelineLayout(computeLayout);
+    if (drawSetLayout)
+        dev.destroyDescriptorSetLayout(drawSetLayout);
+    if (computeSetLayout)
+        dev.destroyDescriptorSetLayout(computeSetLayout);
+    if (buffer)
+        dev.destroyBuffer(buffer);
+    deviceRef.freeMemory(memory);
+}
+
+void VulkanParticleSystem::createBuffer()
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    particlesOffset = 0;
+    aliveOffset = alignUp(particlesOffset + kParticleSize * capacity, kSectionAlignment);
+    deadOffset = alignUp(aliveOffset + 2 * sizeof(uint32_t) * capacity, kSectionAlignment);
+    countersOffset = alignUp(deadOffset + sizeof(uint32_t) * capacity, kSectionAlignment);
+    const vk::DeviceSize size = countersOffset + sizeof(Counters);
+
+    if (kParticleSize * capacity > deviceRef.getPhysicalDevice().getProperties().limits.maxStorageBufferRange)
+        throw std::runtime_error("too many particles for one storage buffer!");
+
+    buffer = dev.createBuffer(vk::BufferCreateInfo({}, size,
+                                                   vk::BufferUsageFlagBits::eStorageBuffer |
+                                                       vk::BufferUsageFlagBits::eIndirectBuffer |
+                                                       vk::BufferUsageFlagBits::eTransferDst,
+                                                   vk::SharingMode::eExclusive));
+    VK_DEBUG_NAME(dev, buffer, "particles");
+
+    auto memReq = dev.getBufferMemoryRequirements(buffer);
+    vk::MemoryAllocateInfo allocInfo(memReq.size,
+                                     deviceRef.findMemoryType(memReq.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal));
+    memory = deviceRef.allocateMemory(allocInfo, MemoryCategory::FrameData);
+    dev.bindBufferMemory(buffer, memory, 0);
+}
+
+void VulkanParticleSystem::createPipelines(const RenderTargetFormats &targets)
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    computeShader = std::make_unique<VulkanShader>(deviceRef, "shaders/particle.comp.spv");
+    drawShader = std::make_unique<VulkanShader>(deviceRef, "shaders/particle.vert.spv", "shaders/particle.frag.spv");
+
+    // Particles, alive lists, dead list, counters; emitters come from the frame ring
+    std::array<vk::DescriptorSetLayoutBinding, 5> computeBindings = {
+        vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute),
+        vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute),
+        vk::DescriptorSetLayoutBinding(2, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute),
+        vk::DescriptorSetLayoutBinding(3, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute),
+        vk::DescriptorSetLayoutBinding(4, vk::DescriptorType::eStorageBufferDynamic, 1,
+                                       vk::ShaderStageFlagBits::eCompute)};
+    computeSetLayout = dev.createDescriptorSetLayout(
+        vk::DescriptorSetLayoutCreateInfo({}, static_cast<uint32_t>(computeBindings.size()), computeBindings.data()));
+    VK_DEBUG_NAME(dev, computeSetLayout, "particle compute set layout");
+
+    // The vertex shader reads particles through this frame's alive list
+    std::array<vk::DescriptorSetLayoutBinding, 2> drawBindings = {
+        vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eVertex),
+        vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eVertex)};
+    drawSetLayout = dev.createDescriptorSetLayout(
+        vk::DescriptorSetLayoutCreateInfo({}, static_cast<uint32_t>(drawBindings.size()), drawBindings.data()));
+    VK_DEBUG_NAME(dev, drawSetLayout, "particle draw set layout");
+
+    vk::PushConstantRange push(vk::ShaderStageFlagBits::eCompute, 0, sizeof(SimulatePushConstants));
+    computeLayout = dev.createPipelineLayout(vk::PipelineLayoutCreateInfo({}, 1, &computeSetLayout, 1, &push));
+    VK_DEBUG_NAME(dev, computeLayout, "particle compute layout");
+
+    // One shader, specialized per stage (constant_id 0)
+    const char *stageNames[] = {"particle kickoff", "particle emit", "particle simulate"};
+    for (uint32_t stage = 0; stage < computePipelines.size(); ++stage)
+    {
+        vk::SpecializationMapEntry entry(0, 0, sizeof(uint32_t));
+        vk::SpecializationInfo specInfo(1, &entry, sizeof(uint32_t), &stage);
+
+        vk::ComputePipelineCreateInfo info;
+        info.stage = vk::PipelineShaderStageCreateInfo({}, vk::ShaderStageFlagBits::eCompute,
+                                                       computeShader->getComputeModule(), "main", &specInfo);
+        info.layout = computeLayout;
+        auto result = dev.createComputePipeline(nullptr, info);
+        if (result.result != vk::Result::eSuccess)
+            throw std::runtime_error("failed to create particle pipeline!");
+        computePipelines[stage] = result.value;
+        VK_DEBUG_NAME(dev, computePipelines[stage], stageNames[stage]);
+    }
+
+    // Camera from the frame ring (set 0), particles from this system (set 1)
+    std::array<vk::DescriptorSetLayout, 2> drawLayouts = {frameRingRef.getSetLayout(), drawSetLayout};
+    drawPipeline = std::make_unique<VulkanGraphicsPipeline>(deviceRef, targets, *drawShader,
+                                                            PipelineDescs::kParticles, nullptr, 0, nullptr,
+                                                            static_cast<uint32_t>(drawLayouts.size()),
+                                                            drawLayouts.data());
+}
+
+void VulkanParticleSystem::createDescriptors()
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    std::array<vk::DescriptorPoolSize, 2> poolSizes = {
+        vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, 6),
+        vk::DescriptorPoolSize(vk::DescriptorType::eStorageBufferDynamic, 1)};
+    descriptorPool = dev.createDescriptorPool(
+        vk::DescriptorPoolCreateInfo({}, 2, static_cast<uint32_t>(poolSizes.size()), poolSizes.data()));
+    VK_DEBUG_NAME(dev, descriptorPool, "particle pool");
+
+    std::array<vk::DescriptorSetLayout, 2> layouts = {computeSetLayout, drawSetLayout};
+    auto sets = dev.allocateDescriptorSets(
+        vk::DescriptorSetAllocateInfo(descriptorPool, static_cast<uint32_t>(layouts.size()), layouts.data()));
+    computeSet = sets[0];
+    drawSet = sets[1];
+    VK_DEBUG_NAME(dev, computeSet, "particle compute set");
+    VK_DEBUG_NAME(dev, drawSet, "particle draw set");
+
+    vk::DescriptorBufferInfo particlesInfo(buffer, particlesOffset, kParticleSize * capacity);
+    vk::DescriptorBufferInfo aliveInfo(buffer, aliveOffset, 2 * sizeof(uint32_t) * capacity);
+    vk::DescriptorBufferInfo deadInfo(buffer, deadOffset, sizeof(uint32_t) * capacity);
+    vk::DescriptorBufferInfo countersInfo(buffer, countersOffset, sizeof(Counters));
+    vk::DescriptorBufferInfo emittersInfo(frameRingRef.getBuffer(), 0, sizeof(ParticleEmitter) * kMaxEmitters);
+    std::array<vk::WriteDescriptorSet, 7> writes = {
+        vk::WriteDescriptorSet(computeSet, 0, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &particlesInfo),
+        vk::WriteDescriptorSet(computeSet, 1, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &aliveInfo),
+        vk::WriteDescriptorSet(computeSet, 2, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &deadInfo),
+        vk::WriteDescriptorSet(computeSet, 3, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &countersInfo),
+        vk::WriteDescriptorSet(computeSet, 4, 0, 1, vk::DescriptorType::eStorageBufferDynamic, nullptr, &emittersInfo),
+        vk::WriteDescriptorSet(drawSet, 0, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &particlesInfo),
+        vk::WriteDescriptorSet(drawSet, 1, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &aliveInfo)};
+    dev.updateDescriptorSets(writes, nullptr);
+}
+
+void VulkanParticleSystem::uploadInitialState()
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    // Every particle starts on the dead list; nothing was drawn "last frame"
+    const vk::DeviceSize size = countersOffset + sizeof(Counters) - deadOffset;
+    std::vector<uint8_t> initial(static_cast<size_t>(size), 0);
+    auto *dead = reinterpret_cast<uint32_t *>(initial.data());
+    std::iota(dead, dead + capacity, 0u);
+
+    Counters counters = {};
+    counters.deadCount = capacity;
+    counters.drawArgs[0] = 6;
+    std::memcpy(initial.data() + (countersOffset - deadOffset), &counters, sizeof(counters));
+
+    vk::Buffer stagingBuffer = dev.createBuffer(
+        vk::BufferCreateInfo({}, size, vk::BufferUsageFlagBits::eTransferSrc, vk::SharingMode::eExclusive));
+    auto memReq = dev.getBufferMemoryRequirements(stagingBuffer);
+    vk::MemoryAllocateInfo allocInfo(memReq.size,
+                                     deviceRef.findMemoryType(memReq.memoryTypeBits,
+                                                              vk::MemoryPropertyFlagBits::eHostVisible |
+                                                                  vk::MemoryPropertyFlagBits::eHostCoherent));
+    vk::DeviceMemory stagingMemory = deviceRef.allocateMemory(allocInfo, MemoryCategory::Staging);
+    dev.bindBufferMemory(stagingBuffer, stagingMemory, 0);
+
+    void *mapped = dev.mapMemory(stagingMemory, 0, size);
+    std::memcpy(mapped, initial.data(), initial.size());
+    dev.unmapMemory(stagingMemory);
+
+    vk::CommandPool cmdPool = dev.createCommandPool(vk::CommandPoolCreateInfo({}, deviceRef.getGraphicsQueueFamily()));
+    vk::CommandBuffer cmd =
+        dev.allocateCommandBuffers(vk::CommandBufferAllocateInfo(cmdPool, vk::CommandBufferLevel::ePrimary, 1))[0];
+
+    cmd.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    cmd.copyBuffer(stagingBuffer, buffer, vk::BufferCopy(0, deadOffset, size));
+    cmd.end();
+
+    vk::SubmitInfo submitInfo(0, nullptr, nullptr, 1, &cmd);
+    deviceRef.getGraphicsQueue().submit(submitInfo, {});
+    deviceRef.getGraphicsQueue().waitIdle();
+
+    dev.freeCommandBuffers(cmdPool, cmd);
+    dev.destroyCommandPool(cmdPool);
+    dev.destroyBuffer(stagingBuffer);
+    deviceRef.freeMemory(stagingMemory);
+}
+
+uint32_t VulkanParticleSystem::addEmitter(const ParticleEmitter &emitter)
+{
+    if (emitters.size() >= kMaxEmitters)
+        throw std::runtime_error("too many particle emitters!");
+    emitters.push_back(emitter);
+    emitRemainders.push_back(0.0f);
+    return static_cast<uint32_t>(emitters.size() - 1);
+}
+
+void VulkanParticleSystem::prepare()
+{
+    auto now = std::chrono::steady_clock::now();
+    float dt = std::chrono::duration<float>(now - lastPrepare).count();
+    lastPrepare = now;
+    prepare(dt);
+}
+
+void VulkanParticleSystem::prepare(float dt)
+{
+    frameDt = std::clamp(dt, 0.0f, kMaxTimeStep);
+
+    // Whole particles this frame, the fraction carries over so low rates still emit
+    requested = 0;
+    for (size_t i = 0; i < emitters.size(); ++i)
+    {
+        ParticleEmitter &emitter = emitters[i];
+        float wanted = emitRemainders[i] + std::max(emitter.positionRate.w, 0.0f) * frameDt;
+        float whole = std::floor(wanted);
+        emitRemainders[i] = wanted - whole;
+
+        emitter.first = requested;
+        emitter.count = static_cast<uint32_t>(std::min(whole, static_cast<float>(capacity)));
+        requested += emitter.count;
+    }
+
+    // The whole binding range must lie inside the ring, however many emitters there are
+    RingAllocation allocation = frameRingRef.allocateStorage(sizeof(ParticleEmitter) * kMaxEmitters);
+    if (emitters.empty())
+        std::memset(allocation.data, 0, sizeof(ParticleEmitter)); // The shader always reads one
+    else
+        std::memcpy(allocation.data, emitters.data(), sizeof(ParticleEmitter) * emitters.size());
+    emitterOffset = allocation.offset;
+}
+
+void VulkanParticleSystem::simulate(vk::CommandBuffer cmd)
+{
+    SimulatePushConstants push;
+    push.gravityDt = glm::vec4(gravity, frameDt);
+    push.emitterCount = static_cast<uint32_t>(emitters.size());
+    push.requested = requested;
+    push.aliveIn = aliveIn;
+    push.capacity = capacity;
+    push.seed = ++seed;
+
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, computeLayout, 0, computeSet, emitterOffset);
+    cmd.pushConstants(computeLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(push), &push);
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, computePipelines[0]);
+    cmd.dispatch(1, 1, 1);
+    computeBarrier(cmd);
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, computePipelines[1]);
+    cmd.dispatchIndirect(buffer, countersOffset + offsetof(Counters, emitDispatch));
+    computeBarrier(cmd);
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, computePipelines[2]);
+    cmd.dispatchIndirect(buffer, countersOffset + offsetof(Counters, simulateDispatch));
+
+    // Survivors went to the other list; it is this frame's draw list and next frame's input
+    aliveIn = 1 - aliveIn;
+}
+
+void VulkanParticleSystem::draw(vk::CommandBuffer cmd, uint32_t cameraOffset) const
+{
+    const std::array<vk::DescriptorSet, 2> sets = {frameRingRef.getDescriptorSet(), drawSet};
+    const uint32_t dynamicOffsets[] = {cameraOffset, 0};
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, drawPipeline->get());
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, drawPipeline->getLayout(), 0,
+                           static_cast<uint32_t>(sets.size()), sets.data(), 2, dynamicOffsets);
+
+    // The vertex shader reads alive[drawIndex + gl_InstanceIndex]
+    DrawPushConstants push;
+    push.drawIndex = aliveIn * capacity;
+    cmd.pushConstants(drawPipeline->getLayout(), vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment,
+                      0, sizeof(DrawPushConstants), &push);
+
+    cmd.drawIndirect(buffer, countersOffset + offsetof(Counters, drawArgs), 1, sizeof(vk::DrawIndirectCommand));
+}
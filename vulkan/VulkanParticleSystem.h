@@ -0,0 +1,133 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+#include <glm/glm.hpp>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+class VulkanDevice;
+class VulkanFrameRing;
+class VulkanShader;
+class VulkanGraphicsPipeline;
+struct RenderTargetFormats;
+
+// One particle source (std430, must match shaders/particle.comp). The CPU fills in
+// position, velocity, rate and looks; first/count are written by prepare().
+struct ParticleEmitter
+{
+    glm::vec4 positionRate = glm::vec4(0.0f, 0.0f, 0.0f, 100.0f); // w: particles per second
+    glm::vec4 velocitySpread = glm::vec4(0.0f, 1.0f, 0.0f, 0.5f); // w: random velocity added per axis
+    glm::vec4 color = glm::vec4(1.0f);
+    float lifetime = 2.0f; // Seconds, randomized by +-25%
+    float size = 0.05f;    // World-space quad size
+    uint32_t first = 0;
+    uint32_t count = 0;
+};
+
+// Particles emitted, simulated and recycled entirely in compute, then drawn with one
+// indirect draw whose instance count the simulation writes. Per frame the CPU only
+// writes its emitters into the frame ring; it never learns how many particles are alive.
+//
+// All state lives in one device buffer: the particles, two alive lists that ping-pong
+// between frames, a dead list (a stack of free particle indices) and a block of counters
+// that doubles as the dispatch and draw arguments. simulate() records three dispatches:
+// a single-invocation kickoff that sizes the other two, emission from the dead list, and
+// the simulation that compacts survivors into the next alive list.
+class VulkanParticleSystem
+{
+public:
+    VulkanParticleSystem(const VulkanDevice &device, VulkanFrameRing &frameRing, const RenderTargetFormats &targets,
+                         uint32_t capacity);
+    ~VulkanParticleSystem();
+
+    VulkanParticleSystem(const VulkanParticleSystem &) = delete;
+    VulkanParticleSystem &operator=(const VulkanParticleSystem &) = delete;
+
+    // Returns the index for getEmitter()
+    uint32_t addEmitter(const ParticleEmitter &emitter);
+    ParticleEmitter &getEmitter(uint32_t index) { return emitters[index]; }
+    uint32_t getEmitterCount() const { return static_cast<uint32_t>(emitters.size()); }
+
+    void setGravity(const glm::vec3 &acceleration) { gravity = acceleration; }
+
+    // Once per frame, after the frame ring's beginFrame(): turns emission rates into this
+    // frame's particle counts and writes the emitters into the ring. Without a time step
+    // the time since the last call is used.
+    void prepare(float dt);
+    void prepare();
+
+    // Compute passes: emit, simulate and compact. The render graph orders them against
+    // last frame's draw (see getBuffer()).
+    void simulate(vk::CommandBuffer cmd);
+
+    // Inside the scene pass, after simulate(): one indirect draw of the surviving particles
+    void draw(vk::CommandBuffer cmd, uint32_t cameraOffset) const;
+
+    // Written by simulate() (compute), read by draw() (indirect arguments and vertex shader)
+    vk::Buffer getBuffer() const { return buffer; }
+    uint32_t getCapacity() const { return capacity; }
+
+private:
+    // Mirrors the counter block in shaders/particle.comp
+    struct Counters
+    {
+        uint32_t deadCount;
+        uint32_t aliveCount;
+        uint32_t emitCount;
+        uint32_t padding;
+        uint32_t emitDispatch[3];
+        uint32_t simulateDispatch[3];
+        uint32_t drawArgs[4];
+    };
+
+    struct SimulatePushConstants
+    {
+        glm::vec4 gravityDt;
+        uint32_t emitterCount;
+        uint32_t requested;
+        uint32_t aliveIn;
+        uint32_t capacity;
+        uint32_t seed;
+    };
+
+    void createBuffer();
+    void createPipelines(const RenderTargetFormats &targets);
+    void createDescriptors();
+    void uploadInitialState();
+
+    const VulkanDevice &deviceRef;
+    VulkanFrameRing &frameRingRef;
+    const uint32_t capacity;
+
+    vk::Buffer buffer;
+    vk::DeviceMemory memory;
+    vk::DeviceSize particlesOffset = 0;
+    vk::DeviceSize aliveOffset = 0; // Two lists of `capacity` indices
+    vk::DeviceSize deadOffset = 0;
+    vk::DeviceSize countersOffset = 0;
+
+    std::unique_ptr<VulkanShader> computeShader;
+    std::unique_ptr<VulkanShader> drawShader;
+    vk::DescriptorSetLayout computeSetLayout;
+    vk::DescriptorSetLayout drawSetLayout;
+    vk::PipelineLayout computeLayout;
+    std::array<vk::Pipeline, 3> computePipelines; // Kickoff, emit, simulate
+    std::unique_ptr<VulkanGraphicsPipeline> drawPipeline;
+    vk::DescriptorPool descriptorPool;
+    vk::DescriptorSet computeSet;
+    vk::DescriptorSet drawSet;
+
+    std::vector<ParticleEmitter> emitters;
+    std::vector<float> emitRemainders; // Fractional particles carried to the next frame
+    glm::vec3 gravity = glm::vec3(0.0f, -9.81f, 0.0f);
+
+    // This frame's inputs, set by prepare()
+    float frameDt = 0.0f;
+    uint32_t requested = 0;
+    uint32_t emitterOffset = 0;
+    uint32_t aliveIn = 0;
+    uint32_t seed = 0;
+    std::chrono::steady_clock::time_point lastPrepare;
+};
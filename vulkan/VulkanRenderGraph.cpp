@@ -0,0 +1,842 @@
+#include "VulkanRenderGraph.h"
+#include "VulkanDevice.h"
+#include "VulkanDebug.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+namespace
+{
+    constexpr vk::AccessFlags2 kWriteAccess =
+        vk::AccessFlagBits2::eShaderWrite | vk::AccessFlagBits2::eShaderStorageWrite |
+        vk::AccessFlagBits2::eColorAttachmentWrite | vk::AccessFlagBits2::eDepthStencilAttachmentWrite |
+        vk::AccessFlagBits2::eTransferWrite | vk::AccessFlagBits2::eHostWrite | vk::AccessFlagBits2::eMemoryWrite;
+
+    constexpr vk::PipelineStageFlags2 kDepthStages =
+        vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests;
+
+    // Image usage implied by an access (transient images are created with the union)
+    vk::ImageUsageFlags usageFor(const RGAccess &access)
+    {
+        vk::ImageUsageFlags usage;
+        if (access.access & (vk::AccessFlagBits2::eColorAttachmentRead | vk::AccessFlagBits2::eColorAttachmentWrite))
+            usage |= vk::ImageUsageFlagBits::eColorAttachment;
+        if (access.access & (vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite))
+            usage |= vk::ImageUsageFlagBits::eDepthStencilAttachment;
+        if (access.access & vk::AccessFlagBits2::eShaderSampledRead)
+            usage |= vk::ImageUsageFlagBits::eSampled;
+        if (access.access & (vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite))
+            usage |= vk::ImageUsageFlagBits::eStorage;
+        if (access.access & vk::AccessFlagBits2::eTransferRead)
+            usage |= vk::ImageUsageFlagBits::eTransferSrc;
+        if (access.access & vk::AccessFlagBits2::eTransferWrite)
+            usage |= vk::ImageUsageFlagBits::eTransferDst;
+        return usage;
+    }
+
+    RGAccess colorAttachment(vk::AttachmentLoadOp loadOp)
+    {
+        vk::AccessFlags2 access = vk::AccessFlagBits2::eColorAttachmentWrite;
+        if (loadOp == vk::AttachmentLoadOp::eLoad)
+            access |= vk::AccessFlagBits2::eColorAttachmentRead;
+        return {vk::PipelineStageFlagBits2::eColorAttachmentOutput, access, vk::ImageLayout::eColorAttachmentOptimal};
+    }
+
+    RGAccess depthAttachment()
+    {
+        return {kDepthStages,
+                vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+                vk::ImageLayout::eDepthStencilAttachmentOptimal};
+    }
+}
+
+// ---------------------------------------------------------------------------------------------
+// Accesses
+
+bool RGAccess::writes() const
+{
+    return static_cast<bool>(access & kWriteAccess);
+}
+
+RGAccess RGAccess::sampled(vk::PipelineStageFlags2 stages, vk::ImageLayout layout)
+{
+    return {stages, vk::AccessFlagBits2::eShaderSampledRead, layout};
+}
+
+RGAccess RGAccess::storageRead(vk::PipelineStageFlags2 stages, vk::ImageLayout layout)
+{
+    return {stages, vk::AccessFlagBits2::eShaderStorageRead, layout};
+}
+
+RGAccess RGAccess::storageWrite(vk::PipelineStageFlags2 stages, vk::ImageLayout layout)
+{
+    return {stages, vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite, layout};
+}
+
+RGAccess RGAccess::drawInputs()
+{
+    return {vk::PipelineStageFlagBits2::eDrawIndirect | vk::PipelineStageFlagBits2::eVertexShader |
+                vk::PipelineStageFlagBits2::eFragmentShader,
+            vk::AccessFlagBits2::eIndirectCommandRead | vk::AccessFlagBits2::eUniformRead |
+                vk::AccessFlagBits2::eShaderStorageRead};
+}
+
+RGAccess RGAccess::transferWrite()
+{
+    return {vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferWrite,
+            vk::ImageLayout::eTransferDstOptimal};
+}
+
+RGAccess RGAccess::transferRead()
+{
+    return {vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferRead,
+            vk::ImageLayout::eTransferSrcOptimal};
+}
+
+// ---------------------------------------------------------------------------------------------
+// Declaration
+
+vk::Image VulkanRenderGraph::PassContext::image(Handle handle) const
+{
+    return graph.resources.at(handle).image;
+}
+
+vk::ImageView VulkanRenderGraph::PassContext::view(Handle handle) const
+{
+    return graph.resources.at(handle).view;
+}
+
+vk::Buffer VulkanRenderGraph::PassContext::buffer(Handle handle) const
+{
+    return graph.resources.at(handle).buffer;
+}
+
+VulkanRenderGraph::PassBuilder &VulkanRenderGraph::PassBuilder::color(Handle image, vk::AttachmentLoadOp loadOp,
+                                                                      const vk::ClearColorValue &clear)
+{
+    Pass &p = graph.passes[pass];
+    p.colors.push_back({image, loadOp, vk::ClearValue(clear)});
+
+    RGAccess access = colorAttachment(loadOp);
+    p.writes.push_back({image, access});
+    if (loadOp == vk::AttachmentLoadOp::eLoad)
+        p.reads.push_back({image, access});
+    return *this;
+}
+
+VulkanRenderGraph::PassBuilder &VulkanRenderGraph::PassBuilder::depth(Handle image, vk::AttachmentLoadOp loadOp,
+                                                                      float clear)
+{
+    Pass &p = graph.passes[pass];
+    if (p.hasDepth)
+        throw std::runtime_error("render graph pass '" + p.name + "' has two depth attachments!");
+
+    p.hasDepth = true;
+    p.depthAttachment = {image, loadOp, vk::ClearValue(vk::ClearDepthStencilValue(clear, 0))};
+
+    p.writes.push_back({image, depthAttachment()});
+    if (loadOp == vk::AttachmentLoadOp::eLoad)
+        p.reads.push_back({image, depthAttachment()});
+    return *this;
+}
+
+VulkanRenderGraph::PassBuilder &VulkanRenderGraph::PassBuilder::resolve(Handle image)
+{
+    Pass &p = graph.passes[pass];
+    p.resolves.push_back({image, vk::AttachmentLoadOp::eDontCare, vk::ClearValue()});
+    p.writes.push_back({image, colorAttachment(vk::AttachmentLoadOp::eDontCare)});
+    return *this;
+}
+
+VulkanRenderGraph::PassBuilder &VulkanRenderGraph::PassBuilder::read(Handle resource, const RGAccess &access)
+{
+    graph.passes[pass].reads.push_back({resource, access});
+    return *this;
+}
+
+VulkanRenderGraph::PassBuilder &VulkanRenderGraph::PassBuilder::write(Handle resource, const RGAccess &access)
+{
+    graph.passes[pass].writes.push_back({resource, access});
+    return *this;
+}
+
+VulkanRenderGraph::PassBuilder &VulkanRenderGraph::PassBuilder::sideEffects()
+{
+    graph.passes[pass].sideEffects = true;
+    return *this;
+}
+
+VulkanRenderGraph::PassBuilder &VulkanRenderGraph::PassBuilder::secondaryCommandBuffers()
+{
+    graph.passes[pass].secondaryContents = true;
+    return *this;
+}
+
+VulkanRenderGraph::VulkanRenderGraph(const VulkanDevice &device, uint32_t maxFramesInFlight)
+    : deviceRef(device), timedPasses(maxFramesInFlight)
+{
+    auto physicalDevice = deviceRef.getPhysicalDevice();
+    auto queueFamilies = physicalDevice.getQueueFamilyProperties();
+
+    // Timings are optional: some queues have no timestamp support
+    if (queueFamilies[deviceRef.getGraphicsQueueFamily()].timestampValidBits > 0)
+    {
+        vk::QueryPoolCreateInfo queryInfo({}, vk::QueryType::eTimestamp, maxFramesInFlight * kMaxTimedPasses * 2);
+        timestampPool = deviceRef.getLogicalDevice().createQueryPool(queryInfo);
+        VK_DEBUG_NAME(deviceRef.getLogicalDevice(), timestampPool, "pass timestamps");
+        timestampPeriodNs = physicalDevice.getProperties().limits.timestampPeriod;
+    }
+}
+
+VulkanRenderGraph::~VulkanRenderGraph()
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    destroyTransients();
+
+    if (timestampPool)
+        dev.destroyQueryPool(timestampPool);
+}
+
+void VulkanRenderGraph::reset()
+{
+    resources.clear();
+    passes.clear();
+}
+
+VulkanRenderGraph::Handle VulkanRenderGraph::importImage(const std::string &name, vk::Image image, vk::ImageView view,
+                                                         const RGImageDesc &desc, vk::ImageLayout layout,
+                                                         vk::PipelineStageFlags2 lastStages, vk::AccessFlags2 lastAccess)
+{
+    Resource res;
+    res.name = name;
+    res.isImage = true;
+    res.imported = true;
+    res.desc = desc;
+    res.image = image;
+    res.view = view;
+    res.layout = layout;
+    res.writeStages = lastStages;
+    res.writeAccess = lastAccess;
+    resources.push_back(res);
+    return static_cast<Handle>(resources.size() - 1);
+}
+
+VulkanRenderGraph::Handle VulkanRenderGraph::importBuffer(const std::string &name, vk::Buffer buffer,
+                                                          vk::PipelineStageFlags2 lastStages, vk::AccessFlags2 lastAccess)
+{
+    Resource res;
+    res.name = name;
+    res.imported = true;
+    res.buffer = buffer;
+    res.writeStages = lastStages;
+    res.writeAccess = lastAccess;
+    resources.push_back(res);
+    return static_cast<Handle>(resources.size() - 1);
+}
+
+VulkanRenderGraph::Handle VulkanRenderGraph::createImage(const std::string &name, const RGImageDesc &desc)
+{
+    Resource res;
+    res.name = name;
+    res.isImage = true;
+    res.desc = desc;
+    resources.push_back(res);
+    return static_cast<Handle>(resources.size() - 1);
+}
+
+void VulkanRenderGraph::exportImage(Handle image, vk::ImageLayout finalLayout)
+{
+    Resource &res = resources.at(image);
+    res.exported = true;
+    res.finalLayout = finalLayout;
+}
+
+VulkanRenderGraph::PassBuilder VulkanRenderGraph::addPass(const std::string &name, ExecuteFn execute)
+{
+    Pass pass;
+    pass.name = name;
+    pass.execute = std::move(execute);
+    passes.push_back(std::move(pass));
+    return PassBuilder(*this, static_cast<uint32_t>(passes.size() - 1));
+}
+
+// ---------------------------------------------------------------------------------------------
+// Compilation
+
+void VulkanRenderGraph::cullPasses()
+{
+    // Walk backwards from what leaves the graph: exported images, imported buffers
+    // (visible to the host and later frames) and passes with side effects
+    std::vector<bool> needed(resources.size(), false);
+    for (size_t i = 0; i < resources.size(); ++i)
+        needed[i] = resources[i].exported || (resources[i].imported && !resources[i].isImage);
+
+    for (size_t i = passes.size(); i-- > 0;)
+    {
+        Pass &pass = passes[i];
+        bool keep = pass.sideEffects;
+        for (const Use &use : pass.writes)
+            keep = keep || needed[use.resource];
+
+        pass.culled = !keep;
+        if (!keep)
+            continue;
+
+        for (const Use &use : pass.reads)
+            needed[use.resource] = true;
+    }
+}
+
+bool VulkanRenderGraph::isReadLater(Handle resource, uint32_t afterPass) const
+{
+    for (size_t i = afterPass + 1; i < passes.size(); ++i)
+    {
+        if (passes[i].culled)
+            continue;
+        for (const Use &use : passes[i].reads)
+        {
+            if (use.resource == resource)
+                return true;
+        }
+    }
+    return false;
+}
+
+void VulkanRenderGraph::allocateTransients()
+{
+    // Lifetimes and usage of every transient image a surviving pass touches
+    std::vector<Handle> transients;
+    std::string signature;
+    for (Handle h = 0; h < resources.size(); ++h)
+    {
+        Resource &res = resources[h];
+        if (res.imported || !res.isImage)
+            continue;
+
+        for (uint32_t i = 0; i < passes.size(); ++i)
+        {
+            if (passes[i].culled)
+                continue;
+            for (const auto *uses : {&passes[i].reads, &passes[i].writes})
+            {
+                for (const Use &use : *uses)
+                {
+                    if (use.resource != h)
+                        continue;
+                    res.usage |= usageFor(use.access);
+                    res.firstUse = std::min(res.firstUse, i);
+                    res.lastUse = std::max(res.lastUse, i);
+                }
+            }
+        }
+        if (res.firstUse == UINT32_MAX)
+            continue;
+
+        transients.push_back(h);
+        signature += res.name + ":" + std::to_string(static_cast<uint32_t>(res.desc.format)) + ":" +
+                     std::to_string(res.desc.extent.width) + "x" + std::to_string(res.desc.extent.height) + ":" +
+                     std::to_string(static_cast<uint32_t>(res.desc.samples)) + ":" +
+                     std::to_string(static_cast<uint32_t>(res.usage)) + ":" + std::to_string(res.firstUse) + "-" +
+                     std::to_string(res.lastUse) + ";";
+    }
+
+    // Same images with the same lifetimes as last frame: keep the allocation
+    if (signature != transientSignature)
+    {
+        destroyTransients();
+        transientSignature = signature;
+
+        auto dev = deviceRef.getLogicalDevice();
+        std::vector<vk::MemoryRequirements> requirements;
+        for (Handle h : transients)
+        {
+            const Resource &res = resources[h];
+            vk::ImageCreateInfo imageInfo({}, vk::ImageType::e2D, res.desc.format,
+                                          vk::Extent3D(res.desc.extent.width, res.desc.extent.height, 1), 1, 1,
+                                          res.desc.samples, vk::ImageTiling::eOptimal, res.usage,
+                                          vk::SharingMode::eExclusive);
+            TransientImage transient;
+            transient.resource = h;
+            transient.image = dev.createImage(imageInfo);
+            VK_DEBUG_NAME(dev, transient.image, res.name.c_str());
+            requirements.push_back(dev.getImageMemoryRequirements(transient.image));
+            transientImages.push_back(transient);
+            transientRequested += requirements.back().size;
+        }
+
+        // Greedy aliasing: largest first, into the first block whose occupants are all
+        // dead before this image is born (or born after it dies)
+        std::vector<size_t> order(transients.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(),
+                  [&](size_t a, size_t b) { return requirements[a].size > requirements[b].size; });
+
+        for (size_t i : order)
+        {
+            const Resource &res = resources[transients[i]];
+            const vk::MemoryRequirements &req = requirements[i];
+
+            uint32_t chosen = static_cast<uint32_t>(transientBlocks.size());
+            for (uint32_t b = 0; b < transientBlocks.size(); ++b)
+            {
+                const TransientBlock &block = transientBlocks[b];
+                if ((block.memoryTypeBits & req.memoryTypeBits) == 0 || block.size < req.size)
+                    continue;
+
+                bool overlaps = std::any_of(block.lifetimes.begin(), block.lifetimes.end(),
+                                            [&](const std::pair<uint32_t, uint32_t> &life)
+                                            { return res.firstUse <= life.second && life.first <= res.lastUse; });
+                if (!overlaps)
+                {
+                    chosen = b;
+                    break;
+                }
+            }
+            if (chosen == transientBlocks.size())
+            {
+                transientBlocks.emplace_back();
+                transientBlocks.back().size = req.size;
+            }
+
+            TransientBlock &block = transientBlocks[chosen];
+            block.memoryTypeBits &= req.memoryTypeBits;
+            block.lifetimes.emplace_back(res.firstUse, res.lastUse);
+            transientImages[i].block = chosen;
+        }
+
+        for (TransientBlock &block : transientBlocks)
+        {
+            block.memory = deviceRef.allocateMemory(
+                vk::MemoryAllocateInfo(block.size, deviceRef.findMemoryType(block.memoryTypeBits,
+                                                                            vk::MemoryPropertyFlagBits::eDeviceLocal)),
+                MemoryCategory::Attachments);
+            transientAllocated += block.size;
+        }
+
+        for (TransientImage &transient : transientImages)
+        {
+            const Resource &res = resources[transient.resource];
+            dev.bindImageMemory(transient.image, transientBlocks[transient.block].memory, 0);
+            transient.view = dev.createImageView(vk::ImageViewCreateInfo(
+                {}, transient.image, vk::ImageViewType::e2D, res.desc.format, vk::ComponentMapping(),
+                vk::ImageSubresourceRange(res.desc.aspect, 0, 1, 0, 1)));
+            VK_DEBUG_NAME(dev, transient.view, res.name.c_str());
+        }
+    }
+
+    // Every stage an occupant of a block touches (this frame or the previous one, which
+    // may still be in flight) must be finished before another occupant takes over
+    for (TransientBlock &block : transientBlocks)
+    {
+        block.stages = vk::PipelineStageFlags2();
+        block.writeAccess = vk::AccessFlags2();
+    }
+    for (const TransientImage &transient : transientImages)
+    {
+        TransientBlock &block = transientBlocks[transient.block];
+        for (const Pass &pass : passes)
+        {
+            if (pass.culled)
+                continue;
+            for (const auto *uses : {&pass.reads, &pass.writes})
+            {
+                for (const Use &use : *uses)
+                {
+                    if (use.resource != transient.resource)
+                        continue;
+                    block.stages |= use.access.stages;
+                    block.writeAccess |= use.access.access & kWriteAccess;
+                }
+            }
+        }
+    }
+
+    for (const TransientImage &transient : transientImages)
+    {
+        Resource &res = resources[transient.resource];
+        const TransientBlock &block = transientBlocks[transient.block];
+        res.image = transient.image;
+        res.view = transient.view;
+        res.layout = vk::ImageLayout::eUndefined;
+        res.writeStages = block.stages;
+        res.writeAccess = block.writeAccess;
+    }
+}
+
+void VulkanRenderGraph::destroyTransients()
+{
+    if (transientImages.empty() && transientBlocks.empty())
+        return;
+
+    auto dev = deviceRef.getLogicalDevice();
+
+    // Rare (new transient set or lifetimes): previous frames may still use the old images
+    dev.waitIdle();
+
+    for (TransientImage &transient : transientImages)
+    {
+        dev.destroyImageView(transient.view);
+        dev.destroyImage(transient.image);
+    }
+    for (TransientBlock &block : transientBlocks)
+        deviceRef.freeMemory(block.memory);
+
+    transientImages.clear();
+    transientBlocks.clear();
+    transientSignature.clear();
+    transientRequested = 0;
+    transientAllocated = 0;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Recording
+
+void VulkanRenderGraph::recordBarriers(vk::CommandBuffer cmd, Pass &pass)
+{
+    // One combined access per resource (e.g. a buffer read as indirect commands and as storage)
+    std::map<Handle, RGAccess> uses;
+    for (const auto *list : {&pass.reads, &pass.writes})
+    {
+        for (const Use &use : *list)
+        {
+            auto it = uses.find(use.resource);
+            if (it == uses.end())
+            {
+                uses.emplace(use.resource, use.access);
+                continue;
+            }
+            if (resources[use.resource].isImage && it->second.layout != use.access.layout)
+            {
+                throw std::runtime_error("render graph pass '" + pass.name + "' uses '" +
+                                         resources[use.resource].name + "' in two layouts!");
+            }
+            it->second.stages |= use.access.stages;
+            it->second.access |= use.access.access;
+        }
+    }
+
+    // Hazards without a layout change share one global memory barrier
+    vk::MemoryBarrier2 global;
+    std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+    pass.barrierCount = 0;
+
+    for (const auto &entry : uses)
+    {
+        Resource &res = resources[entry.first];
+        const RGAccess &access = entry.second;
+
+        const bool layoutChange = res.isImage && access.layout != res.layout;
+        const bool writes = access.writes();
+
+        vk::PipelineStageFlags2 srcStages;
+        vk::AccessFlags2 srcAccess;
+        bool hazard = false;
+        if (layoutChange || writes)
+        {
+            // Wait for everything since the last write; write-after-read only needs execution order
+            srcStages = res.writeStages | res.readStages;
+            srcAccess = res.writeAccess;
+            hazard = layoutChange || srcStages;
+        }
+        else if (res.writeStages)
+        {
+            // Read-after-read needs nothing; read-after-write only if not yet visible to these stages
+            bool visible = !(access.stages & ~res.readStages) && !(access.access & ~res.readAccess);
+            srcStages = res.writeStages;
+            srcAccess = res.writeAccess;
+            hazard = !visible;
+        }
+
+        if (hazard)
+        {
+            ++pass.barrierCount;
+            if (layoutChange)
+            {
+                imageBarriers.push_back(vk::ImageMemoryBarrier2(
+                    srcStages, srcAccess, access.stages, access.access, res.layout, access.layout,
+                    VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, res.image,
+                    vk::ImageSubresourceRange(res.desc.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS)));
+            }
+            else
+            {
+                global.srcStageMask |= srcStages;
+                global.srcAccessMask |= srcAccess;
+                global.dstStageMask |= access.stages;
+                global.dstAccessMask |= access.access;
+            }
+        }
+
+        if (writes)
+        {
+            res.writeStages = access.stages;
+            res.writeAccess = access.access & kWriteAccess;
+            res.readStages = vk::PipelineStageFlags2();
+            res.readAccess = vk::AccessFlags2();
+        }
+        else if (layoutChange)
+        {
+            // The transition is a write the barrier already made visible to this access
+            res.writeStages = access.stages;
+            res.writeAccess = vk::AccessFlags2();
+            res.readStages = access.stages;
+            res.readAccess = access.access;
+        }
+        else
+        {
+            res.readStages |= access.stages;
+            res.readAccess |= access.access;
+        }
+        if (res.isImage)
+            res.layout = access.layout;
+    }
+
+    totalBarriers += pass.barrierCount;
+    if (pass.barrierCount == 0)
+        return;
+
+    vk::DependencyInfo dependency;
+    if (global.srcStageMask || global.dstStageMask)
+    {
+        dependency.memoryBarrierCount = 1;
+        dependency.pMemoryBarriers = &global;
+    }
+    dependency.imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size());
+    dependency.pImageMemoryBarriers = imageBarriers.data();
+    cmd.pipelineBarrier2(dependency);
+}
+
+void VulkanRenderGraph::beginRendering(vk::CommandBuffer cmd, uint32_t passIndex)
+{
+    const Pass &pass = passes[passIndex];
+
+    // Layouts never change inside the pass: the graph's barriers already put every
+    // attachment in its attachment layout. Contents are kept only for a later pass or
+    // the graph's caller.
+    auto storeOp = [&](Handle image)
+    {
+        return resources[image].exported || isReadLater(image, passIndex) ? vk::AttachmentStoreOp::eStore
+                                                                          : vk::AttachmentStoreOp::eDontCare;
+    };
+
+    std::vector<vk::RenderingAttachmentInfo> colorInfos;
+    for (size_t i = 0; i < pass.colors.size(); ++i)
+    {
+        const Attachment &a = pass.colors[i];
+        vk::RenderingAttachmentInfo info(resources[a.image].view, vk::ImageLayout::eColorAttachmentOptimal);
+        info.loadOp = a.loadOp;
+        info.storeOp = storeOp(a.image);
+        info.clearValue = a.clear;
+
+        // Resolved at the end of the pass, so the multisampled image never needs storing
+        if (i < pass.resolves.size())
+        {
+            info.resolveMode = vk::ResolveModeFlagBits::eAverage;
+            info.resolveImageView = resources[pass.resolves[i].image].view;
+            info.resolveImageLayout = vk::ImageLayout::eColorAttachmentOptimal;
+        }
+        colorInfos.push_back(info);
+    }
+
+    vk::RenderingAttachmentInfo depthInfo;
+    if (pass.hasDepth)
+    {
+        const Attachment &a = pass.depthAttachment;
+        depthInfo = vk::RenderingAttachmentInfo(resources[a.image].view, vk::ImageLayout::eDepthStencilAttachmentOptimal);
+        depthInfo.loadOp = a.loadOp;
+        depthInfo.storeOp = storeOp(a.image);
+        depthInfo.clearValue = a.clear;
+    }
+
+    const Handle first = pass.colors.empty() ? pass.depthAttachment.image : pass.colors.front().image;
+    vk::RenderingFlags flags;
+    if (pass.secondaryContents)
+        flags |= vk::RenderingFlagBits::eContentsSecondaryCommandBuffers;
+    vk::RenderingInfo renderingInfo(flags, vk::Rect2D(vk::Offset2D(0, 0), resources[first].desc.extent), 1, 0,
+                                    static_cast<uint32_t>(colorInfos.size()), colorInfos.data(),
+                                    pass.hasDepth ? &depthInfo : nullptr, nullptr);
+    cmd.beginRendering(renderingInfo);
+}
+
+void VulkanRenderGraph::recordPass(vk::CommandBuffer cmd, uint32_t passIndex, uint32_t frameIndex)
+{
+    Pass &pass = passes[passIndex];
+    VK_DEBUG_LABEL_SCOPE(cmd, pass.name.c_str());
+    recordBarriers(cmd, pass);
+
+    auto &timed = timedPasses[frameIndex];
+    const bool timing = timestampPool && timed.size() < kMaxTimedPasses;
+    const uint32_t query = (frameIndex * kMaxTimedPasses + static_cast<uint32_t>(timed.size())) * 2;
+    if (timing)
+    {
+        cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eTopOfPipe, timestampPool, query);
+        timed.push_back(pass.name);
+    }
+
+    const bool raster = !pass.colors.empty() || pass.hasDepth;
+    if (raster)
+        beginRendering(cmd, passIndex);
+
+    if (pass.execute)
+        pass.execute(PassContext{cmd, *this});
+
+    if (raster)
+        cmd.endRendering();
+
+    if (timing)
+        cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eBottomOfPipe, timestampPool, query + 1);
+}
+
+void VulkanRenderGraph::execute(vk::CommandBuffer cmd, uint32_t frameIndex)
+{
+    cullPasses();
+    allocateTransients();
+
+    totalBarriers = 0;
+    timedPasses[frameIndex].clear();
+    if (timestampPool)
+        cmd.resetQueryPool(timestampPool, frameIndex * kMaxTimedPasses * 2, kMaxTimedPasses * 2);
+
+    for (uint32_t i = 0; i < passes.size(); ++i)
+    {
+        if (!passes[i].culled)
+            recordPass(cmd, i, frameIndex);
+    }
+
+    // Hand exported images over in the layout the caller asked for
+    std::vector<vk::ImageMemoryBarrier2> finalBarriers;
+    for (Resource &res : resources)
+    {
+        if (!res.exported || res.layout == res.finalLayout)
+            continue;
+
+        finalBarriers.push_back(vk::ImageMemoryBarrier2(
+            res.writeStages | res.readStages, res.writeAccess, vk::PipelineStageFlagBits2::eNone,
+            vk::AccessFlagBits2::eNone, res.layout, res.finalLayout, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+            res.image,
+            vk::ImageSubresourceRange(res.desc.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS)));
+        res.layout = res.finalLayout;
+    }
+    if (!finalBarriers.empty())
+    {
+        vk::DependencyInfo dependency;
+        dependency.imageMemoryBarrierCount = static_cast<uint32_t>(finalBarriers.size());
+        dependency.pImageMemoryBarriers = finalBarriers.data();
+        cmd.pipelineBarrier2(dependency);
+        totalBarriers += static_cast<uint32_t>(finalBarriers.size());
+    }
+}
+
+void VulkanRenderGraph::collectTimings(uint32_t frameIndex)
+{
+    const auto &timed = timedPasses[frameIndex];
+    if (!timestampPool || timed.empty())
+        return;
+
+    // Called after the frame's fence wait, so the results are ready; don't block if not
+    std::vector<uint64_t> stamps(timed.size() * 2);
+    vk::Result result = deviceRef.getLogicalDevice().getQueryPoolResults(
+        timestampPool, frameIndex * kMaxTimedPasses * 2, static_cast<uint32_t>(stamps.size()),
+        stamps.size() * sizeof(uint64_t), stamps.data(), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+    if (result != vk::Result::eSuccess)
+        return;
+
+    for (size_t i = 0; i < timed.size(); ++i)
+    {
+        double ms = static_cast<double>(stamps[i * 2 + 1] - stamps[i * 2]) * timestampPeriodNs * 1e-6;
+        PassTiming &timing = timings[timed[i]];
+        timing.lastMs = ms;
+        timing.totalMs += ms;
+        ++timing.samples;
+    }
+}
+
+// ---------------------------------------------------------------------------------------------
+// Dumps
+
+void VulkanRenderGraph::dump(std::ostream &out) const
+{
+    size_t culled = std::count_if(passes.begin(), passes.end(), [](const Pass &p) { return p.culled; });
+
+    out << "Render graph: " << passes.size() << " passes (" << culled << " culled), "
+        << totalBarriers << " barriers per frame" << std::endl;
+    out << std::fixed << std::setprecision(2)
+        << "  transient memory: " << transientAllocated / (1024.0 * 1024.0) << " MB ("
+        << transientRequested / (1024.0 * 1024.0) << " MB without aliasing)" << std::endl;
+
+    auto names = [&](const std::vector<Use> &uses)
+    {
+        std::string result;
+        std::vector<Handle> listed;
+        for (const Use &use : uses)
+        {
+            if (std::find(listed.begin(), listed.end(), use.resource) != listed.end())
+                continue;
+            listed.push_back(use.resource);
+            result += (result.empty() ? "" : ", ") + resources[use.resource].name;
+        }
+        return result.empty() ? std::string("-") : result;
+    };
+
+    for (const Pass &pass : passes)
+    {
+        out << "  " << std::left << std::setw(16) << pass.name << std::right;
+        if (pass.culled)
+        {
+            out << "  culled" << std::endl;
+            continue;
+        }
+
+        auto it = timings.find(pass.name);
+        if (it != timings.end() && it->second.samples > 0)
+            out << std::setprecision(3) << std::setw(8) << it->second.totalMs / it->second.samples << " ms";
+        else
+            out << "       - ms";
+        out << std::setw(4) << pass.barrierCount << " barriers  " << names(pass.reads) << " -> "
+            << names(pass.writes) << std::endl;
+    }
+}
+
+void VulkanRenderGraph::dumpGraphviz(std::ostream &out) const
+{
+    out << "digraph RenderGraph {" << std::endl;
+    out << "  rankdir=LR;" << std::endl;
+    out << "  node [fontname=\"Helvetica\", fontsize=10];" << std::endl;
+
+    for (Handle h = 0; h < resources.size(); ++h)
+    {
+        const Resource &res = resources[h];
+        out << "  r" << h << " [shape=ellipse, label=\"" << res.name << "\"";
+        if (!res.imported)
+            out << ", style=dashed";
+        out << "];" << std::endl;
+    }
+
+    out << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < passes.size(); ++i)
+    {
+        const Pass &pass = passes[i];
+        out << "  p" << i << " [shape=box, label=\"" << pass.name;
+        if (pass.culled)
+        {
+            out << "\\nculled\", color=gray, fontcolor=gray];" << std::endl;
+        }
+        else
+        {
+            auto it = timings.find(pass.name);
+            if (it != timings.end() && it->second.samples > 0)
+                out << "\\n" << it->second.totalMs / it->second.samples << " ms";
+            out << "\\n" << pass.barrierCount << " barriers\"];" << std::endl;
+        }
+
+        for (const Use &use : pass.reads)
+            out << "  r" << use.resource << " -> p" << i << ";" << std::endl;
+        for (const Use &use : pass.writes)
+            out << "  p" << i << " -> r" << use.resource << ";" << std::endl;
+    }
+
+    out << "}" << std::endl;
+}
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+class VulkanDevice;
+
+// How a pass touches a resource: the pipeline stages and accesses involved and,
+// for images, the layout the pass needs the image in
+struct RGAccess
+{
+    vk::PipelineStageFlags2 stages;
+    vk::AccessFlags2 access;
+    vk::ImageLayout layout = vk::ImageLayout::eUndefined; // Images only
+
+    bool writes() const;
+
+    static RGAccess sampled(vk::PipelineStageFlags2 stages,
+                            vk::ImageLayout layout = vk::ImageLayout::eShaderReadOnlyOptimal);
+    static RGAccess storageRead(vk::PipelineStageFlags2 stages, vk::ImageLayout layout = vk::ImageLayout::eGeneral);
+    static RGAccess storageWrite(vk::PipelineStageFlags2 stages, vk::ImageLayout layout = vk::ImageLayout::eGeneral);
+    static RGAccess drawInputs();    // Indirect commands plus uniform/storage reads in vertex and fragment shaders
+    static RGAccess transferWrite(); // Copies, fills and clears
+    static RGAccess transferRead();  // Copy and blit sources
+};
+
+struct RGImageDesc
+{
+    vk::Format format = vk::Format::eUndefined;
+    vk::Extent2D extent;
+    vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1;
+    vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eColor;
+};
+
+// Frame graph. Every frame the caller declares resources and passes (in submission
+// order) with the accesses each pass makes; execute() then:
+//
+//  - culls passes whose results nobody uses (nothing exported, no side effects),
+//  - records one vkCmdPipelineBarrier2 per pass with only the barriers and layout
+//    transitions the declared hazards require,
+//  - wraps passes with attachments in vkCmdBeginRendering/vkCmdEndRendering (no render
+//    pass or framebuffer objects), storing attachments only when a later pass or the
+//    caller needs them,
+//  - backs transient images with memory shared between images whose lifetimes
+//    don't overlap,
+//  - brackets every pass with timestamps for dump().
+class VulkanRenderGraph
+{
+public:
+    using Handle = uint32_t;
+
+    struct PassContext
+    {
+        vk::CommandBuffer cmd;
+        const VulkanRenderGraph &graph;
+
+        vk::Image image(Handle handle) const;
+        vk::ImageView view(Handle handle) const;
+        vk::Buffer buffer(Handle handle) const;
+    };
+    using ExecuteFn = std::function<void(const PassContext &)>;
+
+    class PassBuilder
+    {
+    public:
+        // Attachments (the pass then runs inside dynamic rendering). Loading counts as a read.
+        PassBuilder &color(Handle image, vk::AttachmentLoadOp loadOp = vk::AttachmentLoadOp::eClear,
+                           const vk::ClearColorValue &clear = vk::ClearColorValue(std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f}));
+        PassBuilder &depth(Handle image, vk::AttachmentLoadOp loadOp = vk::AttachmentLoadOp::eClear, float clear = 1.0f);
+        PassBuilder &resolve(Handle image); // MSAA resolve target of the matching color attachment
+
+        PassBuilder &read(Handle resource, const RGAccess &access);
+        PassBuilder &write(Handle resource, const RGAccess &access);
+
+        // Keep the pass even if none of its writes are consumed
+        PassBuilder &sideEffects();
+
+        // The pass body only executes secondary command buffers (see VulkanCommandCache)
+        PassBuilder &secondaryCommandBuffers();
+
+    private:
+        friend class VulkanRenderGraph;
+        PassBuilder(VulkanRenderGraph &graph, uint32_t pass) : graph(graph), pass(pass) {}
+
+        VulkanRenderGraph &graph;
+        uint32_t pass;
+    };
+
+    VulkanRenderGraph(const VulkanDevice &device, uint32_t maxFramesInFlight);
+    ~VulkanRenderGraph();
+
+    VulkanRenderGraph(const VulkanRenderGraph &) = delete;
+    VulkanRenderGraph &operator=(const VulkanRenderGraph &) = delete;
+
+    // Start declaring a new frame
+    void reset();
+
+    // External resources. The state describes the last access before this frame's graph
+    // (e.g. the stage a swapchain acquire semaphore is waited on).
+    Handle importImage(const std::string &name, vk::Image image, vk::ImageView view, const RGImageDesc &desc,
+                       vk::ImageLayout layout, vk::PipelineStageFlags2 lastStages = vk::PipelineStageFlagBits2::eNone,
+                       vk::AccessFlags2 lastAccess = vk::AccessFlagBits2::eNone);
+    Handle importBuffer(const std::string &name, vk::Buffer buffer,
+                        vk::PipelineStageFlags2 lastStages = vk::PipelineStageFlagBits2::eNone,
+                        vk::AccessFlags2 lastAccess = vk::AccessFlagBits2::eNone);
+
+    // Graph-owned image, valid only during this frame's passes
+    Handle createImage(const std::string &name, const RGImageDesc &desc);
+
+    // The image leaves the graph in finalLayout (e.g. ePresentSrcKHR); its writers are kept
+    void exportImage(Handle image, vk::ImageLayout finalLayout);
+
+    PassBuilder addPass(const std::string &name, ExecuteFn execute);
+
+    // Compile and record every surviving pass into cmd
+    void execute(vk::CommandBuffer cmd, uint32_t frameIndex);
+
+    // Call once the frame's fence has been waited on: gathers that frame's GPU timings
+    void collectTimings(uint32_t frameIndex);
+
+    // Last compiled frame: passes (culled ones marked), barriers, transient memory, timings
+    void dump(std::ostream &out) const;
+    void dumpGraphviz(std::ostream &out) const;
+
+private:
+    struct Resource
+    {
+        std::string name;
+        bool isImage = false;
+        bool imported = false;
+        bool exported = false;
+        RGImageDesc desc;
+        vk::Image image;
+        vk::ImageView view;
+        vk::Buffer buffer;
+        vk::ImageLayout finalLayout = vk::ImageLayout::eUndefined;
+        vk::ImageUsageFlags usage; // Transient images: union of all declared uses
+
+        // Hazard tracking while recording
+        vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+        vk::PipelineStageFlags2 writeStages;
+        vk::AccessFlags2 writeAccess;
+        vk::PipelineStageFlags2 readStages; // Since the last write
+        vk::AccessFlags2 readAccess;        // Made visible since the last write
+
+        // Transient lifetime in kept-pass order
+        uint32_t firstUse = UINT32_MAX;
+        uint32_t lastUse = 0;
+    };
+
+    struct Use
+    {
+        Handle resource;
+        RGAccess access;
+    };
+
+    struct Attachment
+    {
+        Handle image;
+        vk::AttachmentLoadOp loadOp;
+        vk::ClearValue clear;
+    };
+
+    struct Pass
+    {
+        std::string name;
+        ExecuteFn execute;
+        std::vector<Use> reads;
+        std::vector<Use> writes;
+        std::vector<Attachment> colors;
+        std::vector<Attachment> resolves;
+        bool hasDepth = false;
+        Attachment depthAttachment;
+        bool sideEffects = false;
+        bool secondaryContents = false;
+
+        // Compile results
+        bool culled = false;
+        uint32_t barrierCount = 0;
+    };
+
+    struct TransientBlock
+    {
+        vk::DeviceSize size = 0;
+        uint32_t memoryTypeBits = ~0u;
+        std::vector<std::pair<uint32_t, uint32_t>> lifetimes;
+        vk::DeviceMemory memory;
+        vk::PipelineStageFlags2 stages; // Every stage any occupant uses
+        vk::AccessFlags2 writeAccess;
+    };
+
+    struct TransientImage
+    {
+        Handle resource;
+        vk::Image image;
+        vk::ImageView view;
+        uint32_t block = 0;
+    };
+
+    struct PassTiming
+    {
+        double lastMs = 0.0;
+        double totalMs = 0.0;
+        uint64_t samples = 0;
+    };
+
+    void cullPasses();
+    void allocateTransients();
+    void destroyTransients();
+    void recordBarriers(vk::CommandBuffer cmd, Pass &pass);
+    void recordPass(vk::CommandBuffer cmd, uint32_t passIndex, uint32_t frameIndex);
+    void beginRendering(vk::CommandBuffer cmd, uint32_t passIndex);
+    bool isReadLater(Handle resource, uint32_t afterPass) const;
+
+    const VulkanDevice &deviceRef;
+
+    std::vector<Resource> resources;
+    std::vector<Pass> passes;
+
+    // Transient images and memory, kept while the set of images and their lifetimes is unchanged
+    std::vector<TransientImage> transientImages;
+    std::vector<TransientBlock> transientBlocks;
+    std::string transientSignature;
+    vk::DeviceSize transientRequested = 0; // Without aliasing
+    vk::DeviceSize transientAllocated = 0;
+
+    // Timestamps: two per pass per frame in flight
+    static constexpr uint32_t kMaxTimedPasses = 32;
+    vk::QueryPool timestampPool;
+    double timestampPeriodNs = 1.0;
+    std::vector<std::vector<std::string>> timedPasses; // Per frame in flight
+    std::map<std::string, PassTiming> timings;
+    uint32_t totalBarriers = 0;
+};
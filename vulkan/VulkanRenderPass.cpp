@@ -1,72 +0,0 @@
-#include "VulkanRenderPass.h"
-#include "VulkanDevice.h"
-#include "VulkanSwapchain.h"
-
-#include <vector>
-
-VulkanRenderPass::VulkanRenderPass(const VulkanDevice &device, const VulkanSwapchain &swapchain)
-    : deviceRef(device), swapchainRef(swapchain)
-{
-    vk::AttachmentDescription colorAttachment;
-    colorAttachment.format = swapchainRef.getImageFormat();
-    colorAttachment.samples = vk::SampleCountFlagBits::e1;
-    colorAttachment.loadOp = vk::AttachmentLoadOp::eClear;
-    colorAttachment.storeOp = vk::AttachmentStoreOp::eStore;
-    colorAttachment.stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
-    colorAttachment.stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
-    colorAttachment.initialLayout = vk::ImageLayout::eUndefined;
-    colorAttachment.finalLayout = vk::ImageLayout::ePresentSrcKHR;
-
-    vk::AttachmentReference colorAttachmentRef(0, vk::ImageLayout::eColorAttachmentOptimal);
-
-    vk::SubpassDescription subpass;
-    subpass.pipelineBindPoint = vk::PipelineBindPoint::eGraphics;
-    subpass.colorAttachmentCount = 1;
-    subpass.pColorAttachments = &colorAttachmentRef;
-
-    vk::SubpassDependency dependency;
-    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-    dependency.dstSubpass = 0;
-    dependency.srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
-    dependency.dstStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
-    dependency.srcAccessMask = {};
-    dependency.dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
-
-    // Depth attachment
-    vk::Format depthFormat = vk::Format::eD32Sfloat;
-    vk::AttachmentDescription depthAttachment;
-    depthAttachment.format = depthFormat;
-    depthAttachment.samples = vk::SampleCountFlagBits::e1;
-    depthAttachment.loadOp = vk::AttachmentLoadOp::eClear;
-    depthAttachment.storeOp = vk::AttachmentStoreOp::eDontCare;
-    depthAttachment.stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
-    depthAttachment.stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
-    depthAttachment.initialLayout = vk::ImageLayout::eUndefined;
-    depthAttachment.finalLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
-
-    vk::AttachmentReference depthAttachmentRef(1, vk::ImageLayout::eDepthStencilAttachmentOptimal);
-
-    // Two attachments: color (0) and depth (1)
-    std::array<vk::AttachmentDescription, 2> attachments = {colorAttachment, depthAttachment};
-
-    vk::RenderPassCreateInfo renderPassInfo;
-    renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-    renderPassInfo.pAttachments = attachments.data();
-    renderPassInfo.subpassCount = 1;
-    renderPassInfo.pSubpasses = &subpass;
-    renderPassInfo.dependencyCount = 1;
-    renderPassInfo.pDependencies = &dependency;
-
-    // attach depth reference to subpass
-    subpass.pDepthStencilAttachment = &depthAttachmentRef;
-
-    renderPass = deviceRef.getLogicalDevice().createRenderPass(renderPassInfo);
-}
-
-VulkanRenderPass::~VulkanRenderPass()
-{
-    if (renderPass)
-    {
-        deviceRef.getLogicalDevice().destroyRenderPass(renderPass);
-    }
-}
\ No newline at end of file
@@ -3,16 +3,95 @@
 
 #include "VulkanRenderer.h"
 #include "VulkanShader.h"
+#include "VulkanGraphicsPipeline.h"
 #include "src/Mesh.h"
 #include "src/Primitive.h"
 #include "src/GameObject.h"
 #include "src/Material.h"
+#include "src/MeshSimplifier.h"
+#include "src/SceneFile.h"
+#include "VulkanRenderGraph.h"
+#include "VulkanCommandCache.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <fstream>
+#include <cmath>
 #include <cstdlib>
+#include <filesystem>
+#include <future>
+#include <stdexcept>
 #include <string>
+#include <thread>
 
-VulkanRenderer::VulkanRenderer(GLFWwindow *window) : window(window)
+namespace
+{
+    // Frame ring sizing: a fixed part plus DrawData, CullData and two indirect commands per object
+    constexpr vk::DeviceSize kBaseRingBytes = 8 * 1024 * 1024;
+    constexpr vk::DeviceSize kRingBytesPerObject = 160;
+
+    constexpr uint32_t kObjectsPerGeneratedCell = 200;
+
+    // Draws from the occlusion culler's compacted commands carry their draw index in
+    // firstInstance, which only the instanced permutation reads
+    PipelineDesc scenePipelineDesc(const RenderSettings &settings)
+    {
+        return settings.occlusionCulling ? PipelineDescs::kVertexColor.with(ShaderFeatureInstancing)
+                                         : PipelineDescs::kVertexColor;
+    }
+
+    // Distinct streamed colors given their own material (of the bindless table's 4096).
+    // Materials are never released, so colors beyond this draw with the base material.
+    constexpr size_t kMaxStreamedMaterials = 1024;
+
+    // Three spinning cubes and a triangle, used without VULKAN_CUBE_SCENE
+    SceneDescription defaultScene()
+    {
+        SceneDescription scene;
+        scene.meshes.push_back({SceneMeshType::Cube, {0, 0}, true});
+        scene.meshes.push_back({SceneMeshType::Triangle, {0, 0}, false});
+        scene.materials.push_back(SceneMaterial());
+
+        auto add = [&scene](uint32_t mesh, glm::vec3 position, glm::vec3 rotation, float scale, glm::vec3 spin)
+        {
+            SceneInstance instance;
+            instance.mesh = mesh;
+            instance.transform.position = position;
+            instance.transform.rotation = rotation;
+            instance.transform.scale = glm::vec3(scale);
+            instance.angularVelocity = spin;
+            scene.instances.push_back(instance);
+        };
+        add(0, glm::vec3(0.0f), glm::vec3(-25.0f, 45.0f, 0.0f), 1.0f, glm::vec3(0.0f, 45.0f, 0.0f));
+        add(0, glm::vec3(2.0f, 0.0f, 0.0f), glm::vec3(0.0f), 0.5f, glm::vec3(90.0f, 0.0f, 0.0f));
+        add(0, glm::vec3(-2.0f, 0.0f, 0.0f), glm::vec3(0.0f, 90.0f, 0.0f), 0.75f, glm::vec3(0.0f, -30.0f, 0.0f));
+        add(1, glm::vec3(0.0f, 1.5f, 0.0f), glm::vec3(0.0f), 1.5f, glm::vec3(0.0f));
+        return scene;
+    }
+
+    // The full-frame main view plus insets down the right edge showing the origin from
+    // above, the side and behind
+    std::vector<FrameView> insetViews(uint32_t count)
+    {
+        const glm::vec3 insetEyes[] = {glm::vec3(0.0f, 10.0f, 1.0f), glm::vec3(7.0f, 1.0f, 0.0f),
+                                       glm::vec3(-4.0f, 3.0f, -4.0f)};
+
+        std::vector<FrameView> views(1);
+        for (uint32_t i = 1; i < count; ++i)
+        {
+            FrameView inset;
+            inset.eye = insetEyes[(i - 1) % 3];
+            inset.rect = glm::vec4(0.72f, 0.02f + 0.32f * static_cast<float>(i - 1), 0.26f, 0.3f);
+            views.push_back(inset);
+        }
+        return views;
+    }
+}
+
+VulkanRenderer::VulkanRenderer(GLFWwindow *window)
+    : window(window), settings(RenderSettings::fromEnvironment())
 {
     initVulkan();
 }
@@ -27,83 +106,553 @@ void VulkanRenderer::run()
     mainLoop();
 }
 
+// Scene content built on worker threads during startup. The first frames are drawn without
+// it; revealScene() adds the objects once their pipeline is compiled and meshes uploaded.
+struct VulkanRenderer::PendingScene
+{
+    SceneDescription description;
+    std::vector<uint32_t> materialIds; // Registered up front, one per scene material
+    std::future<std::unique_ptr<Material>> pipeline; // The first material; the others are instances of it
+    std::vector<std::unique_ptr<Mesh>> meshes;        // Slot per scene mesh, filled by the workers
+    std::atomic<size_t> nextMesh{0};
+    std::vector<std::future<void>> meshWorkers;
+    bool built = false;       // Objects created; waiting for the uploads
+    size_t firstObject = 0;   // Of the scene's objects in gameObjects
+    uint64_t uploadTicket = 0;
+};
+
 void VulkanRenderer::initVulkan()
 {
-    vulkanInstance = std::make_unique<VulkanInstance>(true);
-    vulkanSurface = std::make_unique<VulkanSurface>(*vulkanInstance, window);
-    vulkanDevice = std::make_unique<VulkanDevice>(vulkanInstance->get(), vulkanSurface->get());
-    vulkanSwapchain = std::make_unique<VulkanSwapchain>(*vulkanDevice, vulkanSurface->get(), window);
-    vulkanRenderPass = std::make_unique<VulkanRenderPass>(*vulkanDevice, *vulkanSwapchain);
-    vulkanSwapchain->createFramebuffers(vulkanRenderPass->get());
-
-    vulkanCommand = std::make_unique<VulkanCommand>(*vulkanDevice, MAX_FRAMES_IN_FLIGHT);
-    vulkanSync = std::make_unique<VulkanSync>(
-        *vulkanDevice,
-        vulkanSwapchain->getFramebuffers().size(),
-        MAX_FRAMES_IN_FLIGHT);
-
-    vulkanFrame = std::make_unique<VulkanFrame>(
-        *vulkanDevice,
-        *vulkanSwapchain,
-        *vulkanRenderPass,
-        *vulkanCommand,
-        *vulkanSync,
-        MAX_FRAMES_IN_FLIGHT);
-
-    // Create materials
-    auto cubeShader = std::make_unique<VulkanShader>(*vulkanDevice,
-                                                     "shaders/cube.vert.spv", "shaders/cube.frag.spv");
-    materials.push_back(std::make_unique<Material>(*vulkanDevice, *vulkanRenderPass,
-                                                   std::move(cubeShader)));
-    Material *defaultMaterial = materials[0].get();
-
-    // Create meshes (shared resources)
-    auto cubeVerts = Primitives::createCube();
-    meshes.push_back(std::make_unique<Mesh>(*vulkanDevice, cubeVerts));
-    Mesh *cubeMesh = meshes[0].get();
-
-    auto triangleVerts = Primitives::createTriangle();
-    meshes.push_back(std::make_unique<Mesh>(*vulkanDevice, triangleVerts));
-    Mesh *triangleMesh = meshes[1].get();
-
-    // Create game objects - now each has position + material
-    // Cube 1 - center with rotation
-    Transform t1;
-    t1.position = glm::vec3(0.0f, 0.0f, 0.0f);
-    t1.rotation = glm::vec3(-25.0f, 45.0f, 0.0f);
-    t1.scale = glm::vec3(1.0f);
-    gameObjects.push_back(std::make_unique<GameObject>(cubeMesh, defaultMaterial, t1));
-
-    // Cube 2 - to the right
-    Transform t2;
-    t2.position = glm::vec3(2.0f, 0.0f, 0.0f);
-    t2.rotation = glm::vec3(0.0f, 0.0f, 0.0f);
-    t2.scale = glm::vec3(0.5f);
-    gameObjects.push_back(std::make_unique<GameObject>(cubeMesh, defaultMaterial, t2));
-
-    // Cube 3 - to the left
-    Transform t3;
-    t3.position = glm::vec3(-2.0f, 0.0f, 0.0f);
-    t3.rotation = glm::vec3(0.0f, 90.0f, 0.0f);
-    t3.scale = glm::vec3(0.75f);
-    gameObjects.push_back(std::make_unique<GameObject>(cubeMesh, defaultMaterial, t3));
-
-    // Triangle - above center
-    Transform t4;
-    t4.position = glm::vec3(0.0f, 1.5f, 0.0f);
-    t4.rotation = glm::vec3(0.0f, 0.0f, 0.0f);
-    t4.scale = glm::vec3(1.5f);
-    gameObjects.push_back(std::make_unique<GameObject>(triangleMesh, defaultMaterial, t4));
-
-    // Register all game objects with the frame renderer
-    for (auto &obj : gameObjects)
-    {
-        vulkanFrame->addGameObject(obj.get());
+    VulkanShader::setOverrideDirectory(settings.shaderDir);
+
+    // Parsing or generating the scene is CPU work that needs no device
+    std::future<SceneDescription> sceneLoad = std::async(std::launch::async, [this]()
+                                                         {
+                                                             auto phase = startupTimeline.phase("scene load");
+                                                             return settings.scenePath.empty()
+                                                                        ? defaultScene()
+                                                                        : SceneFile::load(settings.scenePath);
+                                                         });
+
+    {
+        auto phase = startupTimeline.phase("instance");
+        vulkanInstance = std::make_unique<VulkanInstance>(settings.validation, false, settings.debugLabels);
+    }
+    {
+        auto phase = startupTimeline.phase("surface and device");
+        vulkanSurface = std::make_unique<VulkanSurface>(*vulkanInstance, window);
+        vulkanDevice = std::make_unique<VulkanDevice>(vulkanInstance->get(), vulkanSurface->get(), settings.device);
+    }
+    vulkanDevice->getMemoryTracker().addPressureCallback(
+        [](uint32_t heap, const MemoryHeapStatus &status)
+        {
+            std::cerr << "GPU memory heap " << heap << " is at " << static_cast<int>(status.pressure() * 100.0)
+                      << "% of its budget" << std::endl;
+        });
+
+    // The depth pyramid needs single-sampled depth that outlives the pass
+    if (settings.occlusionCulling && settings.msaaSamples > 1)
+    {
+        std::cerr << "MSAA is not supported with occlusion culling; rendering with 1 sample" << std::endl;
+        settings.msaaSamples = 1;
+    }
+    if (settings.occlusionCulling && !VulkanOcclusionCuller::isSupported(*vulkanDevice))
+    {
+        std::cerr << "Occlusion culling needs drawIndirectCount and drawIndirectFirstInstance; disabled" << std::endl;
+        settings.occlusionCulling = false;
+    }
+    if (settings.occlusionCulling && settings.views > 1)
+    {
+        std::cerr << "Extra views are not supported with occlusion culling; drawing the main view only" << std::endl;
+        settings.views = 1;
+    }
+    {
+        auto phase = startupTimeline.phase("swapchain");
+        vk::SampleCountFlagBits samples = vulkanDevice->clampSampleCount(settings.msaaSamples);
+        vulkanSwapchain = std::make_unique<VulkanSwapchain>(*vulkanDevice, vulkanSurface->get(), window,
+                                                            samples, settings.occlusionCulling);
+    }
+
+    // Every object writes its draw (and culling) data into the ring each frame
+    SceneDescription scene = sceneLoad.get();
+    {
+        auto phase = startupTimeline.phase("frame ring and bindless tables");
+        vk::DeviceSize ringBytes = kBaseRingBytes + kRingBytesPerObject * scene.instances.size();
+        if (!settings.streamSource.empty())
+            ringBytes += kRingBytesPerObject * StreamingSettings().maxObjects;
+        vulkanFrameRing = std::make_unique<VulkanFrameRing>(*vulkanDevice, MAX_FRAMES_IN_FLIGHT, ringBytes);
+        vulkanBindless = std::make_unique<VulkanBindless>(*vulkanDevice);
+        vulkanUploader = std::make_unique<VulkanUploader>(*vulkanDevice);
+    }
+
+    // Default 1x1 white texture occupies bindless slot 0
+    const uint32_t whitePixel = 0xFFFFFFFFu;
+    textures.push_back(std::make_unique<VulkanTexture>(*vulkanDevice, 1, 1, &whitePixel));
+    MaterialParams defaultParams;
+    defaultParams.textureIndex = vulkanBindless->registerTexture(textures[0]->getView());
+
+    // Pipelines only depend on the attachment formats, not on swapchain images
+    RenderTargetFormats targets;
+    targets.color = vulkanSwapchain->getImageFormat();
+    targets.depth = vulkanSwapchain->getDepthFormat();
+    targets.samples = vulkanSwapchain->getSampleCount();
+    std::vector<vk::DescriptorSetLayout> setLayouts = {vulkanFrameRing->getSetLayout(),
+                                                       vulkanBindless->getSetLayout()};
+
+    // From here the scene's pipeline and meshes build in the background
+    buildScene(std::move(scene), targets, setLayouts, defaultParams);
+
+    {
+        auto phase = startupTimeline.phase("frame resources");
+        vulkanCommand = std::make_unique<VulkanCommand>(*vulkanDevice, MAX_FRAMES_IN_FLIGHT);
+        vulkanSync = std::make_unique<VulkanSync>(
+            *vulkanDevice,
+            vulkanSwapchain->getImageViews().size(),
+            MAX_FRAMES_IN_FLIGHT);
+
+        vulkanFrame = std::make_unique<VulkanFrame>(
+            *vulkanDevice,
+            *vulkanSwapchain,
+            *vulkanCommand,
+            *vulkanSync,
+            *vulkanFrameRing,
+            *vulkanBindless,
+            MAX_FRAMES_IN_FLIGHT,
+            settings);
+
+        if (settings.views > 1)
+            vulkanFrame->setViews(insetViews(std::min(settings.views, VulkanFrame::kMaxViews)));
+    }
+
+    if (settings.occlusionCulling)
+    {
+        auto phase = startupTimeline.phase("occlusion culler");
+        vulkanOcclusionCuller = std::make_unique<VulkanOcclusionCuller>(
+            *vulkanDevice, *vulkanSwapchain, *vulkanFrameRing, MAX_FRAMES_IN_FLIGHT);
+        vulkanFrame->setOcclusionCulling(vulkanOcclusionCuller.get());
+    }
+
+    if (!settings.captureDir.empty())
+    {
+        if (!vulkanSwapchain->supportsTransferSource() ||
+            !VulkanFrameCapture::supportsFormat(vulkanSwapchain->getImageFormat()))
+        {
+            std::cerr << "Frame capture needs an 8-bit RGBA/BGRA swapchain usable as a transfer source; disabled"
+                      << std::endl;
+        }
+        else
+        {
+            std::error_code error;
+            std::filesystem::create_directories(settings.captureDir, error);
+            vulkanFrameCapture = std::make_unique<VulkanFrameCapture>(*vulkanDevice, MAX_FRAMES_IN_FLIGHT,
+                                                                      settings.captureInterval);
+            vulkanFrameCapture->setOutputDirectory(settings.captureDir, settings.captureRaw ? CaptureFileFormat::Raw
+                                                                                            : CaptureFileFormat::Png);
+            vulkanFrame->setCapture(vulkanFrameCapture.get());
+        }
+    }
+
+    if (settings.animatedInstances > 0)
+    {
+        auto phase = startupTimeline.phase("animated instances");
+        meshes.push_back(std::make_unique<Mesh>(*vulkanDevice, Primitives::createCube()));
+        createAnimatedInstances(targets, setLayouts, defaultParams, meshes.back().get());
+    }
+    if (settings.particles > 0)
+    {
+        auto phase = startupTimeline.phase("particles");
+        createParticles(targets);
+    }
+    if (!settings.streamSource.empty())
+    {
+        auto phase = startupTimeline.phase("streaming");
+        createStreaming(targets, setLayouts, defaultParams);
+    }
+    if (settings.hud)
+    {
+        // Drawn after the MSAA resolve, straight into the swapchain image
+        auto phase = startupTimeline.phase("hud");
+        RenderTargetFormats overlayTargets;
+        overlayTargets.color = targets.color;
+        vulkanHud = std::make_unique<VulkanHud>(*vulkanDevice, *vulkanFrameRing, *vulkanBindless, overlayTargets);
+        vulkanFrame->setHud(vulkanHud.get());
+    }
+}
+
+void VulkanRenderer::buildScene(SceneDescription scene, const RenderTargetFormats &targets,
+                                const std::vector<vk::DescriptorSetLayout> &setLayouts,
+                                const MaterialParams &defaultParams)
+{
+    pendingScene = std::make_unique<PendingScene>();
+    PendingScene &pending = *pendingScene;
+    pending.description = std::move(scene);
+    const SceneDescription &description = pending.description;
+
+    // Scene materials only differ by color, so they all share the untextured pipeline.
+    // Bindless registration stays on this thread; only the compilation moves off it.
+    for (const SceneMaterial &sceneMaterial : description.materials)
+    {
+        MaterialParams params = defaultParams;
+        params.baseColor = sceneMaterial.baseColor;
+        pending.materialIds.push_back(vulkanBindless->registerMaterial(params));
+    }
+    if (!pending.materialIds.empty())
+    {
+        const uint32_t materialId = pending.materialIds[0];
+        pending.pipeline = std::async(std::launch::async, [this, targets, setLayouts, materialId]()
+                                      {
+                                          auto phase = startupTimeline.phase("scene pipeline");
+                                          auto shader = std::make_unique<VulkanShader>(
+                                              *vulkanDevice, "shaders/cube.vert.spv", "shaders/cube.frag.spv");
+                                          return std::make_unique<Material>(*vulkanDevice, targets,
+                                                                            scenePipelineDesc(settings),
+                                                                            std::move(shader), setLayouts, materialId);
+                                      });
+    }
+
+    // Meshes (including their LOD chains) are built by a few workers pulling from a shared
+    // index and staged through the uploader, which the render loop submits every frame
+    pending.meshes.resize(description.meshes.size());
+    const size_t workerCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 2u) - 1,
+                                                description.meshes.size());
+    for (size_t w = 0; w < workerCount; ++w)
+    {
+        pending.meshWorkers.push_back(std::async(std::launch::async, [this, &pending]()
+                                                 {
+                                                     auto phase = startupTimeline.phase("scene meshes");
+                                                     for (size_t i = pending.nextMesh++; i < pending.meshes.size();
+                                                          i = pending.nextMesh++)
+                                                     {
+                                                         pending.meshes[i] = std::make_unique<Mesh>(
+                                                             *vulkanDevice, *vulkanUploader,
+                                                             SceneFile::buildMesh(pending.description.meshes[i]));
+                                                     }
+                                                 }));
+    }
+
+    // The simulation owns the authoritative transforms from here on (one body per object)
+    std::vector<SimulationBody> bodies;
+    bodies.reserve(description.instances.size());
+    for (const SceneInstance &instance : description.instances)
+    {
+        SimulationBody body;
+        body.transform = instance.transform;
+        body.angularVelocity = instance.angularVelocity;
+        bodies.push_back(body);
+    }
+    simulation = std::make_unique<Simulation>(std::move(bodies), settings.simulationRate);
+
+    std::cout << "Scene: " << description.instances.size() << " objects, " << description.meshes.size()
+              << " meshes, " << description.materials.size() << " materials" << std::endl;
+}
+
+bool VulkanRenderer::revealScene()
+{
+    if (!pendingScene)
+        return true;
+    PendingScene &pending = *pendingScene;
+
+    auto ready = [](const auto &future)
+    { return !future.valid() || future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; };
+
+    if (!pending.built)
+    {
+        if (!ready(pending.pipeline) ||
+            !std::all_of(pending.meshWorkers.begin(), pending.meshWorkers.end(), ready))
+            return false;
+
+        // get() rethrows whatever failed on a worker
+        for (std::future<void> &worker : pending.meshWorkers)
+            worker.get();
+        const size_t firstMesh = meshes.size();
+        for (std::unique_ptr<Mesh> &mesh : pending.meshes)
+        {
+            pending.uploadTicket = std::max(pending.uploadTicket, mesh->getUploadTicket());
+            meshes.push_back(std::move(mesh));
+        }
+
+        const size_t firstMaterial = materials.size();
+        if (pending.pipeline.valid())
+            materials.push_back(pending.pipeline.get());
+        for (size_t i = 1; i < pending.materialIds.size(); ++i)
+            materials.push_back(materials[firstMaterial]->createInstance(pending.materialIds[i]));
+
+        pending.firstObject = gameObjects.size();
+        gameObjects.reserve(gameObjects.size() + pending.description.instances.size());
+        for (const SceneInstance &instance : pending.description.instances)
+        {
+            gameObjects.push_back(std::make_unique<GameObject>(meshes[firstMesh + instance.mesh].get(),
+                                                               materials[firstMaterial + instance.material].get(),
+                                                               instance.transform));
+        }
+        pending.built = true;
+    }
+
+    if (!vulkanUploader->isComplete(pending.uploadTicket))
+        return false;
+
+    for (size_t i = pending.firstObject; i < gameObjects.size(); ++i)
+        vulkanFrame->addGameObject(gameObjects[i].get());
+    pendingScene.reset();
+    startupTimeline.mark("scene visible");
+    return true;
+}
+
+void VulkanRenderer::createAnimatedInstances(const RenderTargetFormats &targets,
+                                             const std::vector<vk::DescriptorSetLayout> &setLayouts,
+                                             const MaterialParams &params, Mesh *mesh)
+{
+    // Same shaders, instanced permutation: model matrices come from the animator's buffer
+    auto shader = std::make_unique<VulkanShader>(*vulkanDevice, "shaders/cube.vert.spv", "shaders/cube.frag.spv");
+    materials.push_back(std::make_unique<Material>(*vulkanDevice, targets, PipelineDescs::kInstanced,
+                                                   std::move(shader), setLayouts,
+                                                   vulkanBindless->registerMaterial(params)));
+    const Material *material = materials.back().get();
+
+    vulkanInstanceAnimator = std::make_unique<VulkanInstanceAnimator>(*vulkanDevice, *vulkanFrameRing);
+
+    // A flat grid below the hand-placed objects; every third instance runs each program
+    const uint32_t count = settings.animatedInstances;
+    const uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+    const float spacing = 20.0f / static_cast<float>(side);
+
+    std::vector<glm::vec3> circle;
+    for (int i = 0; i < 8; ++i)
+    {
+        float angle = glm::radians(45.0f * static_cast<float>(i));
+        circle.push_back(glm::vec3(std::cos(angle), 0.0f, std::sin(angle)) * (0.4f * spacing));
+    }
+    const uint32_t circlePath = vulkanInstanceAnimator->addPath(circle);
+
+    std::vector<AnimationParams> instances(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        AnimationParams &p = instances[i];
+        float x = (static_cast<float>(i % side) + 0.5f) * spacing - 10.0f;
+        float z = (static_cast<float>(i / side) + 0.5f) * spacing - 10.0f;
+        p.origin = glm::vec4(x, -1.5f, z, 0.3f * spacing);
+        p.phase = static_cast<float>(i % 97) * 0.1f;
+
+        switch (i % 3)
+        {
+        case 0:
+            p.programs = AnimateRotate;
+            p.rotation = glm::vec4(glm::normalize(glm::vec3(1.0f, 2.0f, 0.5f)), 1.5f);
+            break;
+        case 1:
+            p.programs = AnimateRotate | AnimateOscillate;
+            p.rotation = glm::vec4(0.0f, 1.0f, 0.0f, -2.0f);
+            p.oscillation = glm::vec4(0.0f, 0.5f * spacing, 0.0f, 0.5f);
+            break;
+        default:
+            p.programs = AnimateFollowPath;
+            p.pathFirst = circlePath;
+            p.pathCount = static_cast<uint32_t>(circle.size());
+            p.pathSpeed = 4.0f;
+            break;
+        }
+    }
+    vulkanInstanceAnimator->addGroup(mesh, material, instances);
+    vulkanInstanceAnimator->upload();
+    vulkanFrame->setAnimator(vulkanInstanceAnimator.get());
+}
+
+void VulkanRenderer::createParticles(const RenderTargetFormats &targets)
+{
+    vulkanParticleSystem = std::make_unique<VulkanParticleSystem>(*vulkanDevice, *vulkanFrameRing, targets,
+                                                                  settings.particles);
+
+    // Three fountains around the hand-placed objects, emitting roughly the capacity per lifetime
+    const glm::vec4 colors[] = {glm::vec4(1.0f, 0.5f, 0.1f, 0.8f), glm::vec4(0.2f, 0.6f, 1.0f, 0.8f),
+                                glm::vec4(0.4f, 1.0f, 0.3f, 0.8f)};
+    for (int i = 0; i < 3; ++i)
+    {
+        ParticleEmitter emitter;
+        emitter.positionRate = glm::vec4(-3.0f + 3.0f * static_cast<float>(i), -1.0f, -2.0f,
+                                         static_cast<float>(vulkanParticleSystem->getCapacity()) / (3.0f * 2.0f));
+        emitter.velocitySpread = glm::vec4(0.0f, 5.0f, 0.0f, 1.0f);
+        emitter.color = colors[i];
+        emitter.lifetime = 2.0f;
+        emitter.size = 0.04f;
+        vulkanParticleSystem->addEmitter(emitter);
     }
+    vulkanFrame->setParticles(vulkanParticleSystem.get());
+}
+
+void VulkanRenderer::createStreaming(const RenderTargetFormats &targets,
+                                     const std::vector<vk::DescriptorSetLayout> &setLayouts,
+                                     const MaterialParams &defaultParams)
+{
+    StreamingSettings streaming;
+    streaming.memoryBudget = static_cast<uint64_t>(settings.streamBudgetMB) * 1024 * 1024;
+    streaming.retireFrames = MAX_FRAMES_IN_FLIGHT + 1;
+
+    std::unique_ptr<CellSource> source;
+    if (settings.streamSource == "generate")
+        source = std::make_unique<GeneratedCellSource>(streaming.cellSize, kObjectsPerGeneratedCell);
+    else
+        source = std::make_unique<DirectoryCellSource>(settings.streamSource);
+
+    // Streamed colors share one untextured pipeline; each distinct color registers one bindless
+    // material, up to kMaxStreamedMaterials (or until the table is full)
+    auto shader = std::make_unique<VulkanShader>(*vulkanDevice, "shaders/cube.vert.spv", "shaders/cube.frag.spv");
+    materials.push_back(std::make_unique<Material>(*vulkanDevice, targets, scenePipelineDesc(settings),
+                                                   std::move(shader), setLayouts,
+                                                   vulkanBindless->registerMaterial(defaultParams)));
+    Material *baseMaterial = materials.back().get();
+    auto resolveMaterial = [this, baseMaterial, defaultParams](const glm::vec4 &color) -> Material *
+    {
+        uint32_t key = 0;
+        for (int i = 0; i < 4; ++i)
+            key |= static_cast<uint32_t>(std::clamp(color[i], 0.0f, 1.0f) * 255.0f + 0.5f) << (8 * i);
+        auto it = streamedMaterials.find(key);
+        if (it != streamedMaterials.end())
+            return it->second;
+
+        auto fallBack = [this, baseMaterial]()
+        {
+            if (!streamedPaletteFull)
+                std::cerr << "Streamed material palette is full; further colors use the base material" << std::endl;
+            streamedPaletteFull = true;
+            return baseMaterial;
+        };
+        if (streamedMaterials.size() >= kMaxStreamedMaterials)
+            return fallBack();
+
+        MaterialParams params = defaultParams;
+        params.baseColor = color;
+        uint32_t materialId = 0;
+        try
+        {
+            materialId = vulkanBindless->registerMaterial(params);
+        }
+        catch (const std::runtime_error &)
+        {
+            return fallBack(); // Table full: the scene and streaming share it
+        }
+        materials.push_back(baseMaterial->createInstance(materialId));
+        streamedMaterials.emplace(key, materials.back().get());
+        return materials.back().get();
+    };
+
+    worldStreamer = std::make_unique<WorldStreamer>(*vulkanDevice, *vulkanUploader, std::move(source),
+                                                    resolveMaterial, streaming);
+
+    // Give memory back before allocations start failing. Runs inside the tracker's update(),
+    // on this thread, and only flags the streamer; the budget changes at its next update().
+    vulkanDevice->getMemoryTracker().addPressureCallback(
+        [this](uint32_t, const MemoryHeapStatus &)
+        {
+            if (worldStreamer)
+                worldStreamer->reduceBudget();
+        });
 }
 
 void VulkanRenderer::mainLoop()
 {
+    uint64_t framesDrawn = 0;
+    uint64_t trianglesSubmitted = 0;
+    uint64_t trianglesFullDetail = 0;
+    uint64_t pipelineBinds = 0;
+    uint64_t materialChanges = 0;
+    uint64_t meshBinds = 0;
+    uint64_t fragmentInvocations = 0;
+    uint64_t shadedPixels = 0;
+    uint64_t occlusionCulled = 0;
+    auto accumulateStats = [&]()
+    {
+        const FrameStats &stats = vulkanFrame->getStats();
+        ++framesDrawn;
+        trianglesSubmitted += stats.trianglesSubmitted;
+        trianglesFullDetail += stats.trianglesFullDetail;
+        pipelineBinds += stats.pipelineBinds;
+        materialChanges += stats.materialChanges;
+        meshBinds += stats.meshBinds;
+        occlusionCulled += stats.occlusionCulled;
+        if (stats.fragmentInvocations > 0)
+        {
+            fragmentInvocations += stats.fragmentInvocations;
+            shadedPixels += stats.viewportPixels;
+        }
+    };
+
+    // Budget queries are cheap but not free; poll them a few times a second
+    using Clock = std::chrono::steady_clock;
+    auto lastBudgetQuery = Clock::now();
+    auto lastMemoryReport = lastBudgetQuery;
+    auto pollMemory = [&]()
+    {
+        auto now = Clock::now();
+        if (now - lastBudgetQuery < std::chrono::milliseconds(250))
+            return;
+        lastBudgetQuery = now;
+        vulkanDevice->getMemoryTracker().update();
+        if (settings.memoryReport > 0 && now - lastMemoryReport >= std::chrono::seconds(settings.memoryReport))
+        {
+            lastMemoryReport = now;
+            vulkanDevice->getMemoryTracker().report(std::cout);
+        }
+    };
+
+    // Latest simulation snapshot, interpolated to this frame's time; never waits on the simulation.
+    // A scene at rest leaves the objects alone, so the frame can reuse last frame's culling.
+    size_t simulatedObjects = 0;
+    auto applySimulation = [&]()
+    {
+        const bool moved = simulation->interpolate(Clock::now(), interpolatedTransforms);
+        // Until the scene is revealed there are bodies but no objects yet
+        const size_t count = std::min(interpolatedTransforms.size(), gameObjects.size());
+        if (!moved && count == simulatedObjects)
+            return;
+        for (size_t i = 0; i < count; ++i)
+            gameObjects[i]->transform = interpolatedTransforms[i];
+        simulatedObjects = count;
+        if (count > 0)
+            vulkanFrame->markObjectsChanged();
+    };
+
+    // Startup keeps finishing while frames are drawn: the scene's mesh uploads go out with
+    // each frame and the scene appears as soon as they have landed
+    bool sceneVisible = false;
+    bool startupReported = false;
+    auto finishStartup = [&]()
+    {
+        vulkanUploader->submit();
+        sceneVisible = revealScene();
+    };
+    auto framePresented = [&]()
+    {
+        if (framesDrawn == 1)
+            startupTimeline.mark("first frame presented");
+        if (sceneVisible && !startupReported)
+        {
+            startupTimeline.mark("first frame with the scene");
+            startupTimeline.report(std::cout);
+            startupReported = true;
+        }
+    };
+
+    // Fly over the streamed world: straight along +x, weaving so cells also enter from the sides
+    const auto streamStart = Clock::now();
+    uint64_t streamFrame = 0;
+    auto streamWorld = [&]()
+    {
+        if (!worldStreamer)
+            return;
+        const float t = std::chrono::duration<float>(Clock::now() - streamStart).count();
+        const glm::vec3 eye(8.0f * t, 12.0f, 20.0f * std::sin(0.1f * t));
+        const glm::vec3 forward = glm::normalize(glm::vec3(1.0f, -0.35f, 0.0f));
+        vulkanFrame->setCamera(eye, eye + forward);
+
+        WorldStreamer::Changes changes = worldStreamer->update(eye, forward, streamFrame++);
+        if (!changes.removed.empty())
+            vulkanFrame->removeGameObjects(changes.removed);
+        for (GameObject *object : changes.added)
+            vulkanFrame->addGameObject(object);
+    };
+
+    simulation->start();
+
     const char *stressEnv = std::getenv("STRESS_FRAMES");
     if (stressEnv)
     {
@@ -121,14 +670,22 @@ void VulkanRenderer::mainLoop()
         while (frames < targetFrames && !glfwWindowShouldClose(window))
         {
             glfwPollEvents();
+            finishStartup();
+            applySimulation();
+            streamWorld();
 
             auto result = vulkanFrame->draw(currentFrame);
 
             if (result == FrameResult::SwapchainOutOfDate)
             {
-                vulkanSwapchain->recreate(vulkanRenderPass->get());
-                vulkanFrame->updateTargetAspect();
+                recreateSwapchain();
+            }
+            else
+            {
+                accumulateStats();
+                framePresented();
             }
+            pollMemory();
 
             ++frames;
         }
@@ -138,18 +695,105 @@ void VulkanRenderer::mainLoop()
         while (!glfwWindowShouldClose(window))
         {
             glfwPollEvents();
+            finishStartup();
+            applySimulation();
+            streamWorld();
 
             auto result = vulkanFrame->draw(currentFrame);
 
             if (result == FrameResult::SwapchainOutOfDate)
             {
-                vulkanSwapchain->recreate(vulkanRenderPass->get());
-                vulkanFrame->updateTargetAspect();
+                recreateSwapchain();
+            }
+            else
+            {
+                accumulateStats();
+                framePresented();
             }
+            pollMemory();
         }
     }
 
+    simulation->stop();
     vulkanDevice->getLogicalDevice().waitIdle();
+
+    if (vulkanFrameCapture)
+    {
+        vulkanFrameCapture->flush();
+        std::cout << "Frames captured to " << settings.captureDir << ": " << vulkanFrameCapture->getCapturedCount()
+                  << " (" << vulkanFrameCapture->getDroppedCount() << " dropped while the writer was busy)"
+                  << std::endl;
+    }
+
+    // Depth and MSAA color are transient; on tilers they may never be committed at all
+    const double mb = 1.0 / (1024.0 * 1024.0);
+    AttachmentMemoryInfo attachmentMemory = vulkanSwapchain->getAttachmentMemory();
+    std::cout << "Attachment memory (" << static_cast<uint32_t>(vulkanSwapchain->getSampleCount()) << "x MSAA, "
+              << vk::to_string(vulkanSwapchain->getDepthFormat()) << "): "
+              << attachmentMemory.allocated * mb << " MB allocated, "
+              << attachmentMemory.lazilyAllocated * mb << " MB lazily allocated, "
+              << attachmentMemory.committed * mb << " MB committed, saved "
+              << (attachmentMemory.lazilyAllocated - attachmentMemory.committed) * mb << " MB" << std::endl;
+    vulkanDevice->getMemoryTracker().update();
+    vulkanDevice->getMemoryTracker().summary(std::cout);
+
+    std::cout << "Simulation: " << simulation->getTickCount() << " ticks at " << settings.simulationRate
+              << " Hz, " << simulation->getSkippedTicks() << " skipped after stalls, "
+              << simulation->getUnseenSnapshots() << " snapshots superseded before a frame used them" << std::endl;
+
+    if (worldStreamer)
+    {
+        StreamingStats streaming = worldStreamer->getStats();
+        std::cout << "Streaming: " << streaming.cellsLoaded << " cells loaded, " << streaming.cellsEvicted
+                  << " evicted, " << streaming.cellsCancelled << " cancelled; " << streaming.residentCells
+                  << " resident (" << streaming.residentObjects << " objects, " << streaming.residentBytes * mb
+                  << " of " << streaming.memoryBudget * mb << " MB), " << vulkanUploader->getUploadedBytes() * mb
+                  << " MB uploaded" << std::endl;
+    }
+
+    if (framesDrawn > 0)
+    {
+        std::cout << "Triangles submitted per frame: " << trianglesSubmitted / framesDrawn
+                  << " (full detail: " << trianglesFullDetail / framesDrawn << ")" << std::endl;
+        std::cout << "State changes per frame (draw sorting " << (settings.sortDraws ? "on" : "off")
+                  << "): pipelines " << static_cast<double>(pipelineBinds) / framesDrawn
+                  << ", materials " << static_cast<double>(materialChanges) / framesDrawn
+                  << ", meshes " << static_cast<double>(meshBinds) / framesDrawn << std::endl;
+        if (const VulkanCommandCache *commandCache = vulkanFrame->getCommandCache())
+        {
+            std::cout << "Prerecorded scene draws: " << commandCache->getReuseCount() << " replays, "
+                      << commandCache->getRecordCount() << " recordings (including per-frame content)" << std::endl;
+        }
+        if (vulkanOcclusionCuller)
+        {
+            std::cout << "Draws culled by occlusion per frame: "
+                      << static_cast<double>(occlusionCulled) / framesDrawn << std::endl;
+        }
+        if (shadedPixels > 0)
+        {
+            std::cout << "Overdraw (fragment invocations per viewport pixel): "
+                      << static_cast<double>(fragmentInvocations) / static_cast<double>(shadedPixels) << std::endl;
+        }
+    }
+
+    const VulkanRenderGraph &renderGraph = vulkanFrame->getRenderGraph();
+    renderGraph.dump(std::cout);
+    if (!settings.graphDumpPath.empty())
+    {
+        std::ofstream dot(settings.graphDumpPath);
+        if (dot)
+            renderGraph.dumpGraphviz(dot);
+        else
+            std::cerr << "Could not write render graph to " << settings.graphDumpPath << std::endl;
+    }
+}
+
+void VulkanRenderer::recreateSwapchain()
+{
+    vulkanSwapchain->recreate();
+    vulkanFrame->updateTargetAspect();
+    if (vulkanOcclusionCuller)
+        vulkanOcclusionCuller->recreate(); // The depth image was replaced
 }
 
 void VulkanRenderer::cleanup()
@@ -159,14 +803,36 @@ void VulkanRenderer::cleanup()
 
     vulkanDevice->getLogicalDevice().waitIdle();
 
+    // Scene workers may be blocked on a full staging ring that only submit() drains
+    if (pendingScene)
+    {
+        for (std::future<void> &worker : pendingScene->meshWorkers)
+        {
+            while (worker.valid() && worker.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready)
+                vulkanUploader->submit();
+        }
+        vulkanUploader->waitIdle();
+    }
+
     // Clean up in reverse order of dependencies
+    simulation.reset(); // Joins the thread
+    pendingScene.reset(); // Joins the pipeline job
     vulkanFrame.reset();
+    worldStreamer.reset(); // Joins the workers; needs the uploader
+    vulkanUploader.reset();
     gameObjects.clear(); // GameObjects reference meshes/materials
     materials.clear();   // Materials must be destroyed before device
     meshes.clear();      // Meshes use GPU resources
+    textures.clear();
+    vulkanOcclusionCuller.reset();
+    vulkanFrameCapture.reset();
+    vulkanInstanceAnimator.reset();
+    vulkanParticleSystem.reset();
+    vulkanHud.reset();
+    vulkanBindless.reset();
+    vulkanFrameRing.reset();
     vulkanSync.reset();
     vulkanCommand.reset();
-    vulkanRenderPass.reset();
     vulkanSwapchain.reset();
     vulkanSurface.reset();
     vulkanDevice.reset();
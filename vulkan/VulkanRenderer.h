@@ -6,15 +6,30 @@
 #include "VulkanInstance.h"
 #include "VulkanDevice.h"
 #include "VulkanSwapchain.h"
-#include "VulkanRenderPass.h"
 #include "VulkanCommand.h"
 #include "VulkanSync.h"
 #include "VulkanSurface.h"
 #include "VulkanFrame.h"
+#include "VulkanFrameRing.h"
+#include "VulkanBindless.h"
+#include "VulkanTexture.h"
+#include "VulkanOcclusionCuller.h"
+#include "VulkanFrameCapture.h"
+#include "VulkanInstanceAnimator.h"
+#include "VulkanParticleSystem.h"
+#include "VulkanUploader.h"
+#include "VulkanHud.h"
+#include "src/RenderSettings.h"
+#include "src/Simulation.h"
+#include "src/StartupTimeline.h"
+#include "src/WorldStreamer.h"
+#include <unordered_map>
 
 class Mesh;
 class Material;
 struct GameObject;
+struct RenderTargetFormats;
+struct SceneDescription;
 
 class VulkanRenderer
 {
@@ -27,24 +42,60 @@ private:
     void initVulkan();
     void mainLoop();
     void cleanup();
+    void recreateSwapchain();
+    // Starts building the description's pipeline and meshes on worker threads and creates the simulation
+    void buildScene(SceneDescription scene, const RenderTargetFormats &targets,
+                    const std::vector<vk::DescriptorSetLayout> &setLayouts, const MaterialParams &defaultParams);
+    // Render thread, once per frame: hands the scene to the frame once everything it needs is
+    // on the GPU. Returns whether the scene is visible.
+    bool revealScene();
+    void createAnimatedInstances(const RenderTargetFormats &targets,
+                                 const std::vector<vk::DescriptorSetLayout> &setLayouts,
+                                 const MaterialParams &params, Mesh *mesh);
+    void createParticles(const RenderTargetFormats &targets);
+    void createStreaming(const RenderTargetFormats &targets, const std::vector<vk::DescriptorSetLayout> &setLayouts,
+                         const MaterialParams &defaultParams);
 
     GLFWwindow *window;
+    RenderSettings settings;
+    StartupTimeline startupTimeline; // Reported once the scene is on screen
 
     // Core Vulkan components
     std::unique_ptr<VulkanInstance> vulkanInstance;
     std::unique_ptr<VulkanDevice> vulkanDevice;
     std::unique_ptr<VulkanSwapchain> vulkanSwapchain;
-    std::unique_ptr<VulkanRenderPass> vulkanRenderPass;
     std::unique_ptr<VulkanCommand> vulkanCommand;
     std::unique_ptr<VulkanSync> vulkanSync;
     std::unique_ptr<VulkanSurface> vulkanSurface;
+    std::unique_ptr<VulkanFrameRing> vulkanFrameRing;
+    std::unique_ptr<VulkanBindless> vulkanBindless;
+    std::unique_ptr<VulkanOcclusionCuller> vulkanOcclusionCuller;
+    std::unique_ptr<VulkanFrameCapture> vulkanFrameCapture;
+    std::unique_ptr<VulkanInstanceAnimator> vulkanInstanceAnimator;
+    std::unique_ptr<VulkanParticleSystem> vulkanParticleSystem;
+    std::unique_ptr<VulkanHud> vulkanHud;
+    std::unique_ptr<VulkanUploader> vulkanUploader;
     std::unique_ptr<VulkanFrame> vulkanFrame;
 
     // Scene resources
     std::vector<std::unique_ptr<Mesh>> meshes;
+    std::vector<std::unique_ptr<VulkanTexture>> textures;
     std::vector<std::unique_ptr<Material>> materials;
     std::vector<std::unique_ptr<GameObject>> gameObjects;
 
+    // Scene still being built in the background (null once revealed)
+    struct PendingScene;
+    std::unique_ptr<PendingScene> pendingScene;
+
+    // Cells streamed in around the camera; their materials live in `materials`, keyed by RGBA8 color
+    std::unique_ptr<WorldStreamer> worldStreamer;
+    std::unordered_map<uint32_t, Material *> streamedMaterials;
+    bool streamedPaletteFull = false; // Reported once
+
+    // Game logic runs on its own thread; the render thread only reads its snapshots
+    std::unique_ptr<Simulation> simulation;
+    std::vector<Transform> interpolatedTransforms;
+
     // Frame tracking
     uint32_t currentFrame = 0;
     const uint32_t MAX_FRAMES_IN_FLIGHT = 3;
@@ -1,5 +1,6 @@
 #include "VulkanShader.h"
 #include "VulkanDevice.h"
+#include "shaders/EmbeddedShaders.h"
 
 #include <iostream>
 #include <fstream>
@@ -44,10 +45,23 @@ VulkanShader::VulkanShader(const VulkanDevice &device,
     fragmentModule = loadModule(fragPath);
 }
 
-VulkanShader::VulkanShader(const VulkanDevice &device)
+VulkanShader::VulkanShader(const VulkanDevice &device, const std::string &computePath)
     : deviceRef(device)
 {
-    // Reserved for future use (e.g., embedded SPIR-V or default shaders)
+    computeModule = loadModule(computePath);
+}
+
+VulkanShader::VulkanShader(const VulkanDevice &device, const SpirvCode &vert, const SpirvCode &frag)
+    : deviceRef(device)
+{
+    vertexModule = createModule(vert);
+    fragmentModule = createModule(frag);
+}
+
+VulkanShader::VulkanShader(const VulkanDevice &device, const SpirvCode &compute)
+    : deviceRef(device)
+{
+    computeModule = createModule(compute);
 }
 
 VulkanShader::~VulkanShader()
@@ -60,12 +74,57 @@ VulkanShader::~VulkanShader()
     {
         deviceRef.getLogicalDevice().destroyShaderModule(fragmentModule);
     }
+    if (computeModule)
+    {
+        deviceRef.getLogicalDevice().destroyShaderModule(computeModule);
+    }
+}
+
+SpirvCode VulkanShader::findEmbedded(const std::string &path)
+{
+    // Also match by file name, for paths relative to somewhere else
+    const std::string name = std::filesystem::path(path).filename().string();
+    for (const EmbeddedShader &shader : kEmbeddedShaders)
+    {
+        if (path == shader.path || name == std::filesystem::path(shader.path).filename().string())
+            return SpirvCode{shader.code, shader.wordCount};
+    }
+    return SpirvCode();
+}
+
+vk::ShaderModule VulkanShader::createModule(const SpirvCode &spirv)
+{
+    constexpr uint32_t kSpirvMagic = 0x07230203;
+    if (!spirv.code || spirv.wordCount == 0 || spirv.code[0] != kSpirvMagic)
+        throw std::runtime_error("invalid SPIR-V module!");
+
+    vk::ShaderModuleCreateInfo createInfo({}, spirv.wordCount * sizeof(uint32_t), spirv.code);
+    return deviceRef.getLogicalDevice().createShaderModule(createInfo);
 }
 
 vk::ShaderModule VulkanShader::loadModule(const std::string &path)
 {
     std::vector<char> code;
 
+    if (!overrideDirectory.empty())
+    {
+        std::filesystem::path candidate =
+            std::filesystem::path(overrideDirectory) / std::filesystem::path(path).filename();
+        std::error_code error;
+        if (std::filesystem::exists(candidate, error))
+        {
+            code = readFile(candidate.string());
+            std::cerr << "Loaded shader SPIR-V override from: " << candidate.string() << std::endl;
+            return createModule(
+                SpirvCode{reinterpret_cast<const uint32_t *>(code.data()), code.size() / sizeof(uint32_t)});
+        }
+    }
+
+    // The usual case: compiled into the executable, no file I/O
+    SpirvCode embedded = findEmbedded(path);
+    if (embedded.code)
+        return createModule(embedded);
+
     // Try given path first, then fall back to executable directory and its parent (common CMake build layout)
     try
     {
@@ -117,10 +176,5 @@ vk::ShaderModule VulkanShader::loadModule(const std::string &path)
             throw std::runtime_error("failed to open shader file: " + path);
     }
 
-    vk::ShaderModuleCreateInfo createInfo(
-        {},
-        code.size(),
-        reinterpret_cast<const uint32_t *>(code.data()));
-
-    return deviceRef.getLogicalDevice().createShaderModule(createInfo);
+    return createModule(SpirvCode{reinterpret_cast<const uint32_t *>(code.data()), code.size() / sizeof(uint32_t)});
 }
\ No newline at end of file
@@ -1,30 +1,57 @@
 #pragma once
 
 #include <vulkan/vulkan.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 class VulkanDevice;
 
+// A SPIR-V module in memory (e.g. one of kEmbeddedShaders)
+struct SpirvCode
+{
+    const uint32_t *code = nullptr;
+    size_t wordCount = 0;
+};
+
 class VulkanShader
 {
 public:
-    // Load from SPIR-V file paths
+    // Load by SPIR-V path as passed to add_spv_shader (e.g. "shaders/cube.vert.spv"). The
+    // module embedded at build time is used unless the override directory holds the file;
+    // paths that were never embedded are read from disk.
     VulkanShader(const VulkanDevice &device,
                  const std::string &vertPath,
                  const std::string &fragPath);
 
-    // Reserved for future use (e.g., embedded SPIR-V)
-    VulkanShader(const VulkanDevice &device);
+    // Single compute stage
+    VulkanShader(const VulkanDevice &device, const std::string &computePath);
+
+    // Build the modules from SPIR-V already in memory
+    VulkanShader(const VulkanDevice &device, const SpirvCode &vert, const SpirvCode &frag);
+    VulkanShader(const VulkanDevice &device, const SpirvCode &compute);
 
     ~VulkanShader();
 
+    // The embedded module for an add_spv_shader output path (empty if there is none)
+    static SpirvCode findEmbedded(const std::string &path);
+
+    // .spv files in this directory replace the embedded modules of the same name (modding).
+    // Set once at startup, before any shader is created; empty disables overrides.
+    static void setOverrideDirectory(const std::string &directory) { overrideDirectory = directory; }
+
     vk::ShaderModule getVertexModule() const { return vertexModule; }
     vk::ShaderModule getFragmentModule() const { return fragmentModule; }
+    vk::ShaderModule getComputeModule() const { return computeModule; }
 
 private:
     vk::ShaderModule loadModule(const std::string &path);
+    vk::ShaderModule createModule(const SpirvCode &spirv);
+
+    static inline std::string overrideDirectory;
 
     const VulkanDevice &deviceRef;
     vk::ShaderModule vertexModule = nullptr;
     vk::ShaderModule fragmentModule = nullptr;
+    vk::ShaderModule computeModule = nullptr;
 };
\ No newline at end of file
@@ -3,15 +3,21 @@
 
 #include "VulkanSwapchain.h"
 #include "VulkanDevice.h" // Needed for deviceRef getters
+#include "VulkanDebug.h"
 
 #include <algorithm>
 #include <limits>
+#include <stdexcept>
+#include <vector>
 
-VulkanSwapchain::VulkanSwapchain(const VulkanDevice &device, vk::SurfaceKHR surface, GLFWwindow *window)
-    : deviceRef(device), surface(surface), window(window)
+VulkanSwapchain::VulkanSwapchain(const VulkanDevice &device, vk::SurfaceKHR surface, GLFWwindow *window,
+                                 vk::SampleCountFlagBits samples, bool sampledDepth)
+    : deviceRef(device), surface(surface), window(window),
+      samples(samples), sampledDepth(sampledDepth), depthFormat(device.findDepthFormat(sampledDepth))
 {
     createSwapchain();
     createImageViews();
+    createAttachments();
 }
 
 VulkanSwapchain::~VulkanSwapchain()
@@ -19,7 +25,7 @@ VulkanSwapchain::~VulkanSwapchain()
     cleanup();
 }
 
-void VulkanSwapchain::recreate(vk::RenderPass renderPass)
+void VulkanSwapchain::recreate()
 {
     // Wait for non-zero window size (minimized)
     int width = 0, height = 0;
@@ -36,8 +42,9 @@ void VulkanSwapchain::recreate(vk::RenderPass renderPass)
 
     createSwapchain();
     createImageViews();
-    createFramebuffers(renderPass);
+    createAttachments();
 }
+
 void VulkanSwapchain::createSwapchain()
 {
     SwapChainSupportDetails swapChainSupport = querySwapChainSupport(deviceRef.getPhysicalDevice());
@@ -52,6 +59,13 @@ void VulkanSwapchain::createSwapchain()
         imageCount = std::min(imageCount, swapChainSupport.capabilities.maxImageCount);
     }
 
+    // Transfer source lets frame capture copy the presented image without an extra blit
+    vk::ImageUsageFlags usage = vk::ImageUsageFlagBits::eColorAttachment;
+    transferSource = static_cast<bool>(swapChainSupport.capabilities.supportedUsageFlags &
+                                       vk::ImageUsageFlagBits::eTransferSrc);
+    if (transferSource)
+        usage |= vk::ImageUsageFlagBits::eTransferSrc;
+
     vk::SwapchainCreateInfoKHR createInfo(
         {},
         surface,
@@ -60,7 +74,7 @@ void VulkanSwapchain::createSwapchain()
         surfaceFormat.colorSpace,
         extent,
         1,
-        vk::ImageUsageFlagBits::eColorAttachment,
+        usage,
         vk::SharingMode::eExclusive,
         0,
         nullptr,
@@ -82,6 +96,7 @@ void VulkanSwapchain::createSwapchain()
     }
 
     swapChain = deviceRef.getLogicalDevice().createSwapchainKHR(createInfo);
+    VK_DEBUG_NAME(deviceRef.getLogicalDevice(), swapChain, "swapchain");
     swapChainImages = deviceRef.getLogicalDevice().getSwapchainImagesKHR(swapChain);
     swapChainImageFormat = surfaceFormat.format;
     swapChainExtent = extent;
@@ -102,89 +117,117 @@ void VulkanSwapchain::createImageViews()
             vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1));
 
         swapChainImageViews[i] = deviceRef.getLogicalDevice().createImageView(createInfo);
+        VK_DEBUG_NAME(deviceRef.getLogicalDevice(), swapChainImages[i], "swapchain image", static_cast<uint32_t>(i));
+        VK_DEBUG_NAME(deviceRef.getLogicalDevice(), swapChainImageViews[i], "swapchain view", static_cast<uint32_t>(i));
     }
+}
 
-    // create depth resources for the current swapchain extent
-    // simple choice: 32-bit float depth
-    vk::ImageCreateInfo depthInfo({}, vk::ImageType::e2D, vk::Format::eD32Sfloat,
-                                  vk::Extent3D(swapChainExtent.width, swapChainExtent.height, 1), 1, 1,
-                                  vk::SampleCountFlagBits::e1, vk::ImageTiling::eOptimal,
-                                  vk::ImageUsageFlagBits::eDepthStencilAttachment, vk::SharingMode::eExclusive);
+vk::ImageAspectFlags VulkanSwapchain::getDepthAspect() const
+{
+    vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eDepth;
+    if (depthFormat == vk::Format::eD24UnormS8Uint)
+        aspect |= vk::ImageAspectFlagBits::eStencil;
+    return aspect;
+}
 
-    depthImage = deviceRef.getLogicalDevice().createImage(depthInfo);
-    auto memReq = deviceRef.getLogicalDevice().getImageMemoryRequirements(depthImage);
-    vk::MemoryAllocateInfo allocInfo(memReq.size, 0);
-    // find a memory type supporting device local
-    auto memProps = deviceRef.getPhysicalDevice().getMemoryProperties();
-    bool found = false;
-    for (uint32_t i = 0; i < memProps.memoryTypeCount; ++i)
+void VulkanSwapchain::createAttachments()
+{
+    // Attachments whose contents never leave the render pass are transient, so tiled GPUs
+    // can keep them in on-chip memory and never commit lazily allocated backing for them.
+    // Depth stays a regular image when something samples it after the pass.
+    vk::ImageUsageFlags depthUsage = vk::ImageUsageFlagBits::eDepthStencilAttachment;
+    depthUsage |= sampledDepth ? vk::ImageUsageFlagBits::eSampled : vk::ImageUsageFlagBits::eTransientAttachment;
+    depth = createAttachment(depthFormat, depthUsage, getDepthAspect());
+    VK_DEBUG_NAME(deviceRef.getLogicalDevice(), depth.image, "depth");
+    VK_DEBUG_NAME(deviceRef.getLogicalDevice(), depth.view, "depth view");
+
+    if (samples != vk::SampleCountFlagBits::e1)
     {
-        if ((memReq.memoryTypeBits & (1 << i)) && (memProps.memoryTypes[i].propertyFlags & vk::MemoryPropertyFlagBits::eDeviceLocal))
-        {
-            allocInfo.memoryTypeIndex = i;
-            found = true;
-            break;
-        }
+        msaaColor = createAttachment(swapChainImageFormat,
+                                     vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransientAttachment,
+                                     vk::ImageAspectFlagBits::eColor);
+        VK_DEBUG_NAME(deviceRef.getLogicalDevice(), msaaColor.image, "msaa color");
+        VK_DEBUG_NAME(deviceRef.getLogicalDevice(), msaaColor.view, "msaa color view");
     }
-    if (!found)
-        throw std::runtime_error("failed to find suitable memory type for depth image");
-
-    depthImageMemory = deviceRef.getLogicalDevice().allocateMemory(allocInfo);
-    deviceRef.getLogicalDevice().bindImageMemory(depthImage, depthImageMemory, 0);
-
-    vk::ImageViewCreateInfo depthViewInfo({}, depthImage, vk::ImageViewType::e2D, vk::Format::eD32Sfloat,
-                                          vk::ComponentMapping(), vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eDepth, 0, 1, 0, 1));
-    depthImageView = deviceRef.getLogicalDevice().createImageView(depthViewInfo);
 }
 
-void VulkanSwapchain::createFramebuffers(vk::RenderPass renderPass)
+VulkanSwapchain::Attachment VulkanSwapchain::createAttachment(vk::Format format, vk::ImageUsageFlags usage,
+                                                              vk::ImageAspectFlags aspect)
 {
-    cleanupFramebuffers(); // Optional: clean old ones if recreating
+    auto dev = deviceRef.getLogicalDevice();
+    Attachment attachment;
+
+    vk::ImageCreateInfo imageInfo({}, vk::ImageType::e2D, format,
+                                  vk::Extent3D(swapChainExtent.width, swapChainExtent.height, 1), 1, 1,
+                                  samples, vk::ImageTiling::eOptimal, usage, vk::SharingMode::eExclusive);
+    attachment.image = dev.createImage(imageInfo);
 
-    swapChainFramebuffers.resize(swapChainImageViews.size());
+    auto memReq = dev.getImageMemoryRequirements(attachment.image);
+    auto memProps = deviceRef.getPhysicalDevice().getMemoryProperties();
 
-    for (size_t i = 0; i < swapChainImageViews.size(); ++i)
-    {
-        std::array<vk::ImageView, 2> attachments = {swapChainImageViews[i], depthImageView};
-        vk::FramebufferCreateInfo framebufferInfo({}, renderPass, static_cast<uint32_t>(attachments.size()), attachments.data(), swapChainExtent.width, swapChainExtent.height, 1);
-        swapChainFramebuffers[i] = deviceRef.getLogicalDevice().createFramebuffer(framebufferInfo);
-    }
+    // Lazily allocated memory first for transient attachments, then any device-local type
+    std::vector<vk::MemoryPropertyFlags> preferences;
+    if (usage & vk::ImageUsageFlagBits::eTransientAttachment)
+        preferences.push_back(vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated);
+    preferences.push_back(vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+    uint32_t memoryType = deviceRef.findMemoryType(memReq.memoryTypeBits, preferences);
+    if (memoryType == UINT32_MAX)
+        throw std::runtime_error("failed to find suitable memory type for swapchain attachment");
+
+    attachment.size = memReq.size;
+    attachment.lazy = static_cast<bool>(memProps.memoryTypes[memoryType].propertyFlags &
+                                        vk::MemoryPropertyFlagBits::eLazilyAllocated);
+
+    attachment.memory = deviceRef.allocateMemory(vk::MemoryAllocateInfo(memReq.size, memoryType),
+                                                 MemoryCategory::Attachments);
+    dev.bindImageMemory(attachment.image, attachment.memory, 0);
+
+    vk::ImageViewCreateInfo viewInfo({}, attachment.image, vk::ImageViewType::e2D, format,
+                                     vk::ComponentMapping(), vk::ImageSubresourceRange(aspect, 0, 1, 0, 1));
+    attachment.view = dev.createImageView(viewInfo);
+
+    return attachment;
 }
 
-void VulkanSwapchain::cleanupFramebuffers()
+void VulkanSwapchain::destroyAttachment(Attachment &attachment)
 {
-    for (auto framebuffer : swapChainFramebuffers)
+    auto dev = deviceRef.getLogicalDevice();
+    if (attachment.view)
+        dev.destroyImageView(attachment.view);
+    if (attachment.image)
+        dev.destroyImage(attachment.image);
+    deviceRef.freeMemory(attachment.memory);
+    attachment = Attachment();
+}
+
+AttachmentMemoryInfo VulkanSwapchain::getAttachmentMemory() const
+{
+    AttachmentMemoryInfo info;
+    for (const Attachment *attachment : {&depth, &msaaColor})
     {
-        deviceRef.getLogicalDevice().destroyFramebuffer(framebuffer);
+        if (!attachment->memory)
+            continue;
+        info.allocated += attachment->size;
+        if (attachment->lazy)
+        {
+            info.lazilyAllocated += attachment->size;
+            info.committed += deviceRef.getLogicalDevice().getMemoryCommitment(attachment->memory);
+        }
     }
-    swapChainFramebuffers.clear();
+    return info;
 }
 
 void VulkanSwapchain::cleanup()
 {
-    cleanupFramebuffers();
-
     for (auto imageView : swapChainImageViews)
     {
         deviceRef.getLogicalDevice().destroyImageView(imageView);
     }
     swapChainImageViews.clear();
 
-    if (depthImageView)
-    {
-        deviceRef.getLogicalDevice().destroyImageView(depthImageView);
-        depthImageView = vk::ImageView();
-    }
-    if (depthImage)
-    {
-        deviceRef.getLogicalDevice().destroyImage(depthImage);
-        depthImage = vk::Image();
-    }
-    if (depthImageMemory)
-    {
-        deviceRef.getLogicalDevice().freeMemory(depthImageMemory);
-        depthImageMemory = vk::DeviceMemory();
-    }
+    destroyAttachment(depth);
+    destroyAttachment(msaaColor);
 
     if (swapChain)
     {
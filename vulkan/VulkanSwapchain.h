@@ -12,27 +12,58 @@ struct SwapChainSupportDetails
     std::vector<vk::PresentModeKHR> presentModes;
 };
 
+// Memory behind the swapchain's own attachments (depth, MSAA color)
+struct AttachmentMemoryInfo
+{
+    vk::DeviceSize allocated = 0;       // Sum of allocation sizes
+    vk::DeviceSize lazilyAllocated = 0; // Part of `allocated` in lazily allocated memory
+    vk::DeviceSize committed = 0;       // Physically committed for the lazy part
+};
+
 class VulkanSwapchain
 {
 public:
-    VulkanSwapchain(const VulkanDevice &device, vk::SurfaceKHR surface, GLFWwindow *window);
+    // samples > 1 adds a transient MSAA color image resolved into the swapchain image.
+    // sampledDepth keeps depth readable after the pass (otherwise it is transient).
+    VulkanSwapchain(const VulkanDevice &device, vk::SurfaceKHR surface, GLFWwindow *window,
+                    vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1, bool sampledDepth = false);
     ~VulkanSwapchain();
 
     vk::SwapchainKHR getSwapchain() const { return swapChain; }
     vk::Format getImageFormat() const { return swapChainImageFormat; }
     vk::Extent2D getExtent() const { return swapChainExtent; }
+    vk::Image getImage(uint32_t index) const { return swapChainImages[index]; }
     const std::vector<vk::ImageView> &getImageViews() const { return swapChainImageViews; }
-    const std::vector<vk::Framebuffer> &getFramebuffers() const { return swapChainFramebuffers; }
-    vk::Framebuffer getFramebuffer(uint32_t index) const { return swapChainFramebuffers[index]; }
+    vk::Image getDepthImage() const { return depth.image; }
+    vk::ImageView getDepthImageView() const { return depth.view; }
+    vk::Format getDepthFormat() const { return depthFormat; }
+    vk::ImageAspectFlags getDepthAspect() const;
+    vk::Image getMsaaColorImage() const { return msaaColor.image; }
+    vk::ImageView getMsaaColorImageView() const { return msaaColor.view; }
+    vk::SampleCountFlagBits getSampleCount() const { return samples; }
+    bool supportsTransferSource() const { return transferSource; }
 
-    void recreate(vk::RenderPass renderPass);           // Self-contained recreation
-    void createFramebuffers(vk::RenderPass renderPass); // <-- Now public
+    AttachmentMemoryInfo getAttachmentMemory() const;
+
+    // Self-contained recreation: only images and views, nothing depends on a render pass
+    void recreate();
 
 private:
+    struct Attachment
+    {
+        vk::Image image;
+        vk::DeviceMemory memory;
+        vk::ImageView view;
+        vk::DeviceSize size = 0;
+        bool lazy = false;
+    };
+
     void createSwapchain();
     void createImageViews();
+    void createAttachments();
+    Attachment createAttachment(vk::Format format, vk::ImageUsageFlags usage, vk::ImageAspectFlags aspect);
+    void destroyAttachment(Attachment &attachment);
 
-    void cleanupFramebuffers();
     void cleanup();
 
     SwapChainSupportDetails querySwapChainSupport(vk::PhysicalDevice physicalDevice);
@@ -49,9 +80,12 @@ private:
     vk::Format swapChainImageFormat;
     vk::Extent2D swapChainExtent;
     std::vector<vk::ImageView> swapChainImageViews;
-    std::vector<vk::Framebuffer> swapChainFramebuffers;
-    // Depth resources
-    vk::Image depthImage;
-    vk::DeviceMemory depthImageMemory;
-    vk::ImageView depthImageView;
+    bool transferSource = false;
+
+    // Attachment configuration and resources (sized to the swapchain extent)
+    const vk::SampleCountFlagBits samples;
+    const bool sampledDepth;
+    const vk::Format depthFormat;
+    Attachment depth;
+    Attachment msaaColor; // Only with samples > 1
 };
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "VulkanSync.h"
 #include "VulkanDevice.h"
+#include "VulkanDebug.h"
 
 VulkanSync::VulkanSync(const VulkanDevice &device, uint32_t swapchainImageCount, uint32_t maxFramesInFlight)
     : deviceRef(device)
@@ -15,11 +16,14 @@ VulkanSync::VulkanSync(const VulkanDevice &device, uint32_t swapchainImageCount,
     {
         imageAvailableSemaphores[i] = deviceRef.getLogicalDevice().createSemaphore(semaphoreInfo);
         inFlightFences[i] = deviceRef.getLogicalDevice().createFence(fenceInfo);
+        VK_DEBUG_NAME(deviceRef.getLogicalDevice(), imageAvailableSemaphores[i], "image available", i);
+        VK_DEBUG_NAME(deviceRef.getLogicalDevice(), inFlightFences[i], "in flight", i);
     }
 
     for (uint32_t i = 0; i < swapchainImageCount; ++i)
     {
         renderFinishedSemaphores[i] = deviceRef.getLogicalDevice().createSemaphore(semaphoreInfo);
+        VK_DEBUG_NAME(deviceRef.getLogicalDevice(), renderFinishedSemaphores[i], "render finished", i);
     }
 }
 
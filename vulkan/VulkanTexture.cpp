@@ -0,0 +1,112 @@
+#include "VulkanTexture.h"
+#include "VulkanDevice.h"
+#include "VulkanDebug.h"
+
+#include <cstring>
+#include <stdexcept>
+
+VulkanTexture::VulkanTexture(const VulkanDevice &device,
+                             uint32_t width,
+                             uint32_t height,
+                             const void *pixels,
+                             vk::Format format,
+                             uint32_t bytesPerPixel)
+    : deviceRef(device), format(format), width(width), height(height)
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    vk::ImageCreateInfo imageInfo({}, vk::ImageType::e2D, format,
+                                  vk::Extent3D(width, height, 1), 1, 1,
+                                  vk::SampleCountFlagBits::e1, vk::ImageTiling::eOptimal,
+                                  vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
+                                  vk::SharingMode::eExclusive);
+    image = dev.createImage(imageInfo);
+    VK_DEBUG_NAME(dev, image, "texture");
+
+    auto memReq = dev.getImageMemoryRequirements(image);
+    vk::MemoryAllocateInfo allocInfo(memReq.size,
+                                     deviceRef.findMemoryType(memReq.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal));
+    imageMemory = deviceRef.allocateMemory(allocInfo, MemoryCategory::Textures);
+    dev.bindImageMemory(image, imageMemory, 0);
+
+    upload(pixels, static_cast<vk::DeviceSize>(width) * height * bytesPerPixel);
+
+    vk::ImageViewCreateInfo viewInfo({}, image, vk::ImageViewType::e2D, format,
+                                     vk::ComponentMapping(),
+                                     vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1));
+    imageView = dev.createImageView(viewInfo);
+    VK_DEBUG_NAME(dev, imageView, "texture view");
+}
+
+VulkanTexture::~VulkanTexture()
+{
+    auto dev = deviceRef.getLogicalDevice();
+    if (imageView)
+        dev.destroyImageView(imageView);
+    if (image)
+        dev.destroyImage(image);
+    deviceRef.freeMemory(imageMemory);
+}
+
+void VulkanTexture::upload(const void *pixels, vk::DeviceSize size)
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    // staging buffer
+    vk::BufferCreateInfo bufferInfo({}, size, vk::BufferUsageFlagBits::eTransferSrc, vk::SharingMode::eExclusive);
+    vk::Buffer stagingBuffer = dev.createBuffer(bufferInfo);
+    VK_DEBUG_NAME(dev, stagingBuffer, "texture staging");
+
+    auto memReq = dev.getBufferMemoryRequirements(stagingBuffer);
+    vk::MemoryAllocateInfo allocInfo(memReq.size,
+                                     deviceRef.findMemoryType(memReq.memoryTypeBits,
+                                                              vk::MemoryPropertyFlagBits::eHostVisible |
+                                                                  vk::MemoryPropertyFlagBits::eHostCoherent));
+    vk::DeviceMemory stagingMemory = deviceRef.allocateMemory(allocInfo, MemoryCategory::Staging);
+    dev.bindBufferMemory(stagingBuffer, stagingMemory, 0);
+
+    void *data = dev.mapMemory(stagingMemory, 0, size);
+    std::memcpy(data, pixels, static_cast<size_t>(size));
+    dev.unmapMemory(stagingMemory);
+
+    // copy staging -> image using a temporary command pool and buffer
+    vk::CommandPoolCreateInfo poolInfo({}, deviceRef.getGraphicsQueueFamily());
+    vk::CommandPool cmdPool = dev.createCommandPool(poolInfo);
+
+    vk::CommandBufferAllocateInfo allocCmdInfo(cmdPool, vk::CommandBufferLevel::ePrimary, 1);
+    vk::CommandBuffer cmd = dev.allocateCommandBuffers(allocCmdInfo)[0];
+
+    vk::CommandBufferBeginInfo beginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+    cmd.begin(beginInfo);
+
+    vk::ImageSubresourceRange range(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1);
+
+    vk::ImageMemoryBarrier toTransfer({}, vk::AccessFlagBits::eTransferWrite,
+                                      vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal,
+                                      VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, image, range);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,
+                        {}, nullptr, nullptr, toTransfer);
+
+    vk::BufferImageCopy region(0, 0, 0,
+                               vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1),
+                               vk::Offset3D(0, 0, 0), vk::Extent3D(width, height, 1));
+    cmd.copyBufferToImage(stagingBuffer, image, vk::ImageLayout::eTransferDstOptimal, region);
+
+    vk::ImageMemoryBarrier toShader(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead,
+                                    vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal,
+                                    VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, image, range);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,
+                        {}, nullptr, nullptr, toShader);
+
+    cmd.end();
+
+    vk::SubmitInfo submitInfo(0, nullptr, nullptr, 1, &cmd);
+    deviceRef.getGraphicsQueue().submit(submitInfo, {});
+    deviceRef.getGraphicsQueue().waitIdle();
+
+    dev.freeCommandBuffers(cmdPool, cmd);
+    dev.destroyCommandPool(cmdPool);
+
+    dev.destroyBuffer(stagingBuffer);
+    deviceRef.freeMemory(stagingMemory);
+}
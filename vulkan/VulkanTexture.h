@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+class VulkanDevice;
+
+// Sampled 2D image uploaded once from tightly packed pixels
+class VulkanTexture
+{
+public:
+    VulkanTexture(const VulkanDevice &device,
+                  uint32_t width,
+                  uint32_t height,
+                  const void *pixels,
+                  vk::Format format = vk::Format::eR8G8B8A8Unorm,
+                  uint32_t bytesPerPixel = 4);
+    ~VulkanTexture();
+
+    VulkanTexture(const VulkanTexture &) = delete;
+    VulkanTexture &operator=(const VulkanTexture &) = delete;
+
+    vk::Image getImage() const { return image; }
+    vk::ImageView getView() const { return imageView; }
+    vk::Format getFormat() const { return format; }
+    uint32_t getWidth() const { return width; }
+    uint32_t getHeight() const { return height; }
+
+private:
+    void upload(const void *pixels, vk::DeviceSize size);
+
+    const VulkanDevice &deviceRef;
+    vk::Image image;
+    vk::DeviceMemory imageMemory;
+    vk::ImageView imageView;
+    vk::Format format;
+    uint32_t width;
+    uint32_t height;
+};
@@ -0,0 +1,235 @@
+#include "VulkanUploader.h"
+#include "VulkanDevice.h"
+#include "VulkanDebug.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    constexpr vk::DeviceSize kUploadAlignment = 16;
+}
+
+VulkanUploader::VulkanUploader(const VulkanDevice &device, vk::DeviceSize stagingCapacity)
+    : deviceRef(device), capacity((stagingCapacity + kUploadAlignment - 1) / kUploadAlignment * kUploadAlignment)
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    void *mapped = nullptr;
+    DedicatedStaging ring = createStaging(capacity, &mapped);
+    ringBuffer = ring.buffer;
+    ringMemory = ring.memory;
+    ringMapped = static_cast<uint8_t *>(mapped);
+    VK_DEBUG_NAME(dev, ringBuffer, "upload staging ring");
+
+    commandPool = dev.createCommandPool(vk::CommandPoolCreateInfo(vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+                                                                  deviceRef.getTransferQueueFamily()));
+    VK_DEBUG_NAME(dev, commandPool, "upload command pool");
+}
+
+VulkanUploader::~VulkanUploader()
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    waitIdle();
+    for (Batch &batch : freeBatches)
+        dev.destroyFence(batch.fence);
+    for (DedicatedStaging &staging : pendingDedicated)
+    {
+        dev.destroyBuffer(staging.buffer);
+        deviceRef.freeMemory(staging.memory);
+    }
+    if (commandPool)
+        dev.destroyCommandPool(commandPool);
+
+    if (ringMemory)
+        dev.unmapMemory(ringMemory);
+    if (ringBuffer)
+        dev.destroyBuffer(ringBuffer);
+    deviceRef.freeMemory(ringMemory);
+}
+
+VulkanUploader::DedicatedStaging VulkanUploader::createStaging(vk::DeviceSize size, void **mapped) const
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    DedicatedStaging staging;
+    staging.buffer = dev.createBuffer(
+        vk::BufferCreateInfo({}, size, vk::BufferUsageFlagBits::eTransferSrc, vk::SharingMode::eExclusive));
+    auto memReq = dev.getBufferMemoryRequirements(staging.buffer);
+    vk::MemoryAllocateInfo allocInfo(memReq.size,
+                                     deviceRef.findMemoryType(memReq.memoryTypeBits,
+                                                              vk::MemoryPropertyFlagBits::eHostVisible |
+                                                                  vk::MemoryPropertyFlagBits::eHostCoherent));
+    staging.memory = deviceRef.allocateMemory(allocInfo, MemoryCategory::Staging);
+    dev.bindBufferMemory(staging.buffer, staging.memory, 0);
+    *mapped = dev.mapMemory(staging.memory, 0, size);
+    return staging;
+}
+
+// Ring positions are virtual (they only ever grow); the physical offset is position % capacity.
+// A reservation that would straddle the end skips ahead to the start instead.
+bool VulkanUploader::reserveLocked(vk::DeviceSize size, vk::DeviceSize &position)
+{
+    vk::DeviceSize physical = head % capacity;
+    vk::DeviceSize skip = physical + size > capacity ? capacity - physical : 0;
+    if (head + skip + size - tail > capacity)
+        return false;
+
+    position = head;
+    head += skip + size;
+    return true;
+}
+
+VulkanUploader::Ticket VulkanUploader::upload(vk::Buffer dst, vk::DeviceSize dstOffset, vk::DeviceSize size,
+                                              const std::function<void(void *)> &fill)
+{
+    if (size == 0)
+        return 0;
+
+    Copy copy;
+    copy.dst = dst;
+    copy.dstOffset = dstOffset;
+    copy.size = size;
+
+    if (size > capacity)
+    {
+        void *mapped = nullptr;
+        DedicatedStaging staging = createStaging(size, &mapped);
+        fill(mapped);
+        deviceRef.getLogicalDevice().unmapMemory(staging.memory);
+
+        copy.staging = staging.buffer;
+        copy.stagingOffset = 0;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(copy);
+        pendingDedicated.push_back(staging);
+        uploadedBytes += size;
+        return openTicket;
+    }
+
+    const vk::DeviceSize reserved = (size + kUploadAlignment - 1) / kUploadAlignment * kUploadAlignment;
+    vk::DeviceSize position = 0;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        spaceFreed.wait(lock, [&]() { return reserveLocked(reserved, position); });
+        writing.push_back(position);
+    }
+
+    // The start may have skipped to the beginning of the ring
+    const vk::DeviceSize physical = position % capacity + reserved > capacity ? 0 : position % capacity;
+    fill(ringMapped + physical);
+
+    copy.staging = ringBuffer;
+    copy.stagingOffset = physical;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    writing.erase(std::find(writing.begin(), writing.end(), position));
+    pending.push_back(copy);
+    uploadedBytes += size;
+    return openTicket;
+}
+
+void VulkanUploader::submit()
+{
+    auto dev = deviceRef.getLogicalDevice();
+
+    // Batches finish in submission order on the one queue
+    while (!inFlight.empty() && dev.getFenceStatus(inFlight.front().fence) == vk::Result::eSuccess)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        retireLocked(inFlight.front());
+        freeBatches.push_back(inFlight.front());
+        inFlight.pop_front();
+    }
+
+    Batch batch;
+    std::vector<Copy> copies;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (pending.empty())
+            return;
+        copies.swap(pending);
+        batch.dedicated.swap(pendingDedicated);
+        batch.ticket = openTicket++;
+
+        // Reservations still being written stay owned by the ring until a later batch
+        batch.ringEnd = writing.empty() ? head : *std::min_element(writing.begin(), writing.end());
+    }
+
+    if (!freeBatches.empty())
+    {
+        batch.cmd = freeBatches.back().cmd;
+        batch.fence = freeBatches.back().fence;
+        freeBatches.pop_back();
+        dev.resetFences(batch.fence);
+    }
+    else
+    {
+        batch.cmd = dev.allocateCommandBuffers(
+            vk::CommandBufferAllocateInfo(commandPool, vk::CommandBufferLevel::ePrimary, 1))[0];
+        batch.fence = dev.createFence(vk::FenceCreateInfo());
+        VK_DEBUG_NAME(dev, batch.cmd, "upload batch");
+    }
+
+    batch.cmd.reset();
+    batch.cmd.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    {
+        VK_DEBUG_LABEL_SCOPE(batch.cmd, "uploads");
+        for (const Copy &copy : copies)
+            batch.cmd.copyBuffer(copy.staging, copy.dst, vk::BufferCopy(copy.stagingOffset, copy.dstOffset, copy.size));
+
+        // Later submissions on this queue may read the data anywhere
+        vk::MemoryBarrier2 barrier(vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferWrite,
+                                   vk::PipelineStageFlagBits2::eAllCommands, vk::AccessFlagBits2::eMemoryRead);
+        batch.cmd.pipelineBarrier2(vk::DependencyInfo({}, barrier, nullptr, nullptr));
+    }
+    batch.cmd.end();
+
+    vk::SubmitInfo submitInfo(0, nullptr, nullptr, 1, &batch.cmd);
+    deviceRef.getTransferQueue().submit(submitInfo, batch.fence);
+    inFlight.push_back(std::move(batch));
+}
+
+void VulkanUploader::retireLocked(Batch &batch)
+{
+    auto dev = deviceRef.getLogicalDevice();
+    for (DedicatedStaging &staging : batch.dedicated)
+    {
+        dev.destroyBuffer(staging.buffer);
+        deviceRef.freeMemory(staging.memory);
+    }
+    batch.dedicated.clear();
+
+    tail = std::max(tail, batch.ringEnd);
+    completedTicket = batch.ticket;
+    spaceFreed.notify_all();
+}
+
+bool VulkanUploader::isComplete(Ticket ticket) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return ticket <= completedTicket;
+}
+
+void VulkanUploader::waitIdle()
+{
+    auto dev = deviceRef.getLogicalDevice();
+    for (const Batch &batch : inFlight)
+        (void)dev.waitForFences(1, &batch.fence, VK_TRUE, UINT64_MAX);
+    while (!inFlight.empty())
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        retireLocked(inFlight.front());
+        freeBatches.push_back(inFlight.front());
+        inFlight.pop_front();
+    }
+}
+
+uint64_t VulkanUploader::getUploadedBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return uploadedBytes;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+class VulkanDevice;
+
+// Asynchronous buffer uploads for content created off the render thread.
+//
+// Any thread stages data with upload(): it reserves space in a persistently mapped
+// staging ring, lets the caller write straight into it and queues a copy. The render
+// thread calls submit() once per frame, which records every queued copy into one batch,
+// submits it behind a fence and retires batches whose fences have signalled (freeing
+// their ring space). Nothing ever waits for the GPU; callers poll isComplete() with the
+// ticket upload() returned and only use the data afterwards. Only submit() touches the
+// queue, so it needs no locking against the frame's own submissions.
+//
+// Batches go to the device's transfer queue, a dedicated DMA queue that overlaps
+// rendering when there is one. Destination buffers must then be shared with the graphics
+// family (VulkanDevice::getSharingFamilies).
+class VulkanUploader
+{
+public:
+    using Ticket = uint64_t;
+
+    VulkanUploader(const VulkanDevice &device, vk::DeviceSize stagingCapacity = 64 * 1024 * 1024);
+    ~VulkanUploader();
+
+    VulkanUploader(const VulkanUploader &) = delete;
+    VulkanUploader &operator=(const VulkanUploader &) = delete;
+
+    // Any thread. `fill` writes `size` bytes that end up at dst + dstOffset once the returned
+    // ticket completes. Blocks while the ring is full; uploads larger than the whole ring
+    // get a staging buffer of their own.
+    Ticket upload(vk::Buffer dst, vk::DeviceSize dstOffset, vk::DeviceSize size,
+                  const std::function<void(void *)> &fill);
+
+    // Render thread, once per frame: submit queued copies, retire finished batches
+    void submit();
+
+    // Any thread
+    bool isComplete(Ticket ticket) const;
+
+    // Render thread: wait for everything submitted so far (shutdown)
+    void waitIdle();
+
+    vk::DeviceSize getStagingCapacity() const { return capacity; }
+    uint64_t getUploadedBytes() const;
+
+private:
+    struct Copy
+    {
+        vk::Buffer staging; // The ring, or a dedicated buffer for oversized uploads
+        vk::DeviceSize stagingOffset;
+        vk::Buffer dst;
+        vk::DeviceSize dstOffset;
+        vk::DeviceSize size;
+    };
+
+    struct DedicatedStaging
+    {
+        vk::Buffer buffer;
+        vk::DeviceMemory memory;
+    };
+
+    struct Batch
+    {
+        Ticket ticket = 0;
+        vk::CommandBuffer cmd;
+        vk::Fence fence;
+        vk::DeviceSize ringEnd = 0; // Ring space up to here is free once the batch retires
+        std::vector<DedicatedStaging> dedicated;
+    };
+
+    bool reserveLocked(vk::DeviceSize size, vk::DeviceSize &offset);
+    void retireLocked(Batch &batch);
+    DedicatedStaging createStaging(vk::DeviceSize size, void **mapped) const;
+
+    const VulkanDevice &deviceRef;
+    const vk::DeviceSize capacity;
+
+    vk::Buffer ringBuffer;
+    vk::DeviceMemory ringMemory;
+    uint8_t *ringMapped = nullptr;
+
+    // Render thread only
+    vk::CommandPool commandPool;
+    std::deque<Batch> inFlight;
+    std::vector<Batch> freeBatches; // Command buffers and fences for reuse
+
+    mutable std::mutex mutex;
+    std::condition_variable spaceFreed;
+    vk::DeviceSize head = 0;  // Next reservation
+    vk::DeviceSize tail = 0;  // Oldest byte still needed
+    std::vector<vk::DeviceSize> writing; // Starts of reservations still being filled
+    std::vector<Copy> pending;
+    std::vector<DedicatedStaging> pendingDedicated;
+    Ticket openTicket = 1;      // Batch that the next upload joins
+    Ticket completedTicket = 0; // Every batch up to here has finished
+    uint64_t uploadedBytes = 0;
+};